@@ -21,6 +21,7 @@
 
 #include "Shiver.h"
 #include "HotHud.h"
+#include "ParallelFor.h"
 
 /*****************************************************************************/
 
@@ -28,26 +29,630 @@ DEFINE_LOG_CATEGORY_STATIC(LogHUD, Log, All);
 
 #define LOCTEXT_NAMESPACE "HUD"
 
+// Number of frames an unreferenced glyph run is kept around for after it was last drawn.
+static const uint64 kGlyphRunMaxIdleFrames = 600;
+// Number of frames between glyph run cache trims.
+static const uint64 kGlyphRunTrimInterval = 60;
+// Number of frames between memory budget checks.
+static const uint64 kMemoryBudgetCheckInterval = 60;
+// Most budget checks skipped after trimming failed to get under budget; the skip doubles on every failure.
+static const int32 kMemoryBudgetMaxBackoff = 32;
+// Grid views with at least this many tiles shown are sorted on the worker threads.
+static const int32 kParallelSortMinItems = 4096;
+// Snapshot header. Bump the version whenever the layout written by SaveSnapshot() changes.
+static const uint32 kSnapshotMagic = 0x4E534848;  // 'HHSN'
+static const int32 kSnapshotVersion = 2;
+// Number of frames between control tree checks during a soak.
+static const uint64 kSoakValidateInterval = 60;
+// Soak runs stop creating controls (and delete more) once this many are alive.
+static const int32 kSoakMaxControls = 20000;
+
+// Appends a textured, axis aligned quad (as two triangles) to a triangle list.
+// UVs holds the min UV in XY and the max UV in ZW.
+static void AppendQuad(
+	TArray<FCanvasUVTri>& triangles, const FVector2D& position, const FVector2D& size,
+	const FVector4& uvs, const FLinearColor& color) {
+	FVector2D bottomRight = position + size;
+
+	FCanvasUVTri& first = triangles[triangles.AddUninitialized()];
+	first.V0_Pos = position;
+	first.V0_UV = FVector2D(uvs.X, uvs.Y);
+	first.V0_Color = color;
+	first.V1_Pos = FVector2D(bottomRight.X, position.Y);
+	first.V1_UV = FVector2D(uvs.Z, uvs.Y);
+	first.V1_Color = color;
+	first.V2_Pos = bottomRight;
+	first.V2_UV = FVector2D(uvs.Z, uvs.W);
+	first.V2_Color = color;
+
+	FCanvasUVTri& second = triangles[triangles.AddUninitialized()];
+	second.V0_Pos = position;
+	second.V0_UV = FVector2D(uvs.X, uvs.Y);
+	second.V0_Color = color;
+	second.V1_Pos = bottomRight;
+	second.V1_UV = FVector2D(uvs.Z, uvs.W);
+	second.V1_Color = color;
+	second.V2_Pos = FVector2D(position.X, bottomRight.Y);
+	second.V2_UV = FVector2D(uvs.X, uvs.W);
+	second.V2_Color = color;
+}
+
+// Draws the images of Tiles. Atlased images are batched so that each atlas page is submitted once
+// for all of them; the rest are drawn as they come.
+static void DrawTileImages(AHotHud* hud, UCanvas* canvas, const TArray<HotHudTile*>& tiles) {
+	HotHudTextureAtlas* atlas = hud->TileAtlas();
+	if (atlas == nullptr) {
+		for (HotHudTile* tile : tiles) {
+			hud->SetDrawingControl(tile);
+			tile->DrawImage(hud, canvas, nullptr);
+		}
+		return;
+	}
+
+	for (int32 page = 0; page < atlas->NumPages(); page++) {
+		atlas->PageBatch(page).Reset();
+	}
+	for (HotHudTile* tile : tiles) {
+		hud->SetDrawingControl(tile);
+		tile->DrawImage(hud, canvas, atlas);
+	}
+	atlas->FlushPendingUploads();
+	for (int32 page = 0; page < atlas->NumPages(); page++) {
+		TArray<FCanvasUVTri>& batch = atlas->PageBatch(page);
+		if (batch.Num() > 0) {
+			FCanvasTriangleItem batchItem(batch, atlas->PageResource(page));
+			batchItem.BlendMode = SE_BLEND_Translucent;
+			canvas->DrawItem(batchItem);
+		}
+	}
+}
+
+// Runs one draw pass (Method) over a bucket of controls of the same type. Method is a template
+// argument so every call in the loop is bound statically rather than through the vtable.
+template <typename ControlType, void (ControlType::*Method)(AHotHud*, UCanvas*)>
+static void DrawPass(AHotHud* hud, UCanvas* canvas, const TArray<ControlType*>& bucket) {
+	for (ControlType* control : bucket) {
+		hud->SetDrawingControl(control);
+		(control->*Method)(hud, canvas);
+	}
+}
+
+
+/*****************************************************************************/
+
+uint32 GetStyleHash(const FManagedWindowBuildOptions& options) {
+	uint32 hash = GetTypeHash(options.BackgroundColor);
+	hash = HashCombine(hash, GetTypeHash(options.TitleBarHeight));
+	hash = HashCombine(hash, GetTypeHash(options.TitleBarColor));
+	hash = HashCombine(hash, PointerHash(options.TitleFont));
+	hash = HashCombine(hash, GetTypeHash(options.TitleFontScale));
+	hash = HashCombine(hash, GetTypeHash(options.TitleTextColor));
+	hash = HashCombine(hash, (options.AlwaysShowHBar ? 1 : 0) | (options.AlwaysShowVBar ? 2 : 0));
+	return hash;
+}
+
+bool StylesEqual(const FManagedWindowBuildOptions& a, const FManagedWindowBuildOptions& b) {
+	return a.BackgroundColor == b.BackgroundColor && a.TitleBarHeight == b.TitleBarHeight &&
+		a.TitleBarColor == b.TitleBarColor && a.TitleFont == b.TitleFont &&
+		a.TitleFontScale == b.TitleFontScale && a.TitleTextColor == b.TitleTextColor &&
+		a.AlwaysShowHBar == b.AlwaysShowHBar && a.AlwaysShowVBar == b.AlwaysShowVBar;
+}
+
+uint32 GetStyleHash(const FTextBoxBuildOptions& options) {
+	uint32 hash = GetTypeHash(options.BackgroundColor);
+	hash = HashCombine(hash, PointerHash(options.Font));
+	hash = HashCombine(hash, GetTypeHash(options.FontScale));
+	hash = HashCombine(hash, GetTypeHash(options.DefaultTextColor));
+	return hash;
+}
+
+bool StylesEqual(const FTextBoxBuildOptions& a, const FTextBoxBuildOptions& b) {
+	return a.BackgroundColor == b.BackgroundColor && a.Font == b.Font &&
+		a.FontScale == b.FontScale && a.DefaultTextColor == b.DefaultTextColor;
+}
+
+uint32 GetStyleHash(const FTileGridBuildOptions& options) {
+	uint32 hash = GetTypeHash(options.TileWidth);
+	hash = HashCombine(hash, GetTypeHash(options.TileHeight));
+	hash = HashCombine(hash, GetTypeHash(options.MaxCols));
+	hash = HashCombine(hash, GetTypeHash(options.MaxRows));
+	hash = HashCombine(hash, GetTypeHash(options.BackgroundColor));
+	hash = HashCombine(hash, ((uint32)options.DropAction << 1) | (options.AcceptForeignTiles ? 1 : 0));
+	return hash;
+}
+
+// Returns the shared part of Options; per-control fields are cleared so they don't end up in a style.
+static FManagedWindowBuildOptions StyleOptions(const FManagedWindowBuildOptions& options) {
+	FManagedWindowBuildOptions styleOptions = options;
+	styleOptions.Title.Empty();
+	styleOptions.IsMovable = false;
+	return styleOptions;
+}
+
+static FTextBoxBuildOptions StyleOptions(const FTextBoxBuildOptions& options) {
+	FTextBoxBuildOptions styleOptions = options;
+	styleOptions.Text.Empty();
+	styleOptions.Editable = false;
+	return styleOptions;
+}
+
+bool StylesEqual(const FTileGridBuildOptions& a, const FTileGridBuildOptions& b) {
+	return a.TileWidth == b.TileWidth && a.TileHeight == b.TileHeight &&
+		a.MaxCols == b.MaxCols && a.MaxRows == b.MaxRows &&
+		a.BackgroundColor == b.BackgroundColor && a.DropAction == b.DropAction &&
+		a.AcceptForeignTiles == b.AcceptForeignTiles;
+}
+
+uint32 GetStyleHash(const FGaugeBuildOptions& options) {
+	uint32 hash = GetTypeHash(options.BackgroundColor);
+	hash = HashCombine(hash, GetTypeHash(options.FillColor));
+	hash = HashCombine(hash, GetTypeHash(options.MinValue));
+	hash = HashCombine(hash, GetTypeHash(options.MaxValue));
+	hash = HashCombine(hash, options.Vertical ? 1 : 0);
+	return hash;
+}
+
+bool StylesEqual(const FGaugeBuildOptions& a, const FGaugeBuildOptions& b) {
+	return a.BackgroundColor == b.BackgroundColor && a.FillColor == b.FillColor &&
+		a.MinValue == b.MinValue && a.MaxValue == b.MaxValue && a.Vertical == b.Vertical;
+}
+
+/*****************************************************************************/
+
+// Snapshots refer to assets by path, and load (or find) them again when read. Returns false if a path
+// was read but the object couldn't be loaded.
+template <typename ObjectType>
+static bool SerializeObjectPath(FArchive& ar, ObjectType*& object) {
+	FString path;
+	if (ar.IsSaving() && object != nullptr) {
+		path = object->GetPathName();
+	}
+	ar << path;
+	if (ar.IsLoading()) {
+		object = path.IsEmpty() ? nullptr : LoadObject<ObjectType>(nullptr, *path);
+		return path.IsEmpty() || object != nullptr;
+	}
+	return true;
+}
+
+static void SerializeGeometry(FArchive& ar, FControlGeometry& geometry) {
+	ar << geometry.Location << geometry.Width << geometry.Height;
+}
+
+// Only the style fields are written (see StyleOptions()).
+static void SerializeOptions(FArchive& ar, FManagedWindowBuildOptions& options) {
+	ar << options.BackgroundColor << options.TitleBarHeight << options.TitleBarColor;
+	SerializeObjectPath(ar, options.TitleFont);
+	ar << options.TitleFontScale << options.TitleTextColor << options.AlwaysShowHBar << options.AlwaysShowVBar;
+}
+
+static void SerializeOptions(FArchive& ar, FTextBoxBuildOptions& options) {
+	ar << options.BackgroundColor;
+	SerializeObjectPath(ar, options.Font);
+	ar << options.FontScale << options.DefaultTextColor;
+}
+
+static void SerializeOptions(FArchive& ar, FTileGridBuildOptions& options) {
+	ar << options.TileWidth << options.TileHeight << options.MaxCols << options.MaxRows << options.BackgroundColor;
+	ar << options.DropAction << options.AcceptForeignTiles;
+}
+
+static void SerializeOptions(FArchive& ar, FGaugeBuildOptions& options) {
+	ar << options.BackgroundColor << options.FillColor << options.MinValue << options.MaxValue << options.Vertical;
+}
+
+// Writes the named styles of Registry.
+template <typename OptionsType>
+static void SaveNamedStyles(FArchive& ar, const THotHudStyleRegistry<OptionsType>& registry) {
+	int32 numStyles = registry.NumNamed();
+	ar << numStyles;
+	registry.ForEachNamed([&ar](const THotHudStyle<OptionsType>& style) {
+		FName name = style.Name;
+		OptionsType options = style.Options;
+		ar << name;
+		SerializeOptions(ar, options);
+	});
+}
+
+template <typename OptionsType>
+static void LoadNamedStyles(FArchive& ar, THotHudStyleRegistry<OptionsType>& registry) {
+	int32 numStyles = 0;
+	ar << numStyles;
+	for (int32 i = 0; i < numStyles && !ar.IsError(); i++) {
+		FName name;
+		OptionsType options;
+		ar << name;
+		SerializeOptions(ar, options);
+		registry.Define(name, options);
+	}
+}
+
+// A control's style is written by name if it has one (so it stays linked to the named style) along with
+// its options, which are interned again if the name is unknown.
+template <typename OptionsType>
+static void SaveStyle(FArchive& ar, const THotHudStyle<OptionsType>& style) {
+	FName name = style.Name;
+	OptionsType options = style.Options;
+	ar << name;
+	SerializeOptions(ar, options);
+}
+
+template <typename OptionsType>
+static TSharedRef<THotHudStyle<OptionsType>> LoadStyle(FArchive& ar, THotHudStyleRegistry<OptionsType>& registry) {
+	FName name;
+	OptionsType options;
+	ar << name;
+	SerializeOptions(ar, options);
+	TSharedPtr<THotHudStyle<OptionsType>> named = name.IsNone() ? TSharedPtr<THotHudStyle<OptionsType>>() : registry.Find(name);
+	return named.IsValid() ? named.ToSharedRef() : registry.Intern(options);
+}
+
+/*****************************************************************************/
+
+int32 HotHudTweenSet::FindOrAddSlot(HotHudControl* control, HotHudTweenProperty property, const FVector2D& from) {
+	int32* existing = indices_[property].Find(control);
+	if (existing != nullptr) {
+		return *existing;
+	}
+	int32 index = controls_.Add(control);
+	indices_[property].Add(control, index);
+	properties_.Add(property);
+	startTimes_.AddUninitialized();
+	invDurations_.AddUninitialized();
+	easeA_.AddUninitialized();
+	easeB_.AddUninitialized();
+	easeC_.AddUninitialized();
+	from_.AddUninitialized();
+	to_.AddUninitialized();
+	progress_.Add(0);
+	values_.Add(from);
+	return index;
+}
+
+void HotHudTweenSet::Add(
+	HotHudControl* control, HotHudTweenProperty property, const FVector2D& from, const FVector2D& to,
+	float startTime, float duration, EHotHudEasing::Type easing) {
+	// A parked tween of the property is replaced like a running one.
+	int32* parked = parkedIndices_[property].Find(control);
+	if (parked != nullptr) {
+		RemoveParkedAt(*parked);
+	}
+	int32 index = FindOrAddSlot(control, property, from);
+
+	if (duration > 0) {
+		startTimes_[index] = startTime;
+		invDurations_[index] = 1.0f / duration;
+	}
+	else {
+		// Finish on the next step.
+		startTimes_[index] = startTime - 1.0f;
+		invDurations_[index] = 1.0f;
+	}
+
+	float a = 1, b = 0, c = 0;
+	switch (easing) {
+	case EHotHudEasing::EaseIn:
+		a = 0; b = 1; c = 0;
+		break;
+	case EHotHudEasing::EaseOut:
+		a = 2; b = -1; c = 0;
+		break;
+	case EHotHudEasing::EaseInOut:
+		a = 0; b = 3; c = -2;
+		break;
+	case EHotHudEasing::EaseInCubic:
+		a = 0; b = 0; c = 1;
+		break;
+	case EHotHudEasing::EaseOutCubic:
+		a = 3; b = -3; c = 1;
+		break;
+	default:
+		break;
+	}
+	easeA_[index] = a;
+	easeB_[index] = b;
+	easeC_[index] = c;
+	from_[index] = from;
+	to_[index] = to;
+}
+
+void HotHudTweenSet::Remove(HotHudControl* control) {
+	for (int32 property = 0; property < HotHudTween_NumProperties; property++) {
+		int32* index = indices_[property].Find(control);
+		if (index != nullptr) {
+			RemoveAt(*index);
+		}
+		int32* parked = parkedIndices_[property].Find(control);
+		if (parked != nullptr) {
+			RemoveParkedAt(*parked);
+		}
+	}
+}
+
+void HotHudTweenSet::Park(HotHudControl* control, float now) {
+	for (int32 property = 0; property < HotHudTween_NumProperties; property++) {
+		int32* index = indices_[property].Find(control);
+		if (index != nullptr) {
+			ParkAt(*index, now);
+		}
+	}
+}
+
+void HotHudTweenSet::UpdateParked(float now) {
+	// Parked tweens are resumed first so that they aren't checked twice.
+	int32 numRunning = controls_.Num();
+	for (int32 i = parked_.Num() - 1; i >= 0; i--) {
+		const ParkedTween& tween = parked_[i];
+		if (!tween.Control->IsShownInTree()) {
+			continue;
+		}
+		int32 index = FindOrAddSlot(tween.Control, (HotHudTweenProperty)tween.Property, tween.Value);
+		startTimes_[index] = now - tween.Elapsed;
+		invDurations_[index] = tween.InvDuration;
+		easeA_[index] = tween.EaseA;
+		easeB_[index] = tween.EaseB;
+		easeC_[index] = tween.EaseC;
+		from_[index] = tween.From;
+		to_[index] = tween.To;
+		RemoveParkedAt(i);
+	}
+	for (int32 i = numRunning - 1; i >= 0; i--) {
+		if (!controls_[i]->IsShownInTree()) {
+			ParkAt(i, now);
+		}
+	}
+}
+
+void HotHudTweenSet::ParkAt(int32 index, float now) {
+	int32 parkedIndex = parked_.AddUninitialized();
+	parkedIndices_[properties_[index]].Add(controls_[index], parkedIndex);
+	ParkedTween& tween = parked_[parkedIndex];
+	tween.Control = controls_[index];
+	tween.Property = properties_[index];
+	tween.Elapsed = now - startTimes_[index];
+	tween.InvDuration = invDurations_[index];
+	tween.EaseA = easeA_[index];
+	tween.EaseB = easeB_[index];
+	tween.EaseC = easeC_[index];
+	tween.From = from_[index];
+	tween.To = to_[index];
+	tween.Value = values_[index];
+	RemoveAt(index);
+}
+
+void HotHudTweenSet::RemoveFinished() {
+	for (int32 i = controls_.Num() - 1; i >= 0; i--) {
+		if (progress_[i] >= 1.0f) {
+			RemoveAt(i);
+		}
+	}
+}
+
+void HotHudTweenSet::RemoveAt(int32 index) {
+	indices_[properties_[index]].Remove(controls_[index]);
+	int32 last = controls_.Num() - 1;
+	if (index != last) {
+		indices_[properties_[last]][controls_[last]] = index;
+	}
+	controls_.RemoveAtSwap(index);
+	properties_.RemoveAtSwap(index);
+	startTimes_.RemoveAtSwap(index);
+	invDurations_.RemoveAtSwap(index);
+	easeA_.RemoveAtSwap(index);
+	easeB_.RemoveAtSwap(index);
+	easeC_.RemoveAtSwap(index);
+	from_.RemoveAtSwap(index);
+	to_.RemoveAtSwap(index);
+	progress_.RemoveAtSwap(index);
+	values_.RemoveAtSwap(index);
+}
+
+void HotHudTweenSet::RemoveParkedAt(int32 index) {
+	parkedIndices_[parked_[index].Property].Remove(parked_[index].Control);
+	int32 last = parked_.Num() - 1;
+	if (index != last) {
+		parkedIndices_[parked_[last].Property][parked_[last].Control] = index;
+	}
+	parked_.RemoveAtSwap(index);
+}
+
+int32 HotHudTweenSet::GetAllocatedSize() const {
+	int32 bytes = controls_.GetAllocatedSize() + properties_.GetAllocatedSize() + startTimes_.GetAllocatedSize() +
+		invDurations_.GetAllocatedSize() + easeA_.GetAllocatedSize() + easeB_.GetAllocatedSize() +
+		easeC_.GetAllocatedSize() + from_.GetAllocatedSize() + to_.GetAllocatedSize() +
+		progress_.GetAllocatedSize() + values_.GetAllocatedSize() + parked_.GetAllocatedSize();
+	for (int32 property = 0; property < HotHudTween_NumProperties; property++) {
+		bytes += indices_[property].GetAllocatedSize() + parkedIndices_[property].GetAllocatedSize();
+	}
+	return bytes;
+}
+
+void HotHudTweenSet::Step(float now) {
+	const int32 num = controls_.Num();
+	const float* startTimes = startTimes_.GetData();
+	const float* invDurations = invDurations_.GetData();
+	const float* easeA = easeA_.GetData();
+	const float* easeB = easeB_.GetData();
+	const float* easeC = easeC_.GetData();
+	const FVector2D* from = from_.GetData();
+	const FVector2D* to = to_.GetData();
+	float* progress = progress_.GetData();
+	FVector2D* values = values_.GetData();
+
+	// Normalized time.
+	for (int32 i = 0; i < num; i++) {
+		progress[i] = FMath::Clamp((now - startTimes[i]) * invDurations[i], 0.0f, 1.0f);
+	}
+	// Ease & interpolate.
+	for (int32 i = 0; i < num; i++) {
+		const float t = progress[i];
+		const float eased = t * (easeA[i] + t * (easeB[i] + t * easeC[i]));
+		values[i].X = from[i].X + (to[i].X - from[i].X) * eased;
+		values[i].Y = from[i].Y + (to[i].Y - from[i].Y) * eased;
+	}
+}
+
+/*****************************************************************************/
+
+// Sorts Items with Less. Large arrays are cut into one chunk per core which are sorted on the worker
+// threads, then merged back together pairwise, each round of merges also running in parallel. Less
+// must be a strict total order and safe to call from any thread.
+template <typename LessType>
+static void ParallelSort(TArray<int32>& items, const LessType& less) {
+	int32 num = items.Num();
+	if (num < kParallelSortMinItems) {
+		items.Sort(less);
+		return;
+	}
+
+	int32 numChunks = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 2, 32);
+	int32 chunkSize = (num + numChunks - 1) / numChunks;
+	int32* data = items.GetData();
+	ParallelFor(numChunks, [data, num, chunkSize, &less](int32 chunk) {
+		int32 start = chunk * chunkSize;
+		if (start < num) {
+			Sort(data + start, FMath::Min(chunkSize, num - start), less);
+		}
+	});
+
+	TArray<int32> scratch;
+	scratch.AddUninitialized(num);
+	int32* from = data;
+	int32* to = scratch.GetData();
+	for (int32 width = chunkSize; width < num; width *= 2) {
+		int32 numMerges = (num + 2 * width - 1) / (2 * width);
+		ParallelFor(numMerges, [from, to, num, width, &less](int32 merge) {
+			int32 start = merge * 2 * width;
+			int32 mid = FMath::Min(start + width, num);
+			int32 end = FMath::Min(start + 2 * width, num);
+			int32 left = start;
+			int32 right = mid;
+			for (int32 out = start; out < end; out++) {
+				to[out] = (right >= end || (left < mid && !less(from[right], from[left]))) ? from[left++] : from[right++];
+			}
+		});
+		Swap(from, to);
+	}
+	if (from != data) {
+		FMemory::Memcpy(data, from, num * sizeof(int32));
+	}
+}
+
+// Sorts Slots by Compare (which returns <0, 0 or >0 like strcmp), breaking ties by slot.
+template <typename CompareType>
+static void SortSlots(TArray<int32>& slots, bool descending, const CompareType& compare) {
+	ParallelSort(slots, [&compare, descending](int32 first, int32 second) {
+		int32 order = compare(first, second);
+		if (order != 0) {
+			return descending ? order > 0 : order < 0;
+		}
+		return first < second;
+	});
+}
+
+/*****************************************************************************/
+
+void HotHudSharedResources::Trim(uint64 maxIdleFrames) {
+	if (LastTrimFrame == GFrameCounter) {
+		return;
+	}
+	LastTrimFrame = GFrameCounter;
+	GlyphRunCache.Trim(maxIdleFrames);
+	WindowStyles.Trim();
+	TextBoxStyles.Trim();
+	TileGridStyles.Trim();
+	GaugeStyles.Trim();
+}
+
+/*****************************************************************************/
 
 AHotHud::AHotHud(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer),
 	SupressHud(true),
+	PreResolveDropTargets(false),
+	UseTileAtlas(true),
+	TileAtlasPageSize(1024),
+	TileAtlasMaxPages(4),
+	ShareResources(false),
+	MemoryBudgetKB(0),
+	MinScrollbackRows(200),
+	TileReleaseIdleFrames(300),
+	WorkBudgetMs(2.0f),
 	localPlayerController_(nullptr),
-	lastLeftMouseButtonDown_(false),
+	inputBound_(false),
+	mouseLocation_(FVector2D::ZeroVector),
+	hoverLocation_(FVector2D::ZeroVector),
+	hoverDirty_(true),
+	focusedControl_(nullptr),
 	controlBeingHovered_(nullptr),
 	controlBeingDragged_(nullptr),
 	controlBeingMoved_(nullptr),
-	dragDropTargetValid_(false) {
+	scrollbarDragWindow_(nullptr),
+	scrollbarDragVertical_(false),
+	scrollbarGrabOffset_(0.0f),
+	dragDropTargetValid_(false),
+	viewportOffset_(FVector2D::ZeroVector),
+	viewportScale_(1.0f),
+	dropTargetCacheComplete_(false),
+	resources_(MakeShareable(new HotHudSharedResources())),
+	tweenShownGeneration_(INDEX_NONE),
+	glyphRunReplays_(0),
+	memoryBudgetExceeded_(false),
+	memoryBudgetBackoff_(0),
+	memoryBudgetChecksToSkip_(0),
+	parkedWorkGeneration_(INDEX_NONE),
+	chromeClip_(-MAX_flt, -MAX_flt, MAX_flt, MAX_flt),
+	soak_(nullptr),
+	capture_(nullptr),
+	drawingControl_(nullptr) {
+	for (int32 i = 0; i < HotHudWorkPriority_NumPriorities; i++) {
+		workQueueHeads_[i] = 0;
+	}
+}
+
+AHotHud::~AHotHud() {
+	StopDrawCapture();
+	delete soak_;
+	DeleteAllControls();
 }
 
 void AHotHud::PostInitializeComponents() {
 	Super::PostInitializeComponents();
 
 	localPlayerController_ = GetOwningPlayerController();
+	BindInput();
+
+	if (ShareResources && GetWorld() != nullptr) {
+		for (TActorIterator<AHotHud> it(GetWorld()); it; ++it) {
+			if (*it != this && it->ShareResources) {
+				resources_ = it->resources_;
+				break;
+			}
+		}
+	}
+	if (UseTileAtlas && resources_->TileAtlas == nullptr) {
+		resources_->TileAtlas = new HotHudTextureAtlas(TileAtlasPageSize, TileAtlasMaxPages);
+	}
+}
+
+void AHotHud::GetTileAtlasStats(int32& numPages, int32& numEntries, int32& numReferenced, int32& evictions, int32& repacks, float& occupancy) {
+	HotHudAtlasStats stats;
+	if (resources_->TileAtlas != nullptr) {
+		stats = resources_->TileAtlas->Stats();
+	}
+	numPages = stats.NumPages;
+	numEntries = stats.NumEntries;
+	numReferenced = stats.NumReferencedEntries;
+	evictions = stats.Evictions;
+	repacks = stats.Repacks;
+	occupancy = stats.Occupancy();
 }
 
 HotHudControl* AHotHud::FindTopMostControlAt(const FVector2D& location) {
-	for (HotHudWindow* window : rootWindows_) {
+	for (HotHudWindow* window : TreeRootWindows()) {
+		if (!window->IsShown()) {
+			continue;
+		}
 		HotHudControl* control = window->FindTopMostControlAt(location);
 		if (control != nullptr) {
 			return control;
@@ -72,7 +677,7 @@ HotHudControl* AHotHud::HandleControlLookup(
 		bpReturnCode = true;
 		return NULL;
 	}
-	if (control->Type() != type) {
+	if (type != HotHudControl_Any && control->Type() != type) {
 		UE_LOG(LogHUD, Error, TEXT("HandleControlLookup(%s): Control type mismatch."), *name.ToString());
 		bpReturnCode = true;
 		return NULL;
@@ -91,24 +696,137 @@ void AHotHud::CreateManagedWindow(FName name, FName parentName, const FControlGe
 	}
 
 	// Create and register the new Window.
-	UE_LOG(LogHUD, Warning, TEXT("Creating window '%s'"), *name.ToString());
+	HOTHUD_TRACE_EVENT(HotHudTrace_Lifecycle, HotHudTraceEvent_ControlCreated, name);
 	HotHudControl* parent = FindControlByName(parentName);
-	HotHudWindow* newWindow = new HotHudWindow(name, parent, geometry, buildOptions);
+	HotHudWindow* newWindow = new HotHudWindow(
+		name, parent, geometry, resources_->WindowStyles.Intern(StyleOptions(buildOptions)), buildOptions.Title, buildOptions.IsMovable);
 	if (parent != nullptr) {
 		parent->AddChildControl(newWindow);
 	}
 	else {
 		rootWindows_.Add(newWindow);
 	}
-	controlMap_.Add(name, newWindow);
+	RegisterControl(newWindow);
 	error = false;
 }
 
 void AHotHud::DeleteControl(const FName& name, bool& error) {
-	error = true;
+	HotHudControl* control = FindControlByName(name);
+	if (control == nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("DeleteControl(%s): Control not found."), *name.ToString());
+		error = true;
+		return;
+	}
+	HotHudControl* parent = control->Parent();
+	if (parent != nullptr && parent->Type() == HotHudControl_TileGrid && static_cast<HotHudTileGrid*>(parent)->DataSource() != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("DeleteControl(%s): Tile belongs to a grid driven by a data source."), *name.ToString());
+		error = true;
+		return;
+	}
+
+	if (parent != nullptr) {
+		parent->RemoveChildControl(control);
+	}
+	else {
+		rootWindows_.Remove(static_cast<HotHudWindow*>(control));
+	}
+	DestroyControl(control);
+	error = false;
 }
 
 void AHotHud::DeleteAllControls() {
+	for (HotHudWindow* window : rootWindows_) {
+		DestroyControl(window);
+	}
+	rootWindows_.Empty();
+}
+
+void AHotHud::SetControlVisible(const FName& name, bool visible, bool& error) {
+	HotHudControl* control = FindControlByName(name);
+	if (control == nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("SetControlVisible(%s): Control not found."), *name.ToString());
+		error = true;
+		return;
+	}
+	if (control->IsVisible() != visible) {
+		control->SetVisible(visible);
+		OnControlShownChanged(control);
+	}
+	error = false;
+}
+
+void AHotHud::SetControlsVisible(const TArray<FName>& names, bool visible, bool& error) {
+	error = false;
+	for (const FName& name : names) {
+		bool controlError;
+		SetControlVisible(name, visible, controlError);
+		error |= controlError;
+	}
+}
+
+void AHotHud::SetControlCollapsed(const FName& name, bool collapsed, bool& error) {
+	HotHudControl* control = FindControlByName(name);
+	if (control == nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("SetControlCollapsed(%s): Control not found."), *name.ToString());
+		error = true;
+		return;
+	}
+	if (control->IsCollapsed() != collapsed) {
+		control->SetCollapsed(collapsed);
+		OnControlShownChanged(control);
+	}
+	error = false;
+}
+
+void AHotHud::GetControlVisibility(const FName& name, bool& visible, bool& collapsed, bool& error) {
+	HotHudControl* control = FindControlByName(name);
+	if (control == nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("GetControlVisibility(%s): Control not found."), *name.ToString());
+		error = true;
+		return;
+	}
+	visible = control->IsVisible();
+	collapsed = control->IsCollapsed();
+	error = false;
+}
+
+void AHotHud::OnControlShownChanged(HotHudControl* control) {
+	if (!control->IsShown()) {
+		ForgetInteractionWithin(control);
+		for (const TWeakObjectPtr<AHotHud>& follower : treeFollowers_) {
+			if (follower.IsValid()) {
+				follower->ForgetInteractionWithin(control);
+			}
+		}
+	}
+	// Only the hover is re-evaluated (lazily, once per frame however many controls changed).
+	InvalidateHover();
+}
+
+void AHotHud::ForgetInteractionWithin(HotHudControl* hidden) {
+	if (focusedControl_ != nullptr && focusedControl_->IsWithin(hidden)) {
+		SetFocusedControl(nullptr);
+	}
+	if (controlBeingMoved_ != nullptr && controlBeingMoved_->IsWithin(hidden)) {
+		controlBeingMoved_->SetIsMoving(false);
+		ForgetInteraction(controlBeingMoved_);
+	}
+	if (controlBeingDragged_ != nullptr && controlBeingDragged_->IsWithin(hidden)) {
+		controlBeingDragged_->SetIsDragging(false);
+		ForgetInteraction(controlBeingDragged_);
+	}
+	if (scrollbarDragWindow_ != nullptr && scrollbarDragWindow_->IsWithin(hidden)) {
+		scrollbarDragWindow_ = nullptr;
+	}
+}
+
+void AHotHud::DestroyControl(HotHudControl* control) {
+	// Children first, so that each is forgotten while its ancestors are still intact.
+	for (HotHudControl* child : control->Children()) {
+		DestroyControl(child);
+	}
+	ForgetControl(control);
+	delete control;
 }
 
 void AHotHud::CreateTextBox(FName name, const FName& parentName, const FControlGeometry& geometry, const FTextBoxBuildOptions& buildOptions, FName& nameThru, bool& error) {
@@ -127,9 +845,10 @@ void AHotHud::CreateTextBox(FName name, const FName& parentName, const FControlG
 	}
 
 	// Create and register the new TextBox.
-	HotHudTextBox* newTextBox = new HotHudTextBox(name, parent, geometry, buildOptions);
+	HotHudTextBox* newTextBox = new HotHudTextBox(
+		name, parent, geometry, resources_->TextBoxStyles.Intern(StyleOptions(buildOptions)), buildOptions.Text, buildOptions.Editable);
 	parent->AddChildControl(newTextBox);
-	controlMap_.Add(name, newTextBox);
+	RegisterControl(newTextBox);
 	error = false;
 }
 
@@ -140,6 +859,11 @@ void AHotHud::AddTilesToTileGrid(
 	if (parent == nullptr) {
 		return;
 	}
+	if (parent->DataSource() != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("AddTilesToTileGrid(%s): Grid is bound to a data source."), *tileGridName.ToString());
+		error = true;
+		return;
+	}
 
 	// Validate names haven't been used.
 	for (const FName& name : tileNames) {
@@ -151,521 +875,4182 @@ void AHotHud::AddTilesToTileGrid(
 	}
 
 	parent->AddTiles(&controlMap_, tileNames);
+	InvalidateHover();
+	// Fetch tile data in the background so it's likely ready by the time the tiles are drawn.
+	for (const FName& name : tileNames) {
+		DeferWork(controlMap_[name], HotHudWork_FetchTileData, HotHudWorkPriority_Prefetch);
+	}
 
 	error = false;
 }
 
-void AHotHud::CreateTileGrid(
-	const FName name, const FName& parentName, const FControlGeometry& geometry, const FTileGridBuildOptions& buildOptions, FName& nameThru, bool& error) {
-	nameThru = name;
-
-	// Validate the name hasn't already been used.
-	if (controlMap_.Contains(name)) {
-		UE_LOG(LogHUD, Error, TEXT("Handle '%s' already in use"), *name.ToString());
-		error = true;
+void AHotHud::MoveTileInTileGrid(const FName& tileGridName, int32 fromIndex, int32 toIndex, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
 		return;
 	}
-
-	// Lookup & validate the parent.
-	HotHudControl* parent = HandleControlLookup(parentName, HotHudControl_Window, error);
-	if (parent == nullptr) {
+	if (grid->DataSource() != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("MoveTileInTileGrid(%s): Grid is bound to a data source."), *tileGridName.ToString());
+		error = true;
 		return;
 	}
-
-	HotHudTileGrid* newTileGrid = new HotHudTileGrid(name, parent, geometry, buildOptions);
-	parent->AddChildControl(newTileGrid);
-	controlMap_.Add(name, newTileGrid);
-	error = false;
+	if (!grid->MoveTile(fromIndex, toIndex)) {
+		UE_LOG(LogHUD, Error, TEXT("MoveTileInTileGrid(%s): Invalid slots %d -> %d."), *tileGridName.ToString(), fromIndex, toIndex);
+		error = true;
+	}
 }
 
-void AHotHud::PrintLineToTextBox(const FName& textboxHandle, const FString& text, bool& error) {
-	HotHudControl* control = HandleControlLookup(textboxHandle, HotHudControl_TextBox, error);
-	if (control == nullptr) {
+void AHotHud::SwapTilesInTileGrid(const FName& tileGridName, int32 firstIndex, int32 secondIndex, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
 		return;
 	}
-	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(control);
-	textbox->PrintLine(text);
-	error = false;
-}
-
-void AHotHud::ClearTextBox(const FName& textboxHandle, bool& error) {
-	HotHudControl* control = HandleControlLookup(textboxHandle, HotHudControl_TextBox, error);
-	if (control == nullptr) {
+	if (grid->DataSource() != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("SwapTilesInTileGrid(%s): Grid is bound to a data source."), *tileGridName.ToString());
+		error = true;
 		return;
 	}
-	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(control);
-	textbox->Clear();
-	error = false;
+	if (!grid->SwapTiles(firstIndex, secondIndex)) {
+		UE_LOG(LogHUD, Error, TEXT("SwapTilesInTileGrid(%s): Invalid slots %d <-> %d."), *tileGridName.ToString(), firstIndex, secondIndex);
+		error = true;
+	}
 }
 
-void AHotHud::DrawHUD() {
-	// Call our base DrawHUD first which will allow the blueprint layer to draw first.
-	Super::DrawHUD();
-
-	if (!localPlayerController_) {
-		localPlayerController_ = GetOwningPlayerController();
-		if (!localPlayerController_) {
+void AHotHud::InsertTileIntoTileGrid(const FName& tileGridName, const FName& tileName, int32 index, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
+		return;
+	}
+	if (grid->DataSource() != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("InsertTileIntoTileGrid(%s): Grid is bound to a data source."), *tileGridName.ToString());
+		error = true;
+		return;
+	}
+	HotHudTile* tile = static_cast<HotHudTile*>(HandleControlLookup(tileName, HotHudControl_Tile, error));
+	if (tile == nullptr) {
+		return;
+	}
+	if (static_cast<HotHudTileGrid*>(tile->Parent())->DataSource() != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("InsertTileIntoTileGrid(%s): Tile belongs to a data source."), *tileName.ToString());
+		error = true;
+		return;
+	}
+	if (index < 0) {
+		UE_LOG(LogHUD, Error, TEXT("InsertTileIntoTileGrid(%s): Invalid slot %d."), *tileGridName.ToString(), index);
+		error = true;
+		return;
+	}
+	grid->InsertTile(tile, index);
+}
+
+void AHotHud::SetTileSortKeys(const FName& tileGridName, const TArray<float>& sortKeys, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
+		return;
+	}
+	if (sortKeys.Num() != grid->NumTiles()) {
+		UE_LOG(LogHUD, Error, TEXT("SetTileSortKeys(%s): Got %d keys for %d tiles."), *tileGridName.ToString(), sortKeys.Num(), grid->NumTiles());
+		error = true;
+		return;
+	}
+	for (int32 slot = 0; slot < sortKeys.Num(); slot++) {
+		grid->TileAt(slot)->SetSortKey(sortKeys[slot]);
+	}
+	grid->InvalidateView();
+	InvalidateHover();
+}
+
+void AHotHud::SortTileGrid(const FName& tileGridName, TEnumAsByte<EHotHudTileSortBy::Type> sortBy, bool descending, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid != nullptr) {
+		grid->SetViewSort(sortBy, descending);
+		InvalidateHover();
+	}
+}
+
+void AHotHud::FilterTileGrid(const FName& tileGridName, const TArray<bool>& shownSlots, const FString& labelFilter, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
+		return;
+	}
+	if (grid->DataSource() == nullptr) {
+		if (shownSlots.Num() > 0 && shownSlots.Num() != grid->NumTiles()) {
+			UE_LOG(LogHUD, Error, TEXT("FilterTileGrid(%s): Got %d flags for %d tiles."), *tileGridName.ToString(), shownSlots.Num(), grid->NumTiles());
+			error = true;
+			return;
+		}
+		for (int32 slot = 0; slot < shownSlots.Num(); slot++) {
+			grid->TileAt(slot)->SetFilteredOut(!shownSlots[slot]);
+		}
+	}
+	grid->SetViewFilter(shownSlots.Num() > 0 || grid->DataSource() != nullptr, labelFilter);
+	InvalidateHover();
+}
+
+void AHotHud::ClearTileGridView(const FName& tileGridName, bool& error) {
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid != nullptr) {
+		grid->ClearView();
+		InvalidateHover();
+	}
+}
+
+void AHotHud::GetTileGridView(const FName& tileGridName, TArray<FName>& tileNames, bool& error) {
+	tileNames.Reset();
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
+		return;
+	}
+	grid->UpdateView();
+	tileNames.Reserve(grid->NumShownTiles());
+	for (int32 position = 0; position < grid->NumShownTiles(); position++) {
+		tileNames.Add(grid->ShownTileAt(position)->Name());
+	}
+}
+
+void AHotHud::CreateTileGrid(
+	const FName name, const FName& parentName, const FControlGeometry& geometry, const FTileGridBuildOptions& buildOptions, FName& nameThru, bool& error) {
+	nameThru = name;
+
+	// Validate the name hasn't already been used.
+	if (controlMap_.Contains(name)) {
+		UE_LOG(LogHUD, Error, TEXT("Handle '%s' already in use"), *name.ToString());
+		error = true;
+		return;
+	}
+
+	// Lookup & validate the parent.
+	HotHudControl* parent = HandleControlLookup(parentName, HotHudControl_Window, error);
+	if (parent == nullptr) {
+		return;
+	}
+
+	HotHudTileGrid* newTileGrid = new HotHudTileGrid(name, parent, geometry, resources_->TileGridStyles.Intern(buildOptions));
+	parent->AddChildControl(newTileGrid);
+	RegisterControl(newTileGrid);
+	error = false;
+}
+
+void AHotHud::PrintLineToTextBox(const FName& textboxHandle, const FString& text, bool& error) {
+	HotHudControl* control = HandleControlLookup(textboxHandle, HotHudControl_TextBox, error);
+	if (control == nullptr) {
+		return;
+	}
+	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(control);
+	textbox->PrintLine(text);
+	error = false;
+}
+
+void AHotHud::AppendTextToTextBox(const FName& textBoxName, const FString& text, bool& error) {
+	HotHudTextBox* textBox = static_cast<HotHudTextBox*>(HandleControlLookup(textBoxName, HotHudControl_TextBox, error));
+	if (textBox != nullptr) {
+		textBox->AppendText(text);
+	}
+}
+
+void AHotHud::ClearTextBox(const FName& textboxHandle, bool& error) {
+	HotHudControl* control = HandleControlLookup(textboxHandle, HotHudControl_TextBox, error);
+	if (control == nullptr) {
+		return;
+	}
+	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(control);
+	textbox->Clear();
+	error = false;
+}
+
+void AHotHud::SetTextBoxText(const FName& textboxHandle, const FString& text, bool& error) {
+	HotHudControl* control = HandleControlLookup(textboxHandle, HotHudControl_TextBox, error);
+	if (control == nullptr) {
+		return;
+	}
+	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(control);
+	textbox->SetText(text);
+	error = false;
+}
+
+void AHotHud::GetTextBoxText(const FName& textboxHandle, FString& text, bool& error) {
+	HotHudControl* control = HandleControlLookup(textboxHandle, HotHudControl_TextBox, error);
+	if (control == nullptr) {
+		return;
+	}
+	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(control);
+	text = textbox->GetText();
+	error = false;
+}
+
+HotHudTextBox* AHotHud::HandleEditableTextBoxLookup(const FName& textboxHandle, bool& error) {
+	HotHudTextBox* textbox = static_cast<HotHudTextBox*>(HandleControlLookup(textboxHandle, HotHudControl_TextBox, error));
+	if (textbox == nullptr) {
+		return nullptr;
+	}
+	if (!textbox->IsEditable()) {
+		UE_LOG(LogHUD, Error, TEXT("TextBox '%s' is not editable"), *textboxHandle.ToString());
+		error = true;
+		return nullptr;
+	}
+	return textbox;
+}
+
+void AHotHud::InsertTextIntoTextBox(const FName& textboxHandle, const FString& text, bool& error) {
+	HotHudTextBox* textbox = HandleEditableTextBoxLookup(textboxHandle, error);
+	if (textbox == nullptr) {
+		return;
+	}
+	textbox->InsertText(text);
+	error = false;
+}
+
+void AHotHud::DeleteTextBoxCharacter(const FName& textboxHandle, bool forward, bool& error) {
+	HotHudTextBox* textbox = HandleEditableTextBoxLookup(textboxHandle, error);
+	if (textbox == nullptr) {
+		return;
+	}
+	textbox->DeleteCharacter(forward);
+	error = false;
+}
+
+void AHotHud::MoveTextBoxCursor(const FName& textboxHandle, TEnumAsByte<ETextBoxCursorMove::Type> move, bool& error) {
+	HotHudTextBox* textbox = HandleEditableTextBoxLookup(textboxHandle, error);
+	if (textbox == nullptr) {
+		return;
+	}
+	textbox->MoveCursor(move);
+	error = false;
+}
+
+void AHotHud::CreateLabel(FName name, const FName& parentName, const FControlGeometry& geometry, const FTextBoxBuildOptions& buildOptions, FName& nameThru, bool& error) {
+	nameThru = name;
+	// Validate the name hasn't already been used.
+	if (controlMap_.Contains(name)) {
+		UE_LOG(LogHUD, Error, TEXT("Handle '%s' already in use"), *name.ToString());
+		error = true;
+		return;
+	}
+
+	// Lookup & validate the parent.
+	HotHudControl* parent = HandleControlLookup(parentName, HotHudControl_Window, error);
+	if (parent == nullptr) {
+		return;
+	}
+
+	HotHudLabel* newLabel = new HotHudLabel(name, parent, geometry, resources_->TextBoxStyles.Intern(StyleOptions(buildOptions)), buildOptions.Text);
+	parent->AddChildControl(newLabel);
+	RegisterControl(newLabel);
+	error = false;
+}
+
+void AHotHud::SetLabelText(const FName& labelName, const FString& text, bool& error) {
+	HotHudLabel* label = static_cast<HotHudLabel*>(HandleControlLookup(labelName, HotHudControl_Label, error));
+	if (label != nullptr) {
+		label->SetText(text);
+	}
+}
+
+void AHotHud::SetLabelAffixes(const FName& labelName, const FString& prefix, const FString& suffix, bool& error) {
+	HotHudLabel* label = static_cast<HotHudLabel*>(HandleControlLookup(labelName, HotHudControl_Label, error));
+	if (label != nullptr) {
+		label->SetAffixes(prefix, suffix);
+	}
+}
+
+void AHotHud::BindLabelToProperty(const FName& labelName, UObject* object, FName propertyName, TEnumAsByte<EHotHudNumberFormat::Type> format, bool& error) {
+	HotHudLabel* label = static_cast<HotHudLabel*>(HandleControlLookup(labelName, HotHudControl_Label, error));
+	if (label == nullptr) {
+		return;
+	}
+	UNumericProperty* property = (object != nullptr) ? FindField<UNumericProperty>(object->GetClass(), propertyName) : nullptr;
+	if (property == nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("BindLabelToProperty(%s): No numeric property '%s'"), *labelName.ToString(), *propertyName.ToString());
+		error = true;
+		return;
+	}
+
+	// Each format is its own instantiation so the per-frame work stays free of branches on it.
+	HotHudPropertyReader reader(object, property);
+	switch (format) {
+	case EHotHudNumberFormat::Fixed1:
+		label->SetBinding(MakeHotHudLabelBinding<THotHudFixedFormat<1>>(reader));
+		break;
+	case EHotHudNumberFormat::Fixed2:
+		label->SetBinding(MakeHotHudLabelBinding<THotHudFixedFormat<2>>(reader));
+		break;
+	case EHotHudNumberFormat::Fixed3:
+		label->SetBinding(MakeHotHudLabelBinding<THotHudFixedFormat<3>>(reader));
+		break;
+	case EHotHudNumberFormat::Clock:
+		label->SetBinding(MakeHotHudLabelBinding<HotHudClockFormat>(reader));
+		break;
+	default:
+		label->SetBinding(MakeHotHudLabelBinding<HotHudIntegerFormat>(reader));
+		break;
+	}
+	error = false;
+}
+
+void AHotHud::UnbindLabel(const FName& labelName, bool& error) {
+	HotHudLabel* label = static_cast<HotHudLabel*>(HandleControlLookup(labelName, HotHudControl_Label, error));
+	if (label != nullptr) {
+		label->SetBinding(nullptr);
+	}
+}
+
+void AHotHud::CreateGauge(FName name, const FName& parentName, const FControlGeometry& geometry, const FGaugeBuildOptions& buildOptions, FName& nameThru, bool& error) {
+	nameThru = name;
+	// Validate the name hasn't already been used.
+	if (controlMap_.Contains(name)) {
+		UE_LOG(LogHUD, Error, TEXT("Handle '%s' already in use"), *name.ToString());
+		error = true;
+		return;
+	}
+
+	// Lookup & validate the parent.
+	HotHudControl* parent = HandleControlLookup(parentName, HotHudControl_Window, error);
+	if (parent == nullptr) {
+		return;
+	}
+
+	HotHudGauge* newGauge = new HotHudGauge(name, parent, geometry, resources_->GaugeStyles.Intern(buildOptions));
+	parent->AddChildControl(newGauge);
+	RegisterControl(newGauge);
+	error = false;
+}
+
+void AHotHud::SetGaugeValue(const FName& gaugeName, float value, bool& error) {
+	HotHudGauge* gauge = static_cast<HotHudGauge*>(HandleControlLookup(gaugeName, HotHudControl_Gauge, error));
+	if (gauge != nullptr) {
+		gauge->SetValue(value);
+	}
+}
+
+void AHotHud::BindControlToProperty(const FName& controlName, UObject* object, const FString& propertyPath, TEnumAsByte<EHotHudBindingRate::Type> rate, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+	error = true;
+	// Labels have their own binding, which formats numbers as they're drawn (see BindLabelToProperty).
+	if (control->Type() == HotHudControl_Label) {
+		UE_LOG(LogHUD, Error, TEXT("BindControlToProperty(%s): Labels are bound with BindLabelToProperty."), *controlName.ToString());
+		return;
+	}
+	if (control->Type() != HotHudControl_TextBox && control->Type() != HotHudControl_Tile && control->Type() != HotHudControl_Gauge) {
+		UE_LOG(LogHUD, Error, TEXT("BindControlToProperty(%s): This type of control can't be bound."), *controlName.ToString());
+		return;
+	}
+	if (object == nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("BindControlToProperty(%s): No object."), *controlName.ToString());
+		return;
+	}
+
+	HotHudPropertyPath path;
+	FString reason;
+	if (!path.Resolve(object->GetClass(), propertyPath, reason)) {
+		UE_LOG(LogHUD, Error, TEXT("BindControlToProperty(%s): Can't resolve '%s': %s"), *controlName.ToString(), *propertyPath, *reason);
+		return;
+	}
+	if (control->Type() == HotHudControl_Gauge && !path.IsNumeric()) {
+		UE_LOG(LogHUD, Error, TEXT("BindControlToProperty(%s): Gauges need a numeric property."), *controlName.ToString());
+		return;
+	}
+
+	// Only one binding per control; a re-bind replaces the old one in place.
+	HotHudPropertyBinding* binding = nullptr;
+	for (HotHudPropertyBinding& existing : bindings_) {
+		if (existing.Control == control) {
+			binding = &existing;
+			break;
+		}
+	}
+	if (binding == nullptr) {
+		binding = &bindings_[bindings_.AddDefaulted()];
+		binding->Control = control;
+	}
+	binding->Object = object;
+	binding->Path = path;
+	binding->Rate = rate;
+	binding->NextPollTime = 0.0f;
+	binding->HasValue = false;
+	binding->ControlShown = true;
+	binding->ShownGeneration = INDEX_NONE;
+	binding->RefreshRequested = false;
+	binding->LastNumber = 0.0;
+	binding->LastText.Empty();
+
+	// Show the current value straight away rather than waiting for the next poll.
+	UpdateBinding(*binding, true);
+	error = false;
+}
+
+void AHotHud::UnbindControl(const FName& controlName, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+	for (int32 i = 0; i < bindings_.Num(); i++) {
+		if (bindings_[i].Control == control) {
+			bindings_.RemoveAt(i);
+			break;
+		}
+	}
+	if (control->Type() == HotHudControl_Tile) {
+		static_cast<HotHudTile*>(control)->ClearBoundLabel();
+	}
+}
+
+void AHotHud::RefreshBindings(const FName& controlName) {
+	HotHudControl* control = controlName.IsNone() ? nullptr : FindControlByName(controlName);
+	for (HotHudPropertyBinding& binding : bindings_) {
+		if (control == nullptr || binding.Control == control) {
+			binding.RefreshRequested = true;
+		}
+	}
+}
+
+void AHotHud::PollBindings() {
+	float now = RealTimeSeconds();
+	int32 shownGeneration = HotHudControl::ShownGeneration();
+	for (HotHudPropertyBinding& binding : bindings_) {
+		// Hidden controls (in a closed tab, say) cost nothing until they're shown, and then catch up at once.
+		if (binding.ShownGeneration != shownGeneration) {
+			binding.ShownGeneration = shownGeneration;
+			bool shown = binding.Control->IsShownInTree();
+			if (shown && !binding.ControlShown) {
+				binding.RefreshRequested = true;
+			}
+			binding.ControlShown = shown;
+		}
+		if (!binding.ControlShown) {
+			continue;
+		}
+		if (!binding.RefreshRequested) {
+			if (binding.Rate == EHotHudBindingRate::OnDemand) {
+				continue;
+			}
+			if (binding.Rate == EHotHudBindingRate::TenHz) {
+				if (now < binding.NextPollTime) {
+					continue;
+				}
+				binding.NextPollTime = now + 0.1f;
+			}
+		}
+		binding.RefreshRequested = false;
+		UpdateBinding(binding, false);
+	}
+}
+
+void AHotHud::UpdateBinding(HotHudPropertyBinding& binding, bool force) {
+	UObject* object = binding.Object.Get();
+	if (object == nullptr) {
+		return;
+	}
+
+	HotHudControl* control = binding.Control;
+	if (binding.Path.IsNumeric()) {
+		double number;
+		if (!binding.Path.ReadNumber(object, number) || (binding.HasValue && !force && number == binding.LastNumber)) {
+			return;
+		}
+		binding.LastNumber = number;
+		if (control->Type() == HotHudControl_Gauge) {
+			static_cast<HotHudGauge*>(control)->SetValue((float)number);
+			binding.HasValue = true;
+			return;
+		}
+		// Text controls still want the number as text, but only now that it changed.
+		binding.Path.ReadText(object, bindingScratch_);
+	}
+	else {
+		if (!binding.Path.ReadText(object, bindingScratch_) || (binding.HasValue && !force && bindingScratch_.Equals(binding.LastText, ESearchCase::CaseSensitive))) {
 			return;
 		}
+		binding.LastText = bindingScratch_;
+	}
+	binding.HasValue = true;
+
+	switch (control->Type()) {
+	case HotHudControl_TextBox:
+		static_cast<HotHudTextBox*>(control)->SetText(bindingScratch_);
+		break;
+	case HotHudControl_Tile:
+		static_cast<HotHudTile*>(control)->SetBoundLabel(bindingScratch_);
+		break;
+	default:
+		break;
+	}
+}
+
+bool AHotHud::SetTileGridDataSource(const FName& tileGridName, HotHudTileDataSource* source) {
+	bool error;
+	HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(HandleControlLookup(tileGridName, HotHudControl_TileGrid, error));
+	if (grid == nullptr) {
+		return false;
+	}
+	grid->SetDataSource(this, source);
+	return true;
+}
+
+void AHotHud::RegisterControl(HotHudControl* control) {
+	controlMap_.Add(control->Name(), control);
+	InvalidateHover();
+}
+
+void AHotHud::ForgetControl(HotHudControl* control) {
+	HOTHUD_TRACE_EVENT(HotHudTrace_Lifecycle, HotHudTraceEvent_ControlDeleted, control->Name());
+	controlMap_.Remove(control->Name());
+	if (resources_->TileAtlas != nullptr && control->Type() == HotHudControl_Tile) {
+		resources_->TileAtlas->Release(static_cast<HotHudTile*>(control)->AtlasKey());
+	}
+	tweens_.Remove(control);
+	for (int32 i = bindings_.Num() - 1; i >= 0; i--) {
+		if (bindings_[i].Control == control) {
+			bindings_.RemoveAt(i);
+		}
+	}
+
+	// Every HUD showing the control may be interacting with it.
+	ForgetInteraction(control);
+	for (const TWeakObjectPtr<AHotHud>& follower : treeFollowers_) {
+		if (follower.IsValid()) {
+			follower->ForgetInteraction(control);
+		}
+	}
+	InvalidateHover();
+}
+
+void AHotHud::ForgetInteraction(HotHudControl* control) {
+	dropTargetCache_.Remove(control);
+	if (controlBeingDragged_ == control) {
+		if (controlBeingHovered_ != nullptr) {
+			controlBeingHovered_->SetValidDragSource(nullptr);
+		}
+		dragDropTargetValid_ = false;
+		EndDragSession();
+	}
+	if (controlBeingHovered_ == control) {
+		controlBeingHovered_ = nullptr;
+	}
+	if (controlBeingMoved_ == control) {
+		controlBeingMoved_ = nullptr;
+	}
+	if (focusedControl_ == control) {
+		focusedControl_ = nullptr;
+	}
+	if (scrollbarDragWindow_ == control) {
+		scrollbarDragWindow_ = nullptr;
+	}
+}
+
+void AHotHud::InvalidateHover() {
+	AHotHud* owner = TreeOwner();
+	owner->hoverDirty_ = true;
+	for (const TWeakObjectPtr<AHotHud>& follower : owner->treeFollowers_) {
+		if (follower.IsValid()) {
+			follower->hoverDirty_ = true;
+		}
+	}
+}
+
+void AHotHud::GetGlyphRunCacheStats(int32& hits, int32& misses, int32& replays, int32& numEntries) {
+	hits = resources_->GlyphRunCache.Hits();
+	misses = resources_->GlyphRunCache.Misses();
+	replays = glyphRunReplays_;
+	numEntries = resources_->GlyphRunCache.NumEntries();
+}
+
+void AHotHud::DrawCachedText(
+	TSharedPtr<HotHudGlyphRun>& run, const FString& text, const FLinearColor& color,
+	float x, float y, UFont* font, float scale, float opacity) {
+	UFont* resolvedFont = (font != nullptr) ? font : GEngine->GetMediumFont();
+	if (run.IsValid() && run->Font == resolvedFont && run->Scale == scale && run->Color == color) {
+		glyphRunReplays_++;
+	}
+	else {
+		run = resources_->GlyphRunCache.Acquire(text, resolvedFont, scale, color);
+		if (!run.IsValid()) {
+			FLinearColor fadedColor = color;
+			fadedColor.A *= opacity;
+			DrawText(text, fadedColor, x, y, font, scale, false);
+			if (capture_ != nullptr) {
+				capture_->Record(HotHudCapture_Text, drawingControl_, x, y, 0, 0, fadedColor, resolvedFont, FCrc::StrCrc32(*text));
+			}
+			return;
+		}
+	}
+	run->LastUsedFrame = GFrameCounter;
+	textBatch_.Add(*run, FVector2D(x, y), opacity);
+	if (capture_ != nullptr) {
+		FLinearColor fadedColor = color;
+		fadedColor.A *= opacity;
+		// The run's own string: callers may pass stale text along with a still valid run.
+		capture_->Record(HotHudCapture_Text, drawingControl_, x, y, run->Size.X, run->Size.Y, fadedColor, resolvedFont, FCrc::StrCrc32(*run->Text));
+	}
+}
+
+void AHotHud::DrawChromeRect(const FLinearColor& color, float x, float y, float width, float height) {
+	// Clipped here rather than by the canvas so that differently clipped chrome can share one item.
+	float minX = FMath::Max(x, chromeClip_.MinX);
+	float minY = FMath::Max(y, chromeClip_.MinY);
+	float maxX = FMath::Min(x + width, chromeClip_.MaxX);
+	float maxY = FMath::Min(y + height, chromeClip_.MaxY);
+	if (maxX > minX && maxY > minY) {
+		AppendQuad(chromeBatch_, FVector2D(minX, minY), FVector2D(maxX - minX, maxY - minY), FVector4(0, 0, 1, 1), color);
+		if (capture_ != nullptr) {
+			capture_->Record(HotHudCapture_Rect, drawingControl_, minX, minY, maxX - minX, maxY - minY, color);
+		}
+	}
+}
+
+void AHotHud::DrawChromeOutline(const FLinearColor& color, float x, float y, float width, float height) {
+	DrawChromeRect(color, x, y, width, 1);
+	DrawChromeRect(color, x, y + height - 1, width, 1);
+	DrawChromeRect(color, x, y + 1, 1, height - 2);
+	DrawChromeRect(color, x + width - 1, y + 1, 1, height - 2);
+}
+
+void AHotHud::FlushChrome() {
+	if (chromeBatch_.Num() > 0) {
+		FCanvasTriangleItem item(chromeBatch_, GWhiteTexture);
+		item.BlendMode = SE_BLEND_Translucent;
+		Canvas->DrawItem(item);
+		chromeBatch_.Reset();
+	}
+}
+
+void AHotHud::FlushText() {
+	if (!textBatch_.IsEmpty()) {
+		textBatch_.Submit(Canvas);
+	}
+}
+
+void AHotHud::InvalidateDropTargetCache() {
+	dropTargetCache_.Empty();
+	dropTargetCacheComplete_ = false;
+}
+
+void AHotHud::BeginDragSession(HotHudControl* source) {
+	controlBeingDragged_ = source;
+	InvalidateDropTargetCache();
+
+	if (PreResolveDropTargets && !NativeDropTargetValidator.IsBound()) {
+		TArray<FName> validTargets;
+		bool handled = false;
+		ReceiveResolveDropTargetsRequest(source->Name(), validTargets, handled);
+		if (handled) {
+			dropTargetCache_.Reserve(validTargets.Num());
+			for (const FName& targetName : validTargets) {
+				HotHudControl* target = FindControlByName(targetName);
+				if (target != nullptr) {
+					dropTargetCache_.Add(target, true);
+				}
+			}
+			dropTargetCacheComplete_ = true;
+		}
+	}
+}
+
+void AHotHud::EndDragSession() {
+	controlBeingDragged_ = nullptr;
+	InvalidateDropTargetCache();
+}
+
+bool AHotHud::ValidateDropTarget(HotHudControl* target) {
+	bool* cached = dropTargetCache_.Find(target);
+	if (cached != nullptr) {
+		return *cached;
+	}
+	if (dropTargetCacheComplete_) {
+		return false;
+	}
+
+	bool okToDrop = false;
+	if (NativeDropTargetValidator.IsBound()) {
+		okToDrop = NativeDropTargetValidator.Execute(controlBeingDragged_->Name(), target->Name());
+	}
+	else {
+		ReceiveValidateDropTargetRequest(controlBeingDragged_->Name(), target->Name(), okToDrop);
+	}
+	dropTargetCache_.Add(target, okToDrop);
+
+	HOTHUD_TRACE_EVENT(HotHudTrace_Interaction, HotHudTraceEvent_DropTargetValidated, target->Name(), okToDrop ? 1 : 0);
+	return okToDrop;
+}
+
+void AHotHud::DefineWindowStyle(const FName& styleName, const FManagedWindowBuildOptions& options) {
+	resources_->WindowStyles.Define(styleName, StyleOptions(options));
+}
+
+void AHotHud::DefineTextBoxStyle(const FName& styleName, const FTextBoxBuildOptions& options) {
+	resources_->TextBoxStyles.Define(styleName, StyleOptions(options));
+}
+
+void AHotHud::DefineTileGridStyle(const FName& styleName, const FTileGridBuildOptions& options) {
+	resources_->TileGridStyles.Define(styleName, options);
+}
+
+void AHotHud::DefineGaugeStyle(const FName& styleName, const FGaugeBuildOptions& options) {
+	resources_->GaugeStyles.Define(styleName, options);
+}
+
+void AHotHud::ApplyStyleToControl(const FName& controlName, const FName& styleName, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+
+	error = true;
+	switch (control->Type()) {
+	case HotHudControl_Window: {
+		TSharedPtr<HotHudWindowStyle> style = resources_->WindowStyles.Find(styleName);
+		if (style.IsValid()) {
+			static_cast<HotHudWindow*>(control)->SetStyle(style.ToSharedRef());
+			error = false;
+		}
+		break;
+	}
+	case HotHudControl_TextBox: {
+		TSharedPtr<HotHudTextBoxStyle> style = resources_->TextBoxStyles.Find(styleName);
+		if (style.IsValid()) {
+			static_cast<HotHudTextBox*>(control)->SetStyle(style.ToSharedRef());
+			error = false;
+		}
+		break;
+	}
+	case HotHudControl_Label: {
+		TSharedPtr<HotHudTextBoxStyle> style = resources_->TextBoxStyles.Find(styleName);
+		if (style.IsValid()) {
+			static_cast<HotHudLabel*>(control)->SetStyle(style.ToSharedRef());
+			error = false;
+		}
+		break;
+	}
+	case HotHudControl_TileGrid: {
+		TSharedPtr<HotHudTileGridStyle> style = resources_->TileGridStyles.Find(styleName);
+		if (style.IsValid()) {
+			static_cast<HotHudTileGrid*>(control)->SetStyle(style.ToSharedRef());
+			error = false;
+		}
+		break;
+	}
+	case HotHudControl_Gauge: {
+		TSharedPtr<HotHudGaugeStyle> style = resources_->GaugeStyles.Find(styleName);
+		if (style.IsValid()) {
+			static_cast<HotHudGauge*>(control)->SetStyle(style.ToSharedRef());
+			error = false;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	if (error) {
+		UE_LOG(LogHUD, Error, TEXT("ApplyStyleToControl(%s): No style '%s' for this type of control."), *controlName.ToString(), *styleName.ToString());
+	}
+}
+
+void AHotHud::SetControlBackgroundColor(const FName& controlName, const FLinearColor& color, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+	control->SetStyleOverride(HotHudStyleOverride_BackgroundColor, color);
+}
+
+void AHotHud::SetControlTextColor(const FName& controlName, const FLinearColor& color, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+	control->SetStyleOverride(HotHudStyleOverride_TextColor, color);
+}
+
+void AHotHud::ClearControlStyleOverrides(const FName& controlName, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+	control->ClearStyleOverrides();
+}
+
+void AHotHud::StartTween(
+	const FName& controlName, HotHudTweenProperty property, const FVector2D& to, float duration,
+	EHotHudEasing::Type easing, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+
+	FVector2D from;
+	switch (property) {
+	case HotHudTween_Position:
+		from = control->Geometry().Location;
+		break;
+	case HotHudTween_Size:
+		from = FVector2D(control->Geometry().Width, control->Geometry().Height);
+		break;
+	case HotHudTween_Opacity:
+		from = FVector2D(control->Opacity(), 0);
+		break;
+	}
+	float now = RealTimeSeconds();
+	tweens_.Add(control, property, from, to, now, duration, easing);
+	if (!control->IsShownInTree()) {
+		tweens_.Park(control, now);
+	}
+	error = false;
+}
+
+void AHotHud::TweenControlPosition(const FName& controlName, FVector2D location, float duration, TEnumAsByte<EHotHudEasing::Type> easing, bool& error) {
+	StartTween(controlName, HotHudTween_Position, location, duration, easing, error);
+}
+
+void AHotHud::TweenControlSize(const FName& controlName, int32 width, int32 height, float duration, TEnumAsByte<EHotHudEasing::Type> easing, bool& error) {
+	StartTween(controlName, HotHudTween_Size, FVector2D(width, height), duration, easing, error);
+}
+
+void AHotHud::TweenControlOpacity(const FName& controlName, float opacity, float duration, TEnumAsByte<EHotHudEasing::Type> easing, bool& error) {
+	StartTween(controlName, HotHudTween_Opacity, FVector2D(opacity, 0), duration, easing, error);
+}
+
+void AHotHud::CancelControlTweens(const FName& controlName, bool snapToEnd, bool& error) {
+	HotHudControl* control = HandleControlLookup(controlName, HotHudControl_Any, error);
+	if (control == nullptr) {
+		return;
+	}
+	if (snapToEnd) {
+		for (int32 i = 0; i < tweens_.Num(); i++) {
+			if (tweens_.Control(i) != control) {
+				continue;
+			}
+			const FVector2D& target = tweens_.Target(i);
+			switch (tweens_.Property(i)) {
+			case HotHudTween_Position:
+				control->MoveToRelative(target);
+				break;
+			case HotHudTween_Size:
+				control->Resize(FMath::RoundToInt(target.X), FMath::RoundToInt(target.Y));
+				break;
+			case HotHudTween_Opacity:
+				control->SetOpacity(target.X);
+				break;
+			}
+		}
+		InvalidateHover();
+	}
+	tweens_.Remove(control);
+}
+
+float AHotHud::RealTimeSeconds() const {
+	UWorld* world = GetWorld();
+	if (world != nullptr) {
+		return world->GetRealTimeSeconds();
+	}
+	return (float)(FPlatformTime::Seconds() - GStartTime);
+}
+
+void AHotHud::StepTweens() {
+	float now = RealTimeSeconds();
+	// Tweens of hidden controls are parked, and carry on from where they were once shown again.
+	if (tweenShownGeneration_ != HotHudControl::ShownGeneration()) {
+		tweenShownGeneration_ = HotHudControl::ShownGeneration();
+		tweens_.UpdateParked(now);
+	}
+	tweens_.Step(now);
+
+	// Write the results back through the same paths the BP methods use.
+	for (int32 i = 0; i < tweens_.Num(); i++) {
+		HotHudControl* control = tweens_.Control(i);
+		const FVector2D& value = tweens_.Value(i);
+		switch (tweens_.Property(i)) {
+		case HotHudTween_Position:
+			control->MoveToRelative(value);
+			InvalidateHover();
+			break;
+		case HotHudTween_Size: {
+			// Resizing throws away cached layout, so only do it when the size actually changes.
+			int32 width = FMath::RoundToInt(value.X);
+			int32 height = FMath::RoundToInt(value.Y);
+			if (width != control->Geometry().Width || height != control->Geometry().Height) {
+				control->Resize(width, height);
+				InvalidateHover();
+			}
+			break;
+		}
+		case HotHudTween_Opacity:
+			control->SetOpacity(value.X);
+			break;
+		}
+		if (tweens_.IsFinished(i)) {
+			completedTweens_.Add(control->Name());
+		}
+	}
+
+	if (completedTweens_.Num() > 0) {
+		tweens_.RemoveFinished();
+		ReceiveTweensCompleted(completedTweens_);
+		completedTweens_.Reset();
+	}
+}
+
+void AHotHud::StepLogic() {
+	if (tweens_.Num() > 0) {
+		StepTweens();
+	}
+	if (bindings_.Num() > 0) {
+		PollBindings();
+	}
+}
+
+bool AHotHud::BindInput() {
+	if (inputBound_) {
+		return true;
+	}
+	if (localPlayerController_ == nullptr) {
+		return false;
+	}
+	EnableInput(localPlayerController_);
+	if (InputComponent == nullptr) {
+		return false;
+	}
+
+	// Let the game see these too; HotHud only listens.
+	InputComponent->BindKey(EKeys::LeftMouseButton, IE_Pressed, this, &AHotHud::OnLeftMouseButtonPressed).bConsumeInput = false;
+	InputComponent->BindKey(EKeys::LeftMouseButton, IE_Released, this, &AHotHud::OnLeftMouseButtonReleased).bConsumeInput = false;
+	InputComponent->BindKey(EKeys::MouseScrollUp, IE_Pressed, this, &AHotHud::OnMouseScrollUp).bConsumeInput = false;
+	InputComponent->BindKey(EKeys::MouseScrollDown, IE_Pressed, this, &AHotHud::OnMouseScrollDown).bConsumeInput = false;
+	inputBound_ = true;
+	return true;
+}
+
+FVector2D AHotHud::PollMouseLocation() const {
+	FVector2D location;
+	if (localPlayerController_ == nullptr || !localPlayerController_->GetMousePosition(location.X, location.Y)) {
+		return mouseLocation_;
+	}
+	// Into control tree space.
+	return (location - viewportOffset_) / viewportScale_;
+}
+
+void AHotHud::OnLeftMouseButtonPressed() {
+	QueueInput(HotHudInputEvent::ButtonDown, PollMouseLocation());
+}
+
+void AHotHud::OnLeftMouseButtonReleased() {
+	QueueInput(HotHudInputEvent::ButtonUp, PollMouseLocation());
+}
+
+void AHotHud::OnMouseScrollUp() {
+	QueueInput(HotHudInputEvent::Wheel, PollMouseLocation()).WheelDelta = 1.0f;
+}
+
+void AHotHud::OnMouseScrollDown() {
+	QueueInput(HotHudInputEvent::Wheel, PollMouseLocation()).WheelDelta = -1.0f;
+}
+
+bool AHotHud::InputKey(const FKey& key) {
+	if (focusedControl_ == nullptr) {
+		return false;
+	}
+	QueueInput(HotHudInputEvent::Key, mouseLocation_).Key = key;
+	return true;
+}
+
+bool AHotHud::InputChar(TCHAR character) {
+	if (focusedControl_ == nullptr) {
+		return false;
+	}
+	QueueInput(HotHudInputEvent::Character, mouseLocation_).Char = character;
+	return true;
+}
+
+void AHotHud::HandleKeyInput(const FKey& key, bool& consumed) {
+	consumed = InputKey(key);
+}
+
+void AHotHud::HandleCharacterInput(const FString& characters, bool& consumed) {
+	consumed = false;
+	for (int32 i = 0; i < characters.Len(); i++) {
+		consumed = InputChar(characters[i]);
+	}
+}
+
+void AHotHud::FocusControl(const FName& controlName, bool& error) {
+	if (controlName == NAME_None) {
+		SetFocusedControl(nullptr);
+		error = false;
+		return;
+	}
+	HotHudControl* control = FindControlByName(controlName);
+	if (control == nullptr || !control->IsFocusable()) {
+		UE_LOG(LogHUD, Error, TEXT("FocusControl(%s): No such focusable control"), *controlName.ToString());
+		error = true;
+		return;
+	}
+	SetFocusedControl(control);
+	error = false;
+}
+
+void AHotHud::SetFocusedControl(HotHudControl* control) {
+	if (focusedControl_ != nullptr) {
+		focusedControl_->SetIsFocused(false);
+	}
+	focusedControl_ = control;
+	if (focusedControl_ != nullptr) {
+		focusedControl_->SetIsFocused(true);
+	}
+}
+
+void AHotHud::GetMemoryStats(FHotHudMemoryStats& stats) {
+	stats = FHotHudMemoryStats();
+	for (auto it = controlMap_.CreateConstIterator(); it; ++it) {
+		it.Value()->AccumulateMemoryStats(stats);
+	}
+	stats.GlyphCacheBytes = resources_->GlyphRunCache.GetAllocatedSize() + textBatch_.GetAllocatedSize();
+	if (resources_->TileAtlas != nullptr) {
+		stats.TileAtlasBytes = resources_->TileAtlas->GetAllocatedSize();
+	}
+	stats.StyleBytes = resources_->WindowStyles.GetAllocatedSize() + resources_->TextBoxStyles.GetAllocatedSize() + resources_->TileGridStyles.GetAllocatedSize() +
+		resources_->GaugeStyles.GetAllocatedSize();
+	stats.HudBytes = controlMap_.GetAllocatedSize() + rootWindows_.GetAllocatedSize() + pendingInput_.GetAllocatedSize() +
+		dropTargetCache_.GetAllocatedSize() + tweens_.GetAllocatedSize() + completedTweens_.GetAllocatedSize();
+	for (int32 i = 0; i < HotHudWorkPriority_NumPriorities; i++) {
+		stats.HudBytes += workQueues_[i].GetAllocatedSize() + parkedWork_[i].GetAllocatedSize();
+	}
+	stats.HudBytes += drawLayer_.GetAllocatedSize() + chromeBatch_.GetAllocatedSize();
+	stats.HudBytes += bindings_.GetAllocatedSize() + bindingScratch_.GetCharArray().GetAllocatedSize();
+	for (const HotHudPropertyBinding& binding : bindings_) {
+		stats.HudBytes += binding.Path.GetAllocatedSize() + binding.LastText.GetCharArray().GetAllocatedSize();
+	}
+	stats.TotalBytes =
+		stats.WindowBytes + stats.TextBoxBytes + stats.LabelBytes + stats.GaugeBytes + stats.TileGridBytes + stats.TileBytes + stats.TextBytes +
+		stats.TileDataBytes + stats.GlyphCacheBytes + stats.TileAtlasBytes + stats.StyleBytes + stats.HudBytes;
+}
+
+void AHotHud::TrimMemory(FHotHudMemoryStats& stats) {
+	GetMemoryStats(stats);
+	ApplyTrimPolicies(0, stats);
+}
+
+void AHotHud::EnforceMemoryBudget() {
+	int64 budgetBytes = (int64)MemoryBudgetKB * 1024;
+	FHotHudMemoryStats stats;
+	GetMemoryStats(stats);
+	if (stats.TotalBytes <= budgetBytes) {
+		memoryBudgetExceeded_ = false;
+		memoryBudgetBackoff_ = 0;
+		memoryBudgetChecksToSkip_ = 0;
+		return;
+	}
+	// Trimming which didn't help is retried less and less often, rather than emptying caches every check
+	// only for them to be rebuilt in the frames between.
+	if (memoryBudgetChecksToSkip_ > 0) {
+		memoryBudgetChecksToSkip_--;
+		return;
+	}
+
+	ApplyTrimPolicies(budgetBytes, stats);
+	bool underBudget = stats.TotalBytes <= budgetBytes;
+	if (underBudget) {
+		memoryBudgetBackoff_ = 0;
+	}
+	else {
+		memoryBudgetBackoff_ = FMath::Clamp(memoryBudgetBackoff_ * 2, 1, kMemoryBudgetMaxBackoff);
+		memoryBudgetChecksToSkip_ = memoryBudgetBackoff_;
+	}
+	if (!memoryBudgetExceeded_) {
+		UE_LOG(LogHUD, Warning, TEXT("HotHud memory budget exceeded (%d KB used after trimming, budget %d KB)"), stats.TotalBytes / 1024, MemoryBudgetKB);
+		ReceiveMemoryBudgetExceeded(stats, underBudget);
+	}
+	memoryBudgetExceeded_ = !underBudget;
+}
+
+void AHotHud::DrawWindowLayers(HotHudWindow* window, const HotHudClipRect& clip) {
+	// Windows scrolled entirely out of their parent's client area are culled along with their contents.
+	if (!clip.Intersects(window->ScreenCoords().X, window->ScreenCoords().Y, window->Geometry().Width, window->Geometry().Height) ||
+		!window->PrepareDraw()) {
+		return;
+	}
+	HotHudClipRect contentClip = clip.Intersection(window->ClientRect());
+	TArray<HotHudWindow*> subWindows;
+	drawLayer_.Reset();
+	drawLayer_.Windows.Add(window);
+	GatherLayer(window, clip, contentClip, subWindows);
+	DrawLayer(clip, contentClip);
+
+	// Sub-windows are drawn on top of everything else in their parent.
+	for (HotHudWindow* subWindow : subWindows) {
+		DrawWindowLayers(subWindow, contentClip);
+	}
+}
+
+void AHotHud::GatherLayer(HotHudControl* parent, const HotHudClipRect& windowClip, const HotHudClipRect& clip, TArray<HotHudWindow*>& subWindows) {
+	for (HotHudControl* child : parent->Children()) {
+		// Hidden subtrees aren't prepared (laid out) or walked at all.
+		if (!child->IsShown()) {
+			continue;
+		}
+		float x = child->ScreenCoords().X;
+		float y = child->ScreenCoords().Y;
+		float width = child->Geometry().Width;
+		float height = child->Geometry().Height;
+		if (!clip.Intersects(x, y, width, height)) {
+			continue;
+		}
+		if (child->Type() != HotHudControl_Window) {
+			// Passes draw bucket by bucket, so an overlapping control would be drawn partly under the one it
+			// covers. Draw what we have and carry on in a fresh layer on top. Layouts which don't overlap
+			// never get here and stay in one batch.
+			if (drawLayer_.Overlaps(child)) {
+				DrawLayer(windowClip, clip);
+				drawLayer_.Reset();
+			}
+			drawLayer_.AddOccupant(child);
+			if (!clip.Contains(x, y, width, height)) {
+				drawLayer_.ClipContent = true;
+			}
+		}
+
+		switch (child->Type()) {
+		case HotHudControl_Window:
+			subWindows.Add(static_cast<HotHudWindow*>(child));
+			break;
+		case HotHudControl_TextBox: {
+			HotHudTextBox* textBox = static_cast<HotHudTextBox*>(child);
+			textBox->PrepareDraw(this, Canvas);
+			drawLayer_.TextBoxes.Add(textBox);
+			GatherLayer(child, windowClip, clip, subWindows);
+			break;
+		}
+		case HotHudControl_Label: {
+			HotHudLabel* label = static_cast<HotHudLabel*>(child);
+			label->PrepareDraw(this, Canvas);
+			drawLayer_.Labels.Add(label);
+			break;
+		}
+		case HotHudControl_Gauge:
+			drawLayer_.Gauges.Add(static_cast<HotHudGauge*>(child));
+			break;
+		case HotHudControl_TileGrid: {
+			// The grid's tiles are gathered in slot order by the grid itself.
+			HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(child);
+			grid->PrepareDraw(this, Canvas);
+			drawLayer_.TileGrids.Add(grid);
+			grid->AppendDrawableTiles(drawLayer_.Tiles, clip);
+			break;
+		}
+		case HotHudControl_Tile:
+			drawLayer_.Tiles.Add(static_cast<HotHudTile*>(child));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void AHotHud::DrawLayer(const HotHudClipRect& windowClip, const HotHudClipRect& contentClip) {
+	// Chrome first, then images, text and finally overlays (carets). Each pass goes type by type, so
+	// render state only changes between buckets. Chrome is flat colored and goes out as one item.
+	chromeClip_ = windowClip;
+	DrawPass<HotHudWindow, &HotHudWindow::DrawChrome>(this, Canvas, drawLayer_.Windows);
+	chromeClip_ = contentClip;
+	DrawPass<HotHudTileGrid, &HotHudTileGrid::DrawChrome>(this, Canvas, drawLayer_.TileGrids);
+	DrawPass<HotHudTextBox, &HotHudTextBox::DrawChrome>(this, Canvas, drawLayer_.TextBoxes);
+	DrawPass<HotHudLabel, &HotHudLabel::DrawChrome>(this, Canvas, drawLayer_.Labels);
+	DrawPass<HotHudGauge, &HotHudGauge::DrawChrome>(this, Canvas, drawLayer_.Gauges);
+	FlushChrome();
+
+	// Images & text can't be clipped as they are queued, so the canvas masks them - but only when something
+	// actually crosses the clip rect. Otherwise the window title shares the text items with the content.
+	// Layers split off by GatherLayer() carry on after the window and have no window of their own.
+	HotHudWindow* window = (drawLayer_.Windows.Num() > 0) ? drawLayer_.Windows[0] : nullptr;
+	bool clipWindow = window != nullptr && !windowClip.Contains(window->ScreenCoords().X, window->ScreenCoords().Y, window->Geometry().Width, window->Geometry().Height);
+	if (clipWindow) {
+		Canvas->Canvas->PushMaskRegion(windowClip.MinX, windowClip.MinY, windowClip.MaxX - windowClip.MinX, windowClip.MaxY - windowClip.MinY);
+	}
+	DrawPass<HotHudWindow, &HotHudWindow::DrawText>(this, Canvas, drawLayer_.Windows);
+	if (clipWindow || drawLayer_.ClipContent) {
+		FlushText();
+	}
+	if (clipWindow) {
+		Canvas->Canvas->PopMaskRegion();
+	}
+	if (drawLayer_.ClipContent) {
+		Canvas->Canvas->PushMaskRegion(contentClip.MinX, contentClip.MinY, contentClip.MaxX - contentClip.MinX, contentClip.MaxY - contentClip.MinY);
+	}
+
+	if (resources_->TileAtlas == nullptr) {
+		// Consecutive tiles with the same texture can be batched by the canvas.
+		drawLayer_.Tiles.Sort([](const HotHudTile& a, const HotHudTile& b) { return a.Image() < b.Image(); });
+	}
+	DrawTileImages(this, Canvas, drawLayer_.Tiles);
+
+	// Text from every control in the layer goes out together, one item per font page.
+	DrawPass<HotHudTextBox, &HotHudTextBox::DrawText>(this, Canvas, drawLayer_.TextBoxes);
+	DrawPass<HotHudLabel, &HotHudLabel::DrawText>(this, Canvas, drawLayer_.Labels);
+	DrawPass<HotHudTile, &HotHudTile::DrawText>(this, Canvas, drawLayer_.Tiles);
+	FlushText();
+
+	DrawPass<HotHudTextBox, &HotHudTextBox::DrawOverlay>(this, Canvas, drawLayer_.TextBoxes);
+	FlushChrome();
+	drawingControl_ = nullptr;
+	if (drawLayer_.ClipContent) {
+		Canvas->Canvas->PopMaskRegion();
+	}
+}
+
+void AHotHud::ScrollWindow(const FName& windowName, FVector2D offset, bool& error) {
+	HotHudWindow* window = static_cast<HotHudWindow*>(HandleControlLookup(windowName, HotHudControl_Window, error));
+	if (window != nullptr) {
+		window->ScrollTo(offset);
+		InvalidateHover();
+	}
+}
+
+void AHotHud::GetWindowScroll(const FName& windowName, FVector2D& offset, FVector2D& contentSize, bool& error) {
+	HotHudWindow* window = static_cast<HotHudWindow*>(HandleControlLookup(windowName, HotHudControl_Window, error));
+	if (window != nullptr) {
+		offset = window->ScrollOffset();
+		contentSize = window->ContentSize();
+	}
+}
+
+void AHotHud::ShareControlTree(AHotHud* owner, bool& error) {
+	error = true;
+	if (owner == nullptr || owner == this) {
+		UE_LOG(LogHUD, Error, TEXT("ShareControlTree: Invalid owner HUD."));
+		return;
+	}
+	if (owner->treeOwner_.IsValid()) {
+		UE_LOG(LogHUD, Error, TEXT("ShareControlTree: '%s' is itself showing another HUD's controls."), *owner->GetName());
+		return;
+	}
+	if (controlMap_.Num() > 0 || treeFollowers_.Num() > 0) {
+		UE_LOG(LogHUD, Error, TEXT("ShareControlTree: '%s' already has controls of its own."), *GetName());
+		return;
+	}
+	treeOwner_ = owner;
+	owner->treeFollowers_.Add(this);
+	resources_ = owner->resources_;
+	hoverDirty_ = true;
+	error = false;
+}
+
+void AHotHud::SetViewportTransform(const FVector2D& offset, float scale) {
+	if (scale <= 0.0f) {
+		UE_LOG(LogHUD, Error, TEXT("SetViewportTransform: Scale must be positive."));
+		return;
+	}
+	viewportOffset_ = offset;
+	viewportScale_ = scale;
+	hoverDirty_ = true;
+}
+
+void AHotHud::SaveSnapshot(TArray<uint8>& data) {
+	data.Reset();
+	FMemoryWriter ar(data);
+	uint32 magic = kSnapshotMagic;
+	int32 version = kSnapshotVersion;
+	int32 numControls = controlMap_.Num();
+	ar << magic << version << numControls;
+
+	SaveNamedStyles(ar, resources_->WindowStyles);
+	SaveNamedStyles(ar, resources_->TextBoxStyles);
+	SaveNamedStyles(ar, resources_->TileGridStyles);
+	SaveNamedStyles(ar, resources_->GaugeStyles);
+
+	int32 numRootWindows = rootWindows_.Num();
+	ar << numRootWindows;
+	for (HotHudWindow* window : rootWindows_) {
+		SaveControl(ar, window);
+	}
+}
+
+void AHotHud::RestoreSnapshot(const TArray<uint8>& data, bool& error) {
+	error = true;
+	if (controlMap_.Num() > 0) {
+		UE_LOG(LogHUD, Error, TEXT("RestoreSnapshot: The HUD already has controls."));
+		return;
+	}
+
+	FMemoryReader ar(data);
+	uint32 magic = 0;
+	int32 version = 0;
+	int32 numControls = 0;
+	ar << magic << version << numControls;
+	if (ar.IsError() || magic != kSnapshotMagic || version != kSnapshotVersion) {
+		UE_LOG(LogHUD, Error, TEXT("RestoreSnapshot: Not a snapshot, or from an incompatible version (%d)."), version);
+		return;
+	}
+	// Every control takes at least a byte, so a count the data can't hold is corrupt. Checked before it's
+	// used to size anything.
+	if (numControls < 0 || numControls > data.Num() - ar.Tell()) {
+		UE_LOG(LogHUD, Error, TEXT("RestoreSnapshot: Snapshot is corrupt (%d controls in %d bytes)."), numControls, data.Num());
+		return;
+	}
+	// Everything is added in one pass, so size the tables up front.
+	controlMap_.Reserve(numControls);
+
+	LoadNamedStyles(ar, resources_->WindowStyles);
+	LoadNamedStyles(ar, resources_->TextBoxStyles);
+	LoadNamedStyles(ar, resources_->TileGridStyles);
+	LoadNamedStyles(ar, resources_->GaugeStyles);
+
+	int32 numRootWindows = 0;
+	ar << numRootWindows;
+	if (ar.IsError() || numRootWindows < 0 || numRootWindows > numControls) {
+		UE_LOG(LogHUD, Error, TEXT("RestoreSnapshot: Snapshot is corrupt (%d root windows, %d controls)."), numRootWindows, numControls);
+		return;
+	}
+	rootWindows_.Reserve(numRootWindows);
+	for (int32 i = 0; i < numRootWindows; i++) {
+		if (LoadControl(ar, nullptr) == nullptr) {
+			UE_LOG(LogHUD, Error, TEXT("RestoreSnapshot: Snapshot is truncated or corrupt after %d controls."), controlMap_.Num());
+			// Every control read so far was already attached & registered. Leave the HUD empty rather than
+			// half built, so that another snapshot can be restored.
+			DeleteAllControls();
+			return;
+		}
+	}
+	error = false;
+}
+
+void AHotHud::SaveControl(FArchive& ar, HotHudControl* control) {
+	uint8 type = (uint8)control->Type();
+	FName name = control->Name();
+	FControlGeometry geometry = control->Geometry();
+	ar << type << name;
+	SerializeGeometry(ar, geometry);
+
+	// Whatever the constructor needs.
+	switch (control->Type()) {
+	case HotHudControl_Window: {
+		HotHudWindow* window = static_cast<HotHudWindow*>(control);
+		FString title = window->Title();
+		SaveStyle(ar, window->Style());
+		ar << title;
+		break;
+	}
+	case HotHudControl_TextBox: {
+		HotHudTextBox* textBox = static_cast<HotHudTextBox*>(control);
+		bool editable = textBox->IsEditable();
+		SaveStyle(ar, textBox->Style());
+		ar << editable;
+		break;
+	}
+	case HotHudControl_Label:
+		SaveStyle(ar, static_cast<HotHudLabel*>(control)->Style());
+		break;
+	case HotHudControl_Gauge:
+		SaveStyle(ar, static_cast<HotHudGauge*>(control)->Style());
+		break;
+	case HotHudControl_TileGrid:
+		SaveStyle(ar, static_cast<HotHudTileGrid*>(control)->Style());
+		break;
+	default:
+		break;
+	}
+	control->SerializeState(this, ar);
+
+	// Tiles of a grid driven by a data source are rebuilt by the source once it is bound again.
+	bool skipChildren = control->Type() == HotHudControl_TileGrid && static_cast<HotHudTileGrid*>(control)->DataSource() != nullptr;
+	int32 numChildren = skipChildren ? 0 : control->Children().Num();
+	ar << numChildren;
+	for (int32 i = 0; i < numChildren; i++) {
+		SaveControl(ar, control->Children()[i]);
+	}
+}
+
+HotHudControl* AHotHud::LoadControl(FArchive& ar, HotHudControl* parent) {
+	uint8 type = 0;
+	FName name;
+	FControlGeometry geometry;
+	ar << type << name;
+	SerializeGeometry(ar, geometry);
+	if (ar.IsError() || controlMap_.Contains(name)) {
+		return nullptr;
+	}
+	// Same placement rules as the Create functions: windows at the root, tiles only in grids.
+	bool parentIsGrid = parent != nullptr && parent->Type() == HotHudControl_TileGrid;
+	if ((parent == nullptr && type != HotHudControl_Window) || (type == HotHudControl_Tile) != parentIsGrid) {
+		return nullptr;
+	}
+
+	HotHudControl* control = nullptr;
+	switch (type) {
+	case HotHudControl_Window: {
+		TSharedRef<HotHudWindowStyle> style = LoadStyle(ar, resources_->WindowStyles);
+		FString title;
+		ar << title;
+		control = new HotHudWindow(name, parent, geometry, style, title, false);
+		break;
+	}
+	case HotHudControl_TextBox: {
+		TSharedRef<HotHudTextBoxStyle> style = LoadStyle(ar, resources_->TextBoxStyles);
+		bool editable = false;
+		ar << editable;
+		control = new HotHudTextBox(name, parent, geometry, style, FString(), editable);
+		break;
+	}
+	case HotHudControl_Label:
+		control = new HotHudLabel(name, parent, geometry, LoadStyle(ar, resources_->TextBoxStyles), FString());
+		break;
+	case HotHudControl_Gauge:
+		control = new HotHudGauge(name, parent, geometry, LoadStyle(ar, resources_->GaugeStyles));
+		break;
+	case HotHudControl_TileGrid:
+		control = new HotHudTileGrid(name, parent, geometry, LoadStyle(ar, resources_->TileGridStyles));
+		break;
+	case HotHudControl_Tile:
+		control = new HotHudTile(name, parent, geometry);
+		break;
+	default:
+		return nullptr;
+	}
+	// Scroll offsets are read before the children are added, so they are placed scrolled.
+	control->SerializeState(this, ar);
+	if (parent != nullptr) {
+		parent->AddChildControl(control);
+	}
+	else {
+		rootWindows_.Add(static_cast<HotHudWindow*>(control));
+	}
+	RegisterControl(control);
+
+	int32 numChildren = 0;
+	ar << numChildren;
+	if (ar.IsError() || numChildren < 0) {
+		return nullptr;
+	}
+	for (int32 i = 0; i < numChildren; i++) {
+		if (LoadControl(ar, control) == nullptr) {
+			return nullptr;
+		}
+	}
+	return ar.IsError() ? nullptr : control;
+}
+
+void AHotHud::CollectTreeProblems(TArray<FString>& problems) {
+	for (const auto& entry : controlMap_) {
+		if (entry.Key != entry.Value->Name()) {
+			problems.Add(FString::Printf(TEXT("'%s' is mapped as '%s'."), *entry.Value->Name().ToString(), *entry.Key.ToString()));
+		}
+	}
+
+	TSet<HotHudControl*> visited;
+	TArray<HotHudControl*> stack;
+	for (HotHudWindow* window : rootWindows_) {
+		if (window->Parent() != nullptr) {
+			problems.Add(FString::Printf(TEXT("Root window '%s' has a parent."), *window->Name().ToString()));
+		}
+		stack.Push(window);
+	}
+	while (stack.Num() > 0) {
+		HotHudControl* control = stack.Pop();
+		bool alreadyVisited;
+		visited.Add(control, &alreadyVisited);
+		if (alreadyVisited) {
+			problems.Add(FString::Printf(TEXT("'%s' is reachable more than once."), *control->Name().ToString()));
+			continue;
+		}
+		HotHudControl** mapped = controlMap_.Find(control->Name());
+		if (mapped == nullptr || *mapped != control) {
+			problems.Add(FString::Printf(TEXT("'%s' is in the tree but not in the control map."), *control->Name().ToString()));
+		}
+
+		// Tiles are positioned by their grid's (lazy) layout rather than from their geometry.
+		if (control->Type() != HotHudControl_Tile) {
+			FVector2D expected = control->Geometry().Location;
+			HotHudControl* parent = control->Parent();
+			if (parent != nullptr) {
+				expected += parent->ScreenCoords() + FVector2D(parent->ChildOffsetLeft(), parent->ChildOffsetTop()) - parent->ScrollOffset();
+			}
+			const FVector2D& actual = control->ScreenCoords();
+			if (!FMath::IsFinite(actual.X) || !FMath::IsFinite(actual.Y) || !actual.Equals(expected, 0.01f)) {
+				problems.Add(FString::Printf(TEXT("'%s' is at %s, expected %s."), *control->Name().ToString(), *actual.ToString(), *expected.ToString()));
+			}
+		}
+
+		const TArray<HotHudControl*>& children = control->Children();
+		for (int32 i = 0; i < children.Num(); i++) {
+			HotHudControl* child = children[i];
+			if (child->Parent() != control) {
+				problems.Add(FString::Printf(TEXT("'%s' is a child of '%s' but not parented to it."), *child->Name().ToString(), *control->Name().ToString()));
+			}
+			if (control->Type() == HotHudControl_TileGrid) {
+				if (child->Type() != HotHudControl_Tile) {
+					problems.Add(FString::Printf(TEXT("TileGrid '%s' holds non-tile '%s'."), *control->Name().ToString(), *child->Name().ToString()));
+				}
+				else if (static_cast<HotHudTile*>(child)->SlotIndex() != i) {
+					problems.Add(FString::Printf(TEXT("Tile '%s' is in slot %d but numbered %d."), *child->Name().ToString(), i, static_cast<HotHudTile*>(child)->SlotIndex()));
+				}
+			}
+			else if (child->Type() == HotHudControl_Tile) {
+				problems.Add(FString::Printf(TEXT("Tile '%s' is outside of a TileGrid."), *child->Name().ToString()));
+			}
+			stack.Push(child);
+		}
+	}
+
+	if (visited.Num() != controlMap_.Num()) {
+		for (const auto& entry : controlMap_) {
+			if (!visited.Contains(entry.Value)) {
+				problems.Add(FString::Printf(TEXT("'%s' is in the control map but not reachable from a root window."), *entry.Key.ToString()));
+			}
+		}
+	}
+}
+
+void AHotHud::ValidateControlTree(bool& error) {
+	TArray<FString> problems;
+	CollectTreeProblems(problems);
+	for (const FString& problem : problems) {
+		UE_LOG(LogHUD, Error, TEXT("ValidateControlTree: %s"), *problem);
+	}
+	error = problems.Num() > 0;
+}
+
+void AHotHud::StartSoak(int32 seed, int32 numOperations, int32 operationsPerFrame, bool& error) {
+	if (soak_ != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("StartSoak: A soak is already running."));
+		error = true;
+		return;
+	}
+	if (controlMap_.Num() > 0 || treeOwner_.IsValid()) {
+		UE_LOG(LogHUD, Error, TEXT("StartSoak: The HUD already has (or shows) controls."));
+		error = true;
+		return;
+	}
+	if (numOperations < 1 || operationsPerFrame < 1) {
+		UE_LOG(LogHUD, Error, TEXT("StartSoak: Can't run %d operations, %d per frame."), numOperations, operationsPerFrame);
+		error = true;
+		return;
+	}
+
+	soak_ = new HotHudSoakState(seed, numOperations, operationsPerFrame);
+	FHotHudMemoryStats stats;
+	GetMemoryStats(stats);
+	soak_->Report.TrackedBytesStart = stats.TotalBytes;
+	soak_->Report.TrackedBytesPeak = stats.TotalBytes;
+	soak_->StartProcessBytes = FPlatformMemory::GetStats().UsedPhysical;
+	error = false;
+}
+
+void AHotHud::StopSoak(FHotHudSoakReport& report) {
+	if (soak_ == nullptr) {
+		report = FHotHudSoakReport();
+		return;
+	}
+	FinishSoak(report);
+}
+
+void AHotHud::RunSoak(int32 seed, int32 numOperations, int32 operationsPerFrame, FHotHudSoakReport& report, bool& error) {
+	StartSoak(seed, numOperations, operationsPerFrame, error);
+	if (error) {
+		report = FHotHudSoakReport();
+		return;
+	}
+	// The run always finishes: every step runs at least one operation.
+	for (;;) {
+		double stepStart = FPlatformTime::Seconds();
+		StepSoak();
+		StepLogic();
+		if (EndSoakFrame((FPlatformTime::Seconds() - stepStart) * 1000.0, report)) {
+			break;
+		}
+	}
+}
+
+void AHotHud::StepSoak() {
+	int32 count = FMath::Min(soak_->OperationsPerFrame, soak_->OperationsLeft);
+	for (int32 i = 0; i < count; i++) {
+		RunSoakOperation(*soak_);
+	}
+	soak_->OperationsLeft -= count;
+	soak_->Report.OperationsRun += count;
+}
+
+HotHudControl* AHotHud::PickSoakControl(HotHudSoakState& soak, TArray<FName>& names) {
+	while (names.Num() > 0) {
+		int32 index = soak.Random.RandHelper(names.Num());
+		HotHudControl** control = controlMap_.Find(names[index]);
+		if (control != nullptr) {
+			return *control;
+		}
+		names.RemoveAtSwap(index);
+	}
+	return nullptr;
+}
+
+void AHotHud::RunSoakOperation(HotHudSoakState& soak) {
+	FRandomStream& random = soak.Random;
+	bool error;
+	FName nameThru;
+	bool full = controlMap_.Num() >= kSoakMaxControls;
+
+	// Children are sized to fit their parent's client area so they're never clamped.
+	FControlGeometry geometry;
+	HotHudControl* parent = PickSoakControl(soak, soak.Windows);
+	int32 clientWidth = 1920;
+	int32 clientHeight = 1080;
+	if (parent != nullptr) {
+		clientWidth = FMath::Max(16, parent->Geometry().Width - parent->ChildOffsetLeft() - parent->ChildOffsetRight());
+		clientHeight = FMath::Max(16, parent->Geometry().Height - parent->ChildOffsetTop() - parent->ChildOffsetBottom());
+	}
+	geometry.Width = random.RandRange(16, clientWidth);
+	geometry.Height = random.RandRange(16, clientHeight);
+	// Some children are placed past the client area to exercise scrolling.
+	geometry.Location = FVector2D(random.RandRange(0, clientWidth + clientWidth / 2), random.RandRange(0, clientHeight + clientHeight / 2));
+
+	int32 roll = random.RandHelper(100);
+	if (roll < 8 && !full) {
+		FManagedWindowBuildOptions options;
+		options.Title = FString::Printf(TEXT("Soak %d"), soak.NextName);
+		FName name(TEXT("SoakWindow"), ++soak.NextName);
+		bool root = parent == nullptr || random.FRand() < 0.3f;
+		if (root) {
+			geometry.Width = random.RandRange(100, 800);
+			geometry.Height = random.RandRange(100, 600);
+			geometry.Location = FVector2D(random.RandRange(0, 1920 - geometry.Width), random.RandRange(0, 1080 - geometry.Height));
+		}
+		CreateManagedWindow(name, root ? NAME_None : parent->Name(), geometry, options, nameThru, error);
+		soak.Windows.Add(name);
+	}
+	else if (roll < 18 && !full && parent != nullptr) {
+		FTextBoxBuildOptions options;
+		options.Editable = random.FRand() < 0.5f;
+		FName name(TEXT("SoakTextBox"), ++soak.NextName);
+		CreateTextBox(name, parent->Name(), geometry, options, nameThru, error);
+		soak.TextBoxes.Add(name);
+	}
+	else if (roll < 24 && !full && parent != nullptr) {
+		FTileGridBuildOptions options;
+		options.TileWidth = random.RandRange(16, 64);
+		options.TileHeight = options.TileWidth;
+		FName name(TEXT("SoakTileGrid"), ++soak.NextName);
+		CreateTileGrid(name, parent->Name(), geometry, options, nameThru, error);
+		soak.TileGrids.Add(name);
+	}
+	else if (roll < 36 && !full) {
+		HotHudControl* grid = PickSoakControl(soak, soak.TileGrids);
+		if (grid != nullptr) {
+			// Mostly a handful of tiles, sometimes a whole inventory at once.
+			int32 count = (random.FRand() < 0.05f) ? random.RandRange(500, 2000) : random.RandRange(1, 64);
+			TArray<FName> tileNames;
+			tileNames.Reserve(count);
+			for (int32 i = 0; i < count; i++) {
+				tileNames.Add(FName(TEXT("SoakTile"), ++soak.NextName));
+			}
+			AddTilesToTileGrid(grid->Name(), tileNames, error);
+		}
+	}
+	else if (roll < 66) {
+		HotHudControl* textBox = PickSoakControl(soak, soak.TextBoxes);
+		if (textBox != nullptr) {
+			int32 length = random.RandRange(0, 200);
+			FString line;
+			line.Reserve(length);
+			for (int32 i = 0; i < length; i++) {
+				line.AppendChar((random.FRand() < 0.15f) ? TEXT(' ') : (TCHAR)random.RandRange('!', '~'));
+			}
+			PrintLineToTextBox(textBox->Name(), line, error);
+		}
+	}
+	else if (roll < 78) {
+		// Moves a window the way a mouse drag does, or tweens it.
+		HotHudControl* window = PickSoakControl(soak, soak.Windows);
+		if (window != nullptr) {
+			FVector2D location(random.RandRange(0, 1600), random.RandRange(0, 900));
+			if (random.FRand() < 0.8f) {
+				window->MoveToRelative(location);
+				InvalidateHover();
+			}
+			else {
+				TweenControlPosition(window->Name(), location, random.FRandRange(0.05f, 0.5f), EHotHudEasing::Linear, error);
+			}
+		}
+	}
+	else if (roll < 86) {
+		HotHudControl* grid = PickSoakControl(soak, soak.TileGrids);
+		if (grid != nullptr && grid->Children().Num() > 1) {
+			int32 numTiles = grid->Children().Num();
+			MoveTileInTileGrid(grid->Name(), random.RandHelper(numTiles), random.RandHelper(numTiles), error);
+		}
+	}
+	else if (roll < 99 || full) {
+		// Deletes a tile, or a control along with everything under it.
+		HotHudControl* victim = nullptr;
+		int32 kind = random.RandHelper(4);
+		if (kind == 0) {
+			HotHudControl* grid = PickSoakControl(soak, soak.TileGrids);
+			if (grid != nullptr && grid->Children().Num() > 0) {
+				victim = grid->Children()[random.RandHelper(grid->Children().Num())];
+			}
+		}
+		else {
+			victim = PickSoakControl(soak, kind == 1 ? soak.Windows : (kind == 2 ? soak.TextBoxes : soak.TileGrids));
+		}
+		if (victim != nullptr) {
+			DeleteControl(victim->Name(), error);
+		}
+	}
+	else {
+		// Closing every screen at once.
+		DeleteAllControls();
+	}
+}
+
+bool AHotHud::EndSoakFrame(double frameMs, FHotHudSoakReport& report) {
+	HotHudSoakState& soak = *soak_;
+	soak.FrameTimesMs.Add((float)frameMs);
+	soak.Report.FramesRun++;
+	soak.Report.PeakControls = FMath::Max(soak.Report.PeakControls, controlMap_.Num());
+
+	bool done = soak.OperationsLeft <= 0;
+	// Counted in the soak's own frames, as a run without drawing doesn't advance GFrameCounter.
+	if (done || soak.Report.FramesRun % kSoakValidateInterval == 0) {
+		TArray<FString> problems;
+		CollectTreeProblems(problems);
+		for (const FString& problem : problems) {
+			UE_LOG(LogHUD, Error, TEXT("Soak (seed %d, operation %d): %s"), soak.Report.Seed, soak.Report.OperationsRun, *problem);
+		}
+		soak.Report.InvariantViolations += problems.Num();
+		done |= problems.Num() > 0;
+
+		FHotHudMemoryStats stats;
+		GetMemoryStats(stats);
+		soak.Report.TrackedBytesPeak = FMath::Max(soak.Report.TrackedBytesPeak, stats.TotalBytes);
+	}
+	if (done) {
+		FinishSoak(report);
+	}
+	return done;
+}
+
+// Value at Fraction of the way through Sorted (nearest rank).
+static float Percentile(const TArray<float>& sorted, float fraction) {
+	if (sorted.Num() == 0) {
+		return 0.0f;
+	}
+	int32 index = FMath::Clamp(FMath::CeilToInt(fraction * sorted.Num()) - 1, 0, sorted.Num() - 1);
+	return sorted[index];
+}
+
+void AHotHud::FinishSoak(FHotHudSoakReport& report) {
+	HotHudSoakState* soak = soak_;
+	soak_ = nullptr;
+
+	// An inconsistent tree is left as it is for inspection; deleting it could well crash.
+	if (soak->Report.InvariantViolations == 0) {
+		DeleteAllControls();
+	}
+	soak->FrameTimesMs.Sort();
+	report = soak->Report;
+	report.FrameMsP50 = Percentile(soak->FrameTimesMs, 0.5f);
+	report.FrameMsP99 = Percentile(soak->FrameTimesMs, 0.99f);
+	report.FrameMsMax = soak->FrameTimesMs.Num() > 0 ? soak->FrameTimesMs.Last() : 0.0f;
+	FHotHudMemoryStats stats;
+	GetMemoryStats(stats);
+	report.TrackedBytesEnd = stats.TotalBytes;
+	report.ProcessKBGrowth = (int32)(((int64)FPlatformMemory::GetStats().UsedPhysical - (int64)soak->StartProcessBytes) / 1024);
+	delete soak;
+
+	UE_LOG(LogHUD, Log, TEXT("Soak (seed %d): %d operations over %d frames, %d invariant violations, peak %d controls. ")
+		TEXT("Frame ms p50 %.3f p99 %.3f max %.3f. Tracked bytes %d -> %d (peak %d), process growth %d KB."),
+		report.Seed, report.OperationsRun, report.FramesRun, report.InvariantViolations, report.PeakControls,
+		report.FrameMsP50, report.FrameMsP99, report.FrameMsMax,
+		report.TrackedBytesStart, report.TrackedBytesEnd, report.TrackedBytesPeak, report.ProcessKBGrowth);
+	ReceiveSoakFinished(report);
+}
+
+void AHotHud::SetTraceCategoryEnabled(TEnumAsByte<EHotHudTraceCategory::Type> category, bool enabled) {
+	HotHudTrace::SetEnabled((HotHudTraceCategory)category.GetValue(), enabled);
+}
+
+void AHotHud::DumpTrace(const FString& fileName, bool& error) {
+	error = false;
+	if (fileName.IsEmpty()) {
+		HotHudTrace::Dump(*GLog);
+		return;
+	}
+	FStringOutputDevice out;
+	out.SetAutoEmitLineTerminator(true);
+	HotHudTrace::Dump(out);
+	FString path = FPaths::IsRelative(fileName) ? FPaths::Combine(*FPaths::GameSavedDir(), *fileName) : fileName;
+	if (!FFileHelper::SaveStringToFile(out, *path)) {
+		UE_LOG(LogHUD, Error, TEXT("DumpTrace(%s): Unable to write %s."), *fileName, *path);
+		error = true;
+	}
+}
+
+void AHotHud::StartDrawCapture(const FString& fileName, int32 numFrames, bool& error) {
+	if (capture_ != nullptr) {
+		UE_LOG(LogHUD, Error, TEXT("StartDrawCapture(%s): A capture to %s is already running."), *fileName, *capture_->Path());
+		error = true;
+		return;
+	}
+	if (numFrames < 1) {
+		UE_LOG(LogHUD, Error, TEXT("StartDrawCapture(%s): Can't capture %d frames."), *fileName, numFrames);
+		error = true;
+		return;
+	}
+	FString path = FPaths::IsRelative(fileName) ? FPaths::Combine(*FPaths::GameSavedDir(), *fileName) : fileName;
+	capture_ = new HotHudDrawCapture(path, numFrames);
+	error = false;
+}
+
+void AHotHud::StopDrawCapture() {
+	if (capture_ == nullptr) {
+		return;
+	}
+	if (!capture_->Write()) {
+		UE_LOG(LogHUD, Error, TEXT("StopDrawCapture: Unable to write %s."), *capture_->Path());
+	}
+	delete capture_;
+	capture_ = nullptr;
+}
+
+void AHotHud::GetWorkStats(FHotHudWorkStats& stats) {
+	stats = workStats_;
+}
+
+bool AHotHud::DeferWork(HotHudControl* control, HotHudWorkType work, HotHudWorkPriority priority) {
+	// Work items are looked up by name when run, so they go to the HUD which owns the control.
+	if (treeOwner_.IsValid()) {
+		return treeOwner_->DeferWork(control, work, priority);
+	}
+	if (WorkBudgetMs <= 0.0f) {
+		return false;
+	}
+	for (int32 i = 0; i <= priority; i++) {
+		if (control->IsWorkQueued(work, (HotHudWorkPriority)i)) {
+			return true;
+		}
+	}
+	control->SetWorkQueued(work, priority);
+	HotHudWorkItem item;
+	item.Control = control->Name();
+	item.Type = work;
+	workQueues_[priority].Add(item);
+	return true;
+}
+
+void AHotHud::RunDeferredWork() {
+	// Work parked for hidden controls goes back in the queue once they're shown (or is dropped once they're gone).
+	if (parkedWorkGeneration_ != HotHudControl::ShownGeneration()) {
+		parkedWorkGeneration_ = HotHudControl::ShownGeneration();
+		for (int32 priority = 0; priority < HotHudWorkPriority_NumPriorities; priority++) {
+			TArray<HotHudWorkItem>& parked = parkedWork_[priority];
+			for (int32 i = parked.Num() - 1; i >= 0; i--) {
+				HotHudControl** control = controlMap_.Find(parked[i].Control);
+				if (control == nullptr || (*control)->IsShownInTree()) {
+					if (control != nullptr) {
+						workQueues_[priority].Add(parked[i]);
+					}
+					parked.RemoveAtSwap(i);
+				}
+			}
+		}
+	}
+
+	double startTime = FPlatformTime::Seconds();
+	double deadline = startTime + WorkBudgetMs / 1000.0;
+	int32 itemsRun = 0;
+	bool outOfTime = false;
+	for (int32 priority = 0; priority < HotHudWorkPriority_NumPriorities && !outOfTime; priority++) {
+		TArray<HotHudWorkItem>& queue = workQueues_[priority];
+		int32& head = workQueueHeads_[priority];
+		while (head < queue.Num()) {
+			// Always make some progress, however small the budget.
+			if (itemsRun > 0 && FPlatformTime::Seconds() >= deadline) {
+				outOfTime = true;
+				break;
+			}
+			HotHudWorkItem item = queue[head++];
+			HotHudControl** control = controlMap_.Find(item.Control);
+			// Skip entries for deleted controls and ones already run at a higher priority.
+			if (control == nullptr || !(*control)->IsWorkQueued(item.Type, (HotHudWorkPriority)priority)) {
+				continue;
+			}
+			// Stays marked as queued while parked, so it isn't queued twice.
+			if (!(*control)->IsShownInTree()) {
+				parkedWork_[priority].Add(item);
+				continue;
+			}
+			if ((*control)->RunDeferredWork(this, Canvas, item.Type)) {
+				(*control)->ClearQueuedWork(item.Type);
+			}
+			else {
+				queue.Add(item);
+			}
+			itemsRun++;
+		}
+		if (head >= queue.Num()) {
+			queue.Reset();
+			head = 0;
+		}
+	}
+
+	workStats_.LastFrameItemsRun = itemsRun;
+	workStats_.LastFrameTimeMs = (float)((FPlatformTime::Seconds() - startTime) * 1000.0);
+	workStats_.TotalItemsRun += itemsRun;
+	workStats_.PendingVisible = workQueues_[HotHudWorkPriority_Visible].Num() - workQueueHeads_[HotHudWorkPriority_Visible];
+	workStats_.PendingNormal = workQueues_[HotHudWorkPriority_Normal].Num() - workQueueHeads_[HotHudWorkPriority_Normal];
+	workStats_.PendingPrefetch = workQueues_[HotHudWorkPriority_Prefetch].Num() - workQueueHeads_[HotHudWorkPriority_Prefetch];
+	if (outOfTime) {
+		workStats_.FramesWithDeferredWork++;
+	}
+}
+
+void AHotHud::ApplyTrimPolicies(int64 budgetBytes, FHotHudMemoryStats& stats) {
+	// Cheapest to rebuild first: cached layouts & unused atlas entries only cost a re-layout / re-copy.
+	resources_->GlyphRunCache.Empty();
+	resources_->WindowStyles.Trim();
+	resources_->TextBoxStyles.Trim();
+	resources_->TileGridStyles.Trim();
+	resources_->GaugeStyles.Trim();
+	if (resources_->TileAtlas != nullptr) {
+		resources_->TileAtlas->EvictUnreferenced();
+	}
+	GetMemoryStats(stats);
+	if (stats.TotalBytes <= budgetBytes) {
+		return;
+	}
+
+	// Then the images of tiles which haven't been drawn lately (hidden windows, grids scrolled away..);
+	// they're fetched again if the tile is drawn.
+	uint64 idleFrames = (uint64)FMath::Max(TileReleaseIdleFrames, 0);
+	int32 released = 0;
+	for (auto it = controlMap_.CreateConstIterator(); it; ++it) {
+		if (it.Value()->Type() == HotHudControl_Tile) {
+			HotHudTile* tile = static_cast<HotHudTile*>(it.Value());
+			if (tile != controlBeingDragged_ && tile->LastDrawnFrame() + idleFrames < GFrameCounter) {
+				tile->ReleaseTileData(this);
+				released++;
+			}
+		}
+	}
+	if (released > 0) {
+		if (resources_->TileAtlas != nullptr) {
+			resources_->TileAtlas->EvictUnreferenced();
+		}
+		GetMemoryStats(stats);
+		if (stats.TotalBytes <= budgetBytes) {
+			return;
+		}
+	}
+
+	// Last, scrollback - the only policy which loses data.
+	for (auto it = controlMap_.CreateConstIterator(); it; ++it) {
+		if (it.Value()->Type() == HotHudControl_TextBox) {
+			static_cast<HotHudTextBox*>(it.Value())->TrimScrollback(FMath::Max(MinScrollbackRows, 0));
+		}
+	}
+	GetMemoryStats(stats);
+}
+
+HotHudInputEvent& AHotHud::QueueInput(HotHudInputEvent::EventType type, const FVector2D& location) {
+	mouseLocation_ = location;
+	// Only the latest position matters between two other events.
+	if (type == HotHudInputEvent::MouseMove && pendingInput_.Num() > 0 && pendingInput_.Last().Type == HotHudInputEvent::MouseMove) {
+		pendingInput_.Last().Location = location;
+		return pendingInput_.Last();
+	}
+	HotHudInputEvent& event = pendingInput_[pendingInput_.AddDefaulted()];
+	event.Type = type;
+	event.Location = location;
+	event.WheelDelta = 0;
+	event.Char = 0;
+	return event;
+}
+
+void AHotHud::DispatchInput() {
+	if (pendingInput_.Num() == 0) {
+		// Controls changed under a stationary mouse.
+		UpdateHover(mouseLocation_);
+		return;
+	}
+
+	for (int32 i = 0; i < pendingInput_.Num(); i++) {
+		const HotHudInputEvent& event = pendingInput_[i];
+		switch (event.Type) {
+		case HotHudInputEvent::MouseMove:
+			UpdateHover(event.Location);
+			// Child controls are constrained to their parent, so only root windows follow the mouse.
+			if (controlBeingMoved_ != nullptr && controlBeingMoved_->Parent() == nullptr) {
+				controlBeingMoved_->MoveToRelative(event.Location - mouseControlOffset_);
+			}
+			if (scrollbarDragWindow_ != nullptr) {
+				float position = scrollbarDragVertical_ ? event.Location.Y : event.Location.X;
+				scrollbarDragWindow_->DragScrollbar(scrollbarDragVertical_, position - scrollbarGrabOffset_);
+				InvalidateHover();
+			}
+			break;
+		case HotHudInputEvent::ButtonDown:
+			UpdateHover(event.Location);
+			HandleLeftButtonDown(event.Location);
+			break;
+		case HotHudInputEvent::ButtonUp:
+			UpdateHover(event.Location);
+			HandleLeftButtonUp();
+			break;
+		case HotHudInputEvent::Wheel:
+			UpdateHover(event.Location);
+			for (HotHudControl* control = controlBeingHovered_; control != nullptr; control = control->Parent()) {
+				if (control->OnMouseWheel(event.WheelDelta)) {
+					break;
+				}
+			}
+			// A window may have scrolled other controls under the mouse.
+			InvalidateHover();
+			break;
+		case HotHudInputEvent::Key:
+			for (HotHudControl* control = focusedControl_; control != nullptr; control = control->Parent()) {
+				if (control->OnKeyDown(event.Key)) {
+					break;
+				}
+			}
+			break;
+		case HotHudInputEvent::Character:
+			if (focusedControl_ != nullptr) {
+				focusedControl_->OnCharacter(event.Char);
+			}
+			break;
+		}
+	}
+	pendingInput_.Reset();
+}
+
+void AHotHud::UpdateHover(const FVector2D& location) {
+	if (!hoverDirty_ && location == hoverLocation_) {
+		return;
+	}
+	hoverDirty_ = false;
+	hoverLocation_ = location;
+
+	// Figure out which control is currently under the mouse and if it's different from
+	// the last time we checked.
+	HotHudControl* controlUnderMouse = FindTopMostControlAt(location);
+	if (controlUnderMouse != controlBeingHovered_) {
+		// Notify any previously hovered control it's no longer hovered over
+		if (controlBeingHovered_ != nullptr) {
+			HOTHUD_TRACE_EVENT(HotHudTrace_Hover, HotHudTraceEvent_HoverEnd, controlBeingHovered_->Name());
+			controlBeingHovered_->SetIsHovered(false);
+		}
+
+		// Invalidate drag & drop target validity state.
+		dragDropTargetValid_ = false;
+
+		// Notify the newly hovered control and do drag & drop checks.
+		if (controlUnderMouse != nullptr) {
+			controlUnderMouse->SetIsHovered(true);
+			HOTHUD_TRACE_EVENT(HotHudTrace_Hover, HotHudTraceEvent_HoverBegin, controlUnderMouse->Name());
+			if (controlBeingDragged_ != nullptr) {
+				// Clear out any drag state left on the last hovered control.
+				if (controlBeingHovered_ != nullptr) {
+					controlBeingHovered_->SetValidDragSource(nullptr);
+				}
+
+				dragDropTargetValid_ = ValidateDropTarget(controlUnderMouse);
+				if (dragDropTargetValid_) {
+					controlUnderMouse->SetValidDragSource(controlBeingDragged_);
+				}
+				else {
+					controlUnderMouse->SetValidDragSource(nullptr);
+				}
+			}
+		}
+		// 
+		controlBeingHovered_ = controlUnderMouse;
+	}
+}
+
+void AHotHud::HandleLeftButtonDown(const FVector2D& location) {
+	// Clicks hand keyboard focus to the nearest focusable control (or take it away).
+	HotHudControl* focusTarget = controlBeingHovered_;
+	while (focusTarget != nullptr && !focusTarget->IsFocusable()) {
+		focusTarget = focusTarget->Parent();
+	}
+	SetFocusedControl(focusTarget);
+
+	// Presses on a scrollbar scroll the window rather than moving it.
+	if (controlBeingHovered_ != nullptr && controlBeingHovered_->Type() == HotHudControl_Window) {
+		HotHudWindow* window = static_cast<HotHudWindow*>(controlBeingHovered_);
+		if (window->PressScrollbar(location, scrollbarDragVertical_, scrollbarGrabOffset_)) {
+			scrollbarDragWindow_ = window;
+			InvalidateHover();
+			return;
+		}
+	}
+
+	if (controlBeingHovered_ != nullptr) {
+		if (controlBeingHovered_->IsMovable()) {
+			// Begin movable control move.
+			controlBeingHovered_->SetIsMoving(true);
+			controlBeingMoved_ = controlBeingHovered_;
+			mouseControlOffset_ = location - controlBeingMoved_->ScreenCoords();
+			HOTHUD_TRACE_EVENT(HotHudTrace_Interaction, HotHudTraceEvent_MoveBegin, controlBeingMoved_->Name());
+		}
+		else if (controlBeingHovered_->IsDraggable()) {
+			// Begin draggable control drag.
+			controlBeingHovered_->SetIsDragging(true);
+			BeginDragSession(controlBeingHovered_);
+			mouseControlOffset_ = location - controlBeingDragged_->ScreenCoords();
+			HOTHUD_TRACE_EVENT(HotHudTrace_Interaction, HotHudTraceEvent_DragBegin, controlBeingDragged_->Name());
+		}
+	}
+}
+
+void AHotHud::HandleLeftButtonUp() {
+	scrollbarDragWindow_ = nullptr;
+	if (controlBeingMoved_ != nullptr) {
+		HOTHUD_TRACE_EVENT(HotHudTrace_Interaction, HotHudTraceEvent_MoveEnd, controlBeingMoved_->Name());
+		controlBeingMoved_->SetIsMoving(false);
+		controlBeingMoved_ = nullptr;
+	}
+
+	if (controlBeingDragged_ != nullptr) {
+		HOTHUD_TRACE_EVENT(HotHudTrace_Interaction, HotHudTraceEvent_DragEnd, controlBeingDragged_->Name());
+		controlBeingDragged_->SetIsDragging(false);
+		// The per HUD flag rather than the target's ValidDragSource(), which another player sharing the
+		// controls may have changed.
+		if (controlBeingHovered_ != nullptr) {
+			HOTHUD_TRACE_EVENT(HotHudTrace_Interaction, HotHudTraceEvent_Drop, controlBeingHovered_->Name(), dragDropTargetValid_ ? 1 : 0);
+		}
+		if (controlBeingHovered_ != nullptr && dragDropTargetValid_) {
+			controlBeingHovered_->NotifyOnValidDrop(this, controlBeingDragged_);
+			controlBeingHovered_->SetValidDragSource(nullptr);
+		}
+		EndDragSession();
+		// The drop may have re-arranged controls under the mouse.
+		InvalidateHover();
+	}
+}
+
+void AHotHud::DrawHUD() {
+	// Call our base DrawHUD first which will allow the blueprint layer to draw first.
+	Super::DrawHUD();
+
+	if (!localPlayerController_) {
+		localPlayerController_ = GetOwningPlayerController();
+		if (!localPlayerController_) {
+			return;
+		}
+	}
+
+	if (!localPlayerController_->PlayerInput || SupressHud || !Canvas) {
+		// Input which arrives while we're hidden is stale by the time we're shown again.
+		pendingInput_.Reset();
+		return;
+	}
+
+	double frameStart = FPlatformTime::Seconds();
+	if (soak_ != nullptr) {
+		StepSoak();
+	}
+
+	if (GFrameCounter % kGlyphRunTrimInterval == 0) {
+		resources_->Trim(kGlyphRunMaxIdleFrames);
+	}
+	// HUDs showing another HUD's controls leave the budget to it.
+	if (!treeOwner_.IsValid() && MemoryBudgetKB > 0 && GFrameCounter % kMemoryBudgetCheckInterval == 0) {
+		EnforceMemoryBudget();
+	}
+
+	// The engine has no mouse move event for HUDs, so compare the cursor against the last known
+	// location. Buttons, the wheel and keys arrive through the bindings and Input* methods.
+	BindInput();
+	FVector2D mouseLocation = PollMouseLocation();
+	if (mouseLocation != mouseLocation_) {
+		QueueInput(HotHudInputEvent::MouseMove, mouseLocation);
+	}
+	if (pendingInput_.Num() > 0 || hoverDirty_) {
+		DispatchInput();
+	}
+
+	// Bound properties are read before anything lays out or draws, so the frame shows current values.
+	StepLogic();
+
+	// Work queued while drawing the last frame.
+	RunDeferredWork();
+
+	if (capture_ != nullptr) {
+		capture_->BeginFrame(GFrameCounter);
+	}
+
+	// The viewport in control tree space.
+	bool transformed = viewportOffset_ != FVector2D::ZeroVector || viewportScale_ != 1.0f;
+	if (transformed) {
+		Canvas->Canvas->PushRelativeTransform(
+			FScaleMatrix(FVector(viewportScale_, viewportScale_, 1.0f)) * FTranslationMatrix(FVector(viewportOffset_.X, viewportOffset_.Y, 0.0f)));
+	}
+	HotHudClipRect screenClip(
+		-viewportOffset_.X / viewportScale_, -viewportOffset_.Y / viewportScale_,
+		(Canvas->ClipX - viewportOffset_.X) / viewportScale_, (Canvas->ClipY - viewportOffset_.Y) / viewportScale_);
+
+	// Draw any windows *not* being moved. Only our own move is drawn on top, other players' aren't.
+	HotHudWindow* movingWindow = nullptr;
+	for (HotHudWindow* window : TreeRootWindows()) {
+		if (!window->IsShown()) {
+			continue;
+		}
+		if (window != controlBeingMoved_) {
+			DrawWindowLayers(window, screenClip);
+		}
+		else {
+			movingWindow = window;
+		}
+	}
+
+	// If there's a window being moved then draw it on top.
+	if (movingWindow != nullptr) {
+		DrawWindowLayers(movingWindow, screenClip);
+	}
+	chromeClip_ = screenClip;
+
+	// Finally draw any dragging going on.
+	if (controlBeingDragged_ != nullptr) {
+		UTexture2D* texture = controlBeingDragged_->GetDragTexture();
+		if (texture != nullptr) {
+			FLinearColor color;
+			// TODO(san): Make this prettier.
+			if (dragDropTargetValid_) {
+				color = FLinearColor::Green;
+			}
+			else {
+				color = FLinearColor::Red;
+			}
+			FCanvasTileItem dragCursor((mouseLocation_ - mouseControlOffset_), texture->Resource, color);
+			dragCursor.BlendMode = SE_BLEND_Translucent;
+			Canvas->DrawItem(dragCursor);
+			if (capture_ != nullptr) {
+				capture_->Record(
+					HotHudCapture_Image, controlBeingDragged_, dragCursor.Position.X, dragCursor.Position.Y,
+					texture->GetSurfaceWidth(), texture->GetSurfaceHeight(), color, texture);
+			}
+		}
+	}
+	if (transformed) {
+		Canvas->Canvas->PopTransform();
+	}
+
+	if (capture_ != nullptr && capture_->EndFrame()) {
+		StopDrawCapture();
+	}
+	if (soak_ != nullptr) {
+		FHotHudSoakReport report;
+		EndSoakFrame((FPlatformTime::Seconds() - frameStart) * 1000.0, report);
+	}
+}
+
+/*****************************************************************************/
+HotHudControl::HotHudControl(
+	HotHudControlType type, const FName& name, HotHudControl* parent,
+	const FControlGeometry& geometry, bool isMovable, bool isDraggable)
+	: type_(type),
+	name_(name),
+	parent_(parent),
+	geometry_(geometry),
+	isMovable_(isMovable),
+	isDraggable_(isDraggable),
+	screenCoords_(FVector2D(0, 0)),
+	childOffsetTop_(0),
+	childOffsetRight_(0),
+	childOffsetBottom_(0),
+	childOffsetLeft_(0),
+	scrollOffset_(FVector2D::ZeroVector),
+	isMoving_(false),
+	isDragging_(false),
+	isHovered_(false),
+	isFocused_(false),
+	isVisible_(true),
+	isCollapsed_(false),
+	opacity_(1.0f),
+	styleOverrides_(nullptr),
+	queuedWork_(0),
+	validDragSource_(nullptr) {
+	RecomputeAbsolutePosition();
+}
+
+void HotHudControl::RemoveChildControl(HotHudControl* child) {
+	childControls_.Remove(child);
+}
+
+void HotHudControl::AddChildControl(HotHudControl* child) {
+	childControls_.Add(child);
+	child->RecomputeAbsolutePosition();
+
+	// Clamp the size of the child to our child viewport. Windows scroll instead.
+	int32 maxChildWidth = geometry_.Width - childOffsetLeft_ - childOffsetRight_;
+	int32 maxChildHeight = geometry_.Height - childOffsetTop_ - childOffsetBottom_;
+
+	if ((child->Geometry().Width > maxChildWidth) || (child->Geometry().Height > maxChildHeight)) {
+		UE_LOG(LogHUD, Warning, TEXT("Control %s being resized from %d,%d to %d,%d for fit to %s"),
+			*child->Name().ToString(), child->Geometry().Width, child->Geometry().Height, maxChildWidth, maxChildHeight, *name_.ToString());
+		child->Resize(maxChildWidth, maxChildHeight);
+	}
+}
+
+bool HotHudControl::ContainsCoord(const FVector2D& coord) {
+	if ((coord.X >= screenCoords_.X) && (coord.X <= (screenCoords_.X + geometry_.Width)) &&
+		(coord.Y >= screenCoords_.Y) && (coord.Y <= (screenCoords_.Y + geometry_.Height))) {
+		return true;
+	}
+	return false;
+}
+
+HotHudClipRect HotHudControl::Bounds() const {
+	return HotHudClipRect(screenCoords_.X, screenCoords_.Y, screenCoords_.X + geometry_.Width, screenCoords_.Y + geometry_.Height);
+}
+
+HotHudClipRect HotHudControl::ClientRect() const {
+	return HotHudClipRect(
+		screenCoords_.X + childOffsetLeft_, screenCoords_.Y + childOffsetTop_,
+		screenCoords_.X + geometry_.Width - childOffsetRight_, screenCoords_.Y + geometry_.Height - childOffsetBottom_);
+}
+
+HotHudControl* HotHudControl::FindTopMostControlAt(const FVector2D& location) {
+	// Fast-path check.
+	if (!ContainsCoord(location)) {
+		return nullptr;
+	}
+	// Children scrolled under the chrome (or out of view) can't be hit.
+	if (childControls_.Num() == 0 || !ClientRect().Contains(location)) {
+		return this;
+	}
+
+	HotHudControl* childHit = nullptr;
+	for (HotHudControl* child : childControls_) {
+		if (!child->IsShown()) {
+			continue;
+		}
+		childHit = child->FindTopMostControlAt(location);
+		if (childHit) {
+			break;
+		}
+	}
+
+	return childHit == nullptr ? this : childHit;
+}
+
+bool HotHudControl::IsValidMove(const FVector2D& location) {
+	// TODO(san): This is where we'd check for sub-window constraints.
+	return true;
+}
+
+void HotHudControl::Resize(int32 width, int32 height) {
+	geometry_.Width = width;
+	geometry_.Height = height;
+
+	// TODO(san): Notify children? Soon.
+}
+
+void HotHudControl::MoveToRelative(const FVector2D& location) {
+	if (IsValidMove(location)) {
+		geometry_.Location = location;
+
+		RecomputeAbsolutePosition();
+
+		for (HotHudControl* child : this->childControls_) {
+			child->MoveToRelative(child->geometry_.Location);
+		}
+	}
+}
+
+void HotHudControl::RecomputeAbsolutePosition() {
+	if (parent_ == nullptr) {
+		screenCoords_ = geometry_.Location;
+	}
+	else {
+		screenCoords_.X = parent_->ScreenCoords().X + parent_->ChildOffsetLeft() - parent_->ScrollOffset().X + geometry_.Location.X;
+		screenCoords_.Y = parent_->ScreenCoords().Y + parent_->ChildOffsetTop() - parent_->ScrollOffset().Y + geometry_.Location.Y;
+	}
+}
+
+bool HotHudControl::IsWithin(const HotHudControl* ancestor) const {
+	for (const HotHudControl* control = this; control != nullptr; control = control->parent_) {
+		if (control == ancestor) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 HotHudControl::shownGeneration_ = 0;
+
+bool HotHudControl::IsShownInTree() const {
+	for (const HotHudControl* control = this; control != nullptr; control = control->parent_) {
+		if (!control->IsShown()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void HotHudControl::SetVisible(bool visible) {
+	if (visible != isVisible_) {
+		isVisible_ = visible;
+		shownGeneration_++;
+	}
+}
+
+void HotHudControl::SetParent(HotHudControl* parent) {
+	parent_ = parent;
+	shownGeneration_++;
+}
+
+void HotHudControl::SetCollapsed(bool collapsed) {
+	if (collapsed == isCollapsed_) {
+		return;
+	}
+	isCollapsed_ = collapsed;
+	shownGeneration_++;
+	// A collapsed tile gives up its slot; the grid re-lays out the tiles after it.
+	if (type_ == HotHudControl_Tile && parent_ != nullptr && parent_->Type() == HotHudControl_TileGrid) {
+		static_cast<HotHudTileGrid*>(parent_)->OnTileCollapsedChanged();
+	}
+}
+
+float HotHudControl::EffectiveOpacity() const {
+	float opacity = opacity_;
+	for (const HotHudControl* control = parent_; control != nullptr; control = control->parent_) {
+		opacity *= control->opacity_;
+	}
+	return opacity;
+}
+
+void HotHudControl::SetStyleOverride(HotHudStyleOverride field, const FLinearColor& color) {
+	if (styleOverrides_ == nullptr) {
+		styleOverrides_ = new HotHudStyleOverrides();
+	}
+	styleOverrides_->Mask |= field;
+	if (field == HotHudStyleOverride_BackgroundColor) {
+		styleOverrides_->BackgroundColor = color;
+	}
+	else {
+		styleOverrides_->TextColor = color;
+	}
+}
+
+void HotHudControl::ClearStyleOverrides() {
+	delete styleOverrides_;
+	styleOverrides_ = nullptr;
+}
+
+int32 HotHudControl::BaseAllocatedSize() const {
+	return childControls_.GetAllocatedSize() + ((styleOverrides_ != nullptr) ? sizeof(HotHudStyleOverrides) : 0);
+}
+
+FLinearColor HotHudControl::Faded(const FLinearColor& color) const {
+	FLinearColor faded = color;
+	faded.A *= EffectiveOpacity();
+	return faded;
+}
+
+void HotHudControl::NotifyOnValidDrop(AHotHud* hud, HotHudControl* sourceControl) {
+}
+
+void HotHudControl::SerializeState(AHotHud* hud, FArchive& ar) {
+	ar << isMovable_ << isDraggable_ << opacity_ << scrollOffset_;
+	bool visible = isVisible_;
+	bool collapsed = isCollapsed_;
+	ar << visible << collapsed;
+	if (ar.IsLoading()) {
+		SetVisible(visible);
+		SetCollapsed(collapsed);
+	}
+	uint8 overrideMask = (styleOverrides_ != nullptr) ? styleOverrides_->Mask : 0;
+	ar << overrideMask;
+	if (ar.IsLoading()) {
+		ClearStyleOverrides();
+		if (overrideMask != 0) {
+			styleOverrides_ = new HotHudStyleOverrides();
+			styleOverrides_->Mask = overrideMask;
+		}
+	}
+	if (overrideMask != 0) {
+		ar << styleOverrides_->BackgroundColor << styleOverrides_->TextColor;
+	}
+}
+
+/*****************************************************************************/
+
+HotHudWindow::HotHudWindow(
+	const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+	const TSharedRef<HotHudWindowStyle>& style, const FString& title, bool isMovable)
+: HotHudControl(HotHudControl_Window, name, parent, geometry, isMovable, false),
+	style_(style),
+	styleRevision_(style->Revision),
+	title_(title),
+	contentSize_(FVector2D::ZeroVector),
+	hasHBar_(false),
+	hasVBar_(false) {
+	childOffsetLeft_ = kWindowBorderWidth;
+	childOffsetTop_ = kWindowBorderWidth + Cfg().TitleBarHeight;
+	childOffsetRight_ = childOffsetLeft_;
+	childOffsetBottom_ = childOffsetLeft_;
+}
+
+void HotHudWindow::SetStyle(const TSharedRef<HotHudWindowStyle>& style) {
+	style_ = style;
+	SyncStyle();
+}
+
+void HotHudWindow::SyncStyle() {
+	styleRevision_ = style_->Revision;
+	int32 offsetTop = kWindowBorderWidth + Cfg().TitleBarHeight;
+	if (offsetTop != childOffsetTop_) {
+		// Re-place the children below the new titlebar.
+		childOffsetTop_ = offsetTop;
+		MoveToRelative(geometry_.Location);
+	}
+}
+
+void HotHudWindow::AddChildControl(HotHudControl* child) {
+	// The content size is brought up to date (and the scroll offset clamped) on the next draw.
+	childControls_.Add(child);
+	child->RecomputeAbsolutePosition();
+}
+
+void HotHudWindow::UpdateScrollbars() {
+	contentSize_ = FVector2D::ZeroVector;
+	for (HotHudControl* child : childControls_) {
+		if (child->IsCollapsed()) {
+			continue;
+		}
+		contentSize_.X = FMath::Max(contentSize_.X, child->Geometry().Location.X + child->Geometry().Width);
+		contentSize_.Y = FMath::Max(contentSize_.Y, child->Geometry().Location.Y + child->Geometry().Height);
+	}
+
+	// Each bar takes room from the other axis, so the horizontal bar can bring on the vertical one.
+	int32 availableWidth = geometry_.Width - kWindowBorderWidth * 2;
+	int32 availableHeight = geometry_.Height - childOffsetTop_ - kWindowBorderWidth;
+	hasVBar_ = Cfg().AlwaysShowVBar || contentSize_.Y > availableHeight;
+	hasHBar_ = Cfg().AlwaysShowHBar || contentSize_.X > availableWidth - (hasVBar_ ? kScrollbarWidth : 0);
+	hasVBar_ = hasVBar_ || contentSize_.Y > availableHeight - (hasHBar_ ? kScrollbarWidth : 0);
+	childOffsetRight_ = kWindowBorderWidth + (hasVBar_ ? kScrollbarWidth : 0);
+	childOffsetBottom_ = kWindowBorderWidth + (hasHBar_ ? kScrollbarWidth : 0);
+
+	// The content may have shrunk (or the window grown) under the current offset.
+	FVector2D maxOffset(
+		FMath::Max(0.0f, contentSize_.X - (geometry_.Width - childOffsetLeft_ - childOffsetRight_)),
+		FMath::Max(0.0f, contentSize_.Y - (geometry_.Height - childOffsetTop_ - childOffsetBottom_)));
+	if (scrollOffset_.X > maxOffset.X || scrollOffset_.Y > maxOffset.Y) {
+		scrollOffset_ = FVector2D(FMath::Min(scrollOffset_.X, maxOffset.X), FMath::Min(scrollOffset_.Y, maxOffset.Y));
+		MoveToRelative(geometry_.Location);
+	}
+}
+
+void HotHudWindow::ScrollTo(const FVector2D& offset) {
+	UpdateScrollbars();
+	FVector2D clamped(
+		FMath::Clamp(offset.X, 0.0f, FMath::Max(0.0f, contentSize_.X - (geometry_.Width - childOffsetLeft_ - childOffsetRight_))),
+		FMath::Clamp(offset.Y, 0.0f, FMath::Max(0.0f, contentSize_.Y - (geometry_.Height - childOffsetTop_ - childOffsetBottom_))));
+	if (clamped != scrollOffset_) {
+		scrollOffset_ = clamped;
+		// Re-places every descendant.
+		MoveToRelative(geometry_.Location);
+	}
+}
+
+bool HotHudWindow::OnMouseWheel(float delta) {
+	FVector2D before = scrollOffset_;
+	ScrollTo(FVector2D(scrollOffset_.X, scrollOffset_.Y - delta * kWindowWheelPixels));
+	return scrollOffset_ != before;
+}
+
+bool HotHudWindow::GetScrollbarRects(bool vertical, HotHudClipRect& track, HotHudClipRect& thumb) const {
+	if (vertical ? !hasVBar_ : !hasHBar_) {
+		return false;
+	}
+	HotHudClipRect client = ClientRect();
+	float clientLength;
+	float contentLength;
+	float offset;
+	if (vertical) {
+		track = HotHudClipRect(client.MaxX, client.MinY, client.MaxX + kScrollbarWidth, client.MaxY);
+		clientLength = client.MaxY - client.MinY;
+		contentLength = contentSize_.Y;
+		offset = scrollOffset_.Y;
+	}
+	else {
+		track = HotHudClipRect(client.MinX, client.MaxY, client.MaxX, client.MaxY + kScrollbarWidth);
+		clientLength = client.MaxX - client.MinX;
+		contentLength = contentSize_.X;
+		offset = scrollOffset_.X;
+	}
+
+	float trackLength = clientLength;
+	float thumbLength = trackLength;
+	float thumbStart = 0.0f;
+	if (contentLength > clientLength && clientLength > 0.0f) {
+		thumbLength = FMath::Min(trackLength, FMath::Max((float)kScrollbarMinThumb, trackLength * clientLength / contentLength));
+		thumbStart = (trackLength - thumbLength) * offset / (contentLength - clientLength);
+	}
+	if (vertical) {
+		thumb = HotHudClipRect(track.MinX + 1, track.MinY + thumbStart, track.MaxX - 1, track.MinY + thumbStart + thumbLength);
+	}
+	else {
+		thumb = HotHudClipRect(track.MinX + thumbStart, track.MinY + 1, track.MinX + thumbStart + thumbLength, track.MaxY - 1);
+	}
+	return true;
+}
+
+bool HotHudWindow::PressScrollbar(const FVector2D& location, bool& vertical, float& grabOffset) {
+	HotHudClipRect track;
+	HotHudClipRect thumb;
+	for (int32 i = 0; i < 2; i++) {
+		vertical = (i == 0);
+		if (!GetScrollbarRects(vertical, track, thumb) || !track.Contains(location)) {
+			continue;
+		}
+		float position = vertical ? location.Y : location.X;
+		float thumbStart = vertical ? thumb.MinY : thumb.MinX;
+		float thumbLength = vertical ? thumb.MaxY - thumb.MinY : thumb.MaxX - thumb.MinX;
+		if (!thumb.Contains(location)) {
+			// Centre the thumb on the press and carry on as if it had been grabbed there.
+			thumbStart = position - thumbLength / 2;
+			DragScrollbar(vertical, thumbStart);
+		}
+		grabOffset = position - thumbStart;
+		return true;
+	}
+	return false;
+}
+
+void HotHudWindow::DragScrollbar(bool vertical, float thumbStart) {
+	HotHudClipRect track;
+	HotHudClipRect thumb;
+	if (!GetScrollbarRects(vertical, track, thumb)) {
+		return;
+	}
+	float travel = vertical ? (track.MaxY - track.MinY) - (thumb.MaxY - thumb.MinY) : (track.MaxX - track.MinX) - (thumb.MaxX - thumb.MinX);
+	if (travel <= 0.0f) {
+		return;
+	}
+	float fraction = FMath::Clamp((thumbStart - (vertical ? track.MinY : track.MinX)) / travel, 0.0f, 1.0f);
+	if (vertical) {
+		float range = contentSize_.Y - (track.MaxY - track.MinY);
+		ScrollTo(FVector2D(scrollOffset_.X, fraction * range));
+	}
+	else {
+		float range = contentSize_.X - (track.MaxX - track.MinX);
+		ScrollTo(FVector2D(fraction * range, scrollOffset_.Y));
+	}
+}
+
+void HotHudWindow::DrawScrollbars(AHotHud* hud) {
+	HotHudClipRect track;
+	HotHudClipRect thumb;
+	for (int32 i = 0; i < 2; i++) {
+		if (GetScrollbarRects(i == 0, track, thumb)) {
+			hud->DrawChromeRect(Faded(FLinearColor(0, 0, 0, 0.35f)), track.MinX, track.MinY, track.MaxX - track.MinX, track.MaxY - track.MinY);
+			hud->DrawChromeRect(Faded(FLinearColor(0.6f, 0.6f, 0.6f, 0.75f)), thumb.MinX, thumb.MinY, thumb.MaxX - thumb.MinX, thumb.MaxY - thumb.MinY);
+		}
+	}
+}
+
+void HotHudWindow::AccumulateMemoryStats(FHotHudMemoryStats& stats) const {
+	stats.WindowBytes += sizeof(HotHudWindow) + BaseAllocatedSize() + title_.GetCharArray().GetAllocatedSize();
+}
+
+void HotHudWindow::DrawBorder(AHotHud* hud) {
+	FLinearColor colorBlack(0, 0, 0, 1.0);
+	FLinearColor colorLessBlack(0, 0, 0, 0.75);
+
+	hud->DrawChromeOutline(Faded(colorBlack), screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+	hud->DrawChromeOutline(Faded(colorLessBlack), screenCoords_.X + 1, screenCoords_.Y + 1, geometry_.Width - 2, geometry_.Height - 2);
+}
+
+bool HotHudWindow::PrepareDraw() {
+	// Faded out windows and their children draw nothing.
+	if (opacity_ <= 0) {
+		return false;
+	}
+	if (styleRevision_ != style_->Revision) {
+		SyncStyle();
+	}
+	// Children may have been added, moved or resized since the last frame.
+	UpdateScrollbars();
+	return true;
+}
+
+void HotHudWindow::DrawChrome(AHotHud* hud, UCanvas* canvas) {
+	// Draw window background.
+	hud->DrawChromeRect(Faded(StyledColor(HotHudStyleOverride_BackgroundColor, Cfg().BackgroundColor)), screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+
+	// Draw window border.
+	DrawBorder(hud);
+	DrawScrollbars(hud);
+
+	// Draw titlebar (if any).
+	if (title_.Len() != 0) {
+		hud->DrawChromeRect(Faded(Cfg().TitleBarColor), screenCoords_.X + kWindowBorderWidth, screenCoords_.Y + kWindowBorderWidth, geometry_.Width - (kWindowBorderWidth * 2), Cfg().TitleBarHeight);
+	}
+}
+
+void HotHudWindow::DrawText(AHotHud* hud, UCanvas* canvas) {
+	if (title_.Len() != 0) {
+		hud->DrawCachedText(titleRun_, title_, StyledColor(HotHudStyleOverride_TextColor, Cfg().TitleTextColor), screenCoords_.X + kWindowBorderWidth, screenCoords_.Y + kWindowBorderWidth, Cfg().TitleFont, Cfg().TitleFontScale, EffectiveOpacity());
+	}
+}
+
+void HotHudWindow::Draw(AHotHud* hud, UCanvas* canvas) {
+	if (!PrepareDraw()) {
+		return;
+	}
+	DrawChrome(hud, canvas);
+	hud->FlushChrome();
+	DrawText(hud, canvas);
+	hud->FlushText();
+
+	// Draw children.
+	for (HotHudControl* child : childControls_) {
+		if (child->IsShown()) {
+			child->Draw(hud, canvas);
+		}
+	}
+}
+
+/*****************************************************************************/
+
+HotHudTextBox::HotHudTextBox(
+	const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+	const TSharedRef<HotHudTextBoxStyle>& style, const FString& text, bool editable)
+	: HotHudControl(HotHudControl_TextBox, name, parent, geometry, false, false),
+	style_(style),
+	styleRevision_(style->Revision),
+	editable_(editable),
+	numColumns_(-1),
+	numRows_(-1),
+	rowHeight_(0),
+	virtualCursorRow_(0),
+	virtualCursorColumn_(0),
+	scrollParagraph_(0),
+	scrollRow_(0),
+	caretRevision_(-1),
+	caretX_(0),
+	scrollbackOffset_(0) {
+	childOffsetLeft_ = kTextBoxBorderLeftWidth;
+	childOffsetTop_ = kTextBoxBorderTopHeight;
+	childOffsetRight_ = kTextBoxBorderRightWidth;
+	childOffsetBottom_ = kTextBoxBorderBottomHeight;
+	if (text.Len()) {
+		PrintLine(text);
+	}
+}
+
+void HotHudTextBox::SetStyle(const TSharedRef<HotHudTextBoxStyle>& style) {
+	style_ = style;
+	SyncStyle();
+}
+
+void HotHudTextBox::SyncStyle() {
+	styleRevision_ = style_->Revision;
+	// The font may have changed; re-measure and re-wrap on the next draw.
+	numColumns_ = -1;
+	numRows_ = -1;
+	caretRevision_ = -1;
+	document_.InvalidateLayout();
+}
+
+void HotHudTextBox::Resize(int32 width, int32 height) {
+	HotHudControl::Resize(width, height);
+	numColumns_ = -1;
+	numRows_ = -1;
+	caretRevision_ = -1;
+}
+
+void HotHudTextBox::Clear() {
+	rowBuffer_.Empty();
+	rowRuns_.Empty();
+	scrollbackOffset_ = 0;
+	document_.SetText(FString());
+	scrollParagraph_ = 0;
+	scrollRow_ = 0;
+	virtualCursorRow_ = 0;
+	virtualCursorColumn_ = 0;
+}
+
+void HotHudTextBox::PrintLine(const FString& line) {
+	if (editable_) {
+		document_.AppendParagraph(line);
+		return;
+	}
+	rowBuffer_.Add(line);
+	rowRuns_.AddDefaulted();
+	virtualCursorRow_++;
+	// Keep showing the same rows while scrolled back.
+	if (scrollbackOffset_ > 0) {
+		scrollbackOffset_++;
+	}
+}
+
+int32 HotHudTextBox::TrimScrollback(int32 keepRows) {
+	int32 numToDrop = rowBuffer_.Num() - keepRows;
+	if (editable_ || numToDrop <= 0) {
+		return 0;
+	}
+	rowBuffer_.RemoveAt(0, numToDrop);
+	rowRuns_.RemoveAt(0, numToDrop);
+	virtualCursorRow_ = rowBuffer_.Num();
+	scrollbackOffset_ = FMath::Min(scrollbackOffset_, FMath::Max(rowBuffer_.Num() - FMath::Max(numRows_, 0), 0));
+	return numToDrop;
+}
+
+void HotHudTextBox::AccumulateMemoryStats(FHotHudMemoryStats& stats) const {
+	stats.TextBoxBytes += sizeof(HotHudTextBox) + BaseAllocatedSize() + rowRuns_.GetAllocatedSize() + rowScratch_.GetCharArray().GetAllocatedSize();
+	int32 textBytes = rowBuffer_.GetAllocatedSize() + document_.GetAllocatedSize();
+	for (const FString& row : rowBuffer_) {
+		textBytes += row.GetCharArray().GetAllocatedSize();
+	}
+	stats.TextBytes += textBytes;
+}
+
+void HotHudTextBox::SerializeState(AHotHud* hud, FArchive& ar) {
+	HotHudControl::SerializeState(hud, ar);
+	if (editable_) {
+		FString text;
+		if (ar.IsSaving()) {
+			text = document_.GetText();
+		}
+		ar << text;
+		if (ar.IsLoading()) {
+			document_.SetText(text);
+		}
+		return;
+	}
+
+	// The archive sizes rowBuffer_ once from the stored count.
+	ar << rowBuffer_ << scrollbackOffset_;
+	if (ar.IsLoading()) {
+		rowRuns_.Empty(rowBuffer_.Num());
+		rowRuns_.AddDefaulted(rowBuffer_.Num());
+		virtualCursorRow_ = rowBuffer_.Num();
+	}
+}
+
+void HotHudTextBox::SetText(const FString& text) {
+	Clear();
+	if (editable_) {
+		document_.SetText(text);
+		return;
+	}
+	AppendText(text);
+}
+
+void HotHudTextBox::AppendText(const FString& text) {
+	if (editable_) {
+		document_.AppendParagraph(text);
+		return;
+	}
+
+	// Rows are carved out of the text in parallel for long texts, straight into their final slots.
+	TArray<int32> lineStarts;
+	HotHudFindLineStarts(*text, text.Len(), lineStarts);
+	int32 numLines = lineStarts.Num();
+	int32 firstRow = rowBuffer_.Num();
+	rowBuffer_.AddDefaulted(numLines);
+	rowRuns_.AddDefaulted(numLines);
+	const TCHAR* chars = *text;
+	int32 length = text.Len();
+	auto copyRow = [this, chars, length, firstRow, numLines, &lineStarts](int32 line) {
+		int32 lineEnd = (line + 1 < numLines) ? lineStarts[line + 1] - 1 : length;
+		rowBuffer_[firstRow + line].AppendChars(chars + lineStarts[line], lineEnd - lineStarts[line]);
+	};
+	if (length < kHotHudParallelTextMinChars) {
+		for (int32 line = 0; line < numLines; line++) {
+			copyRow(line);
+		}
+	}
+	else {
+		ParallelFor(numLines, copyRow);
+	}
+
+	virtualCursorRow_ += numLines;
+	// Keep showing the same rows while scrolled back.
+	if (scrollbackOffset_ > 0) {
+		scrollbackOffset_ += numLines;
+	}
+}
+
+FString HotHudTextBox::GetText() const {
+	if (editable_) {
+		return document_.GetText();
+	}
+	FString text;
+	for (int32 i = 0; i < rowBuffer_.Num(); i++) {
+		if (i > 0) {
+			text += TEXT("\n");
+		}
+		text += rowBuffer_[i];
+	}
+	return text;
+}
+
+void HotHudTextBox::InsertText(const FString& text) {
+	document_.Insert(*text, text.Len());
+}
+
+void HotHudTextBox::DeleteCharacter(bool forward) {
+	if (forward) {
+		document_.DeleteForward();
+	}
+	else {
+		document_.DeleteBackward();
+	}
+}
+
+void HotHudTextBox::MoveCursor(ETextBoxCursorMove::Type move) {
+	switch (move) {
+	case ETextBoxCursorMove::Left:
+		document_.MoveLeft();
+		break;
+	case ETextBoxCursorMove::Right:
+		document_.MoveRight();
+		break;
+	case ETextBoxCursorMove::Up:
+		document_.MoveUp();
+		break;
+	case ETextBoxCursorMove::Down:
+		document_.MoveDown();
+		break;
+	case ETextBoxCursorMove::Home:
+		document_.MoveHome();
+		break;
+	case ETextBoxCursorMove::End:
+		document_.MoveEnd();
+		break;
+	}
+}
+
+bool HotHudTextBox::LocateCursorRow() {
+	int32 cursorParagraph = document_.CursorParagraph();
+	int32 cursorRow;
+	document_.GetCursorRow(cursorRow, virtualCursorColumn_);
+
+	// Walk down at most a screen's worth of rows from the anchor looking for the cursor.
+	int32 paragraph = scrollParagraph_;
+	int32 row = scrollRow_;
+	int32 visibleRows = FMath::Max(numRows_, 1);
+	for (int32 i = 0; i < visibleRows && paragraph < document_.NumParagraphs(); i++) {
+		if (paragraph == cursorParagraph && row == cursorRow) {
+			virtualCursorRow_ = i;
+			return true;
+		}
+		if (++row >= document_.NumRows(paragraph)) {
+			paragraph++;
+			row = 0;
+		}
+	}
+	virtualCursorRow_ = visibleRows;
+	return false;
+}
+
+void HotHudTextBox::ScrollToCursor() {
+	int32 cursorParagraph = document_.CursorParagraph();
+	int32 cursorRow, cursorColumn;
+	document_.GetCursorRow(cursorRow, cursorColumn);
+
+	// Joins and re-wraps can leave the anchor past the end of the document.
+	scrollParagraph_ = FMath::Min(scrollParagraph_, document_.NumParagraphs() - 1);
+	scrollRow_ = FMath::Min(scrollRow_, document_.NumRows(scrollParagraph_) - 1);
+
+	if (cursorParagraph < scrollParagraph_ || (cursorParagraph == scrollParagraph_ && cursorRow < scrollRow_)) {
+		// Above the top row.
+		scrollParagraph_ = cursorParagraph;
+		scrollRow_ = cursorRow;
+		LocateCursorRow();
+		return;
+	}
+	if (LocateCursorRow()) {
+		return;
+	}
+
+	// Below the bottom row; anchor so the cursor ends up on the last visible row.
+	int32 paragraph = cursorParagraph;
+	int32 row = cursorRow;
+	int32 visibleRows = FMath::Max(numRows_, 1);
+	for (int32 i = 1; i < visibleRows; i++) {
+		if (row > 0) {
+			row--;
+		}
+		else if (paragraph > 0) {
+			paragraph--;
+			row = document_.NumRows(paragraph) - 1;
+		}
+		else {
+			break;
+		}
+	}
+	scrollParagraph_ = paragraph;
+	scrollRow_ = row;
+	LocateCursorRow();
+}
+
+void HotHudTextBox::ScrollDocument(int32 rows) {
+	for (; rows > 0; rows--) {
+		if (scrollRow_ + 1 < document_.NumRows(scrollParagraph_)) {
+			scrollRow_++;
+		}
+		else if (scrollParagraph_ + 1 < document_.NumParagraphs()) {
+			scrollParagraph_++;
+			scrollRow_ = 0;
+		}
+	}
+	for (; rows < 0; rows++) {
+		if (scrollRow_ > 0) {
+			scrollRow_--;
+		}
+		else if (scrollParagraph_ > 0) {
+			scrollParagraph_--;
+			scrollRow_ = document_.NumRows(scrollParagraph_) - 1;
+		}
+	}
+	LocateCursorRow();
+}
+
+bool HotHudTextBox::OnMouseWheel(float delta) {
+	int32 rows = FMath::RoundToInt(delta) * kTextBoxWheelRows;
+	if (editable_) {
+		ScrollDocument(-rows);
+	}
+	else {
+		scrollbackOffset_ = FMath::Clamp(scrollbackOffset_ + rows, 0, FMath::Max(rowBuffer_.Num() - numRows_, 0));
+	}
+	return true;
+}
+
+bool HotHudTextBox::OnKeyDown(const FKey& key) {
+	if (!editable_) {
+		return false;
+	}
+	if (key == EKeys::Left) {
+		MoveCursor(ETextBoxCursorMove::Left);
+	}
+	else if (key == EKeys::Right) {
+		MoveCursor(ETextBoxCursorMove::Right);
+	}
+	else if (key == EKeys::Up) {
+		MoveCursor(ETextBoxCursorMove::Up);
+	}
+	else if (key == EKeys::Down) {
+		MoveCursor(ETextBoxCursorMove::Down);
+	}
+	else if (key == EKeys::Home) {
+		MoveCursor(ETextBoxCursorMove::Home);
+	}
+	else if (key == EKeys::End) {
+		MoveCursor(ETextBoxCursorMove::End);
+	}
+	else if (key == EKeys::BackSpace) {
+		DeleteCharacter(false);
+	}
+	else if (key == EKeys::Delete) {
+		DeleteCharacter(true);
+	}
+	else if (key == EKeys::Enter) {
+		TCHAR newline = TEXT('\n');
+		document_.Insert(&newline, 1);
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+bool HotHudTextBox::OnCharacter(TCHAR character) {
+	// Control characters are handled as keys.
+	if (!editable_ || character < TEXT(' ')) {
+		return false;
+	}
+	document_.Insert(&character, 1);
+	return true;
+}
+
+void HotHudTextBox::OnDocumentChanged(UCanvas* canvas) {
+	ScrollToCursor();
+
+	// Measure the caret offset from the text which precedes it on its row.
+	int32 cursorRow, cursorColumn;
+	document_.GetCursorRow(cursorRow, cursorColumn);
+	rowScratch_.Reset();
+	document_.GetRowText(document_.CursorParagraph(), cursorRow, rowScratch_);
+	caretX_ = 0;
+	if (cursorColumn > 0) {
+		float height;
+		canvas->TextSize(Cfg().Font, rowScratch_.Left(cursorColumn), caretX_, height, Cfg().FontScale, Cfg().FontScale);
+	}
+	caretRevision_ = document_.Revision();
+}
+
+void HotHudTextBox::DrawDocument(AHotHud* hud, UCanvas* canvas) {
+	if (caretRevision_ != document_.Revision()) {
+		OnDocumentChanged(canvas);
+	}
+	float opacity = EffectiveOpacity();
+	const FLinearColor& textColor = StyledColor(HotHudStyleOverride_TextColor, Cfg().DefaultTextColor);
+
+	int32 paragraph = scrollParagraph_;
+	int32 row = scrollRow_;
+	for (int32 i = 0; i < numRows_ && paragraph < document_.NumParagraphs(); i++) {
+		TSharedPtr<HotHudGlyphRun>& run = document_.RowRun(paragraph, row);
+		if (!run.IsValid()) {
+			// Only rows which were edited (or have never been drawn) need their text.
+			rowScratch_.Reset();
+			document_.GetRowText(paragraph, row, rowScratch_);
+		}
+		hud->DrawCachedText(run, rowScratch_, textColor, screenCoords_.X, screenCoords_.Y + (rowHeight_ * i), Cfg().Font, Cfg().FontScale, opacity);
+		if (++row >= document_.NumRows(paragraph)) {
+			paragraph++;
+			row = 0;
+		}
+	}
+}
+
+void HotHudTextBox::DrawOverlay(AHotHud* hud, UCanvas* canvas) {
+	// Draw caret.
+	if (editable_ && isFocused_ && numColumns_ != -1 && virtualCursorRow_ < numRows_) {
+		const FLinearColor& textColor = StyledColor(HotHudStyleOverride_TextColor, Cfg().DefaultTextColor);
+		hud->DrawChromeRect(Faded(textColor), screenCoords_.X + caretX_, screenCoords_.Y + (rowHeight_ * virtualCursorRow_), kTextBoxCaretWidth, rowHeight_);
 	}
+}
 
-	if (!localPlayerController_->PlayerInput || SupressHud || !Canvas) {
+void HotHudTextBox::Measure(UCanvas* canvas) {
+	FString testString = "XgGZP";
+
+	float testStringWidth;
+	float testStringHeight;
+	canvas->TextSize(Cfg().Font, testString, testStringWidth, testStringHeight);
+	rowHeight_ = testStringHeight;
+	numColumns_ = geometry_.Width / (testStringWidth / testString.Len());
+	numRows_ = geometry_.Height / testStringHeight;
+	document_.SetWrapColumns(numColumns_);
+
+	HOTHUD_TRACE_EVENT(HotHudTrace_Layout, HotHudTraceEvent_TextBoxMeasured, name_, numColumns_, numRows_);
+}
+
+bool HotHudTextBox::RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) {
+	// Resizes & restyles since the work was queued may have already re-measured us.
+	if (work == HotHudWork_Measure && numColumns_ == -1) {
+		Measure(canvas);
+	}
+	return true;
+}
+
+void HotHudTextBox::PrepareDraw(AHotHud* hud, UCanvas* canvas) {
+	if (styleRevision_ != style_->Revision) {
+		SyncStyle();
+	}
+
+	// Re-calculate the number of rows and columns we can display if needed. Until the scheduler gets
+	// to it only the background is drawn.
+	if (numColumns_ == -1 && !hud->DeferWork(this, HotHudWork_Measure, HotHudWorkPriority_Visible)) {
+		Measure(canvas);
+	}
+}
+
+void HotHudTextBox::DrawChrome(AHotHud* hud, UCanvas* canvas) {
+	// Draw background.
+	hud->DrawChromeRect(Faded(StyledColor(HotHudStyleOverride_BackgroundColor, Cfg().BackgroundColor)), screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+}
+
+void HotHudTextBox::Draw(AHotHud* hud, UCanvas* canvas) {
+	PrepareDraw(hud, canvas);
+	DrawChrome(hud, canvas);
+	hud->FlushChrome();
+	DrawText(hud, canvas);
+	hud->FlushText();
+	DrawOverlay(hud, canvas);
+	hud->FlushChrome();
+}
+
+void HotHudTextBox::DrawText(AHotHud* hud, UCanvas* canvas) {
+	if (numColumns_ == -1) {
+		return;
+	}
+	if (editable_) {
+		DrawDocument(hud, canvas);
 		return;
 	}
 
-	// Figure out which control is currently under the mouse and if it's different from
-	// the last time we checked.
-	FVector2D mouseLocation;
-	localPlayerController_->GetMousePosition(mouseLocation.X, mouseLocation.Y);
+	// Draw text. The newest rows are shown unless the user scrolled back.
+	float opacity = EffectiveOpacity();
+	const FLinearColor& textColor = StyledColor(HotHudStyleOverride_TextColor, Cfg().DefaultTextColor);
+	int firstRow = FMath::Max(rowBuffer_.Num() - numRows_ - scrollbackOffset_, 0);
+	int numItemsToDraw = FMath::Min(rowBuffer_.Num() - firstRow, numRows_);
+	for (int i = 0; i < numItemsToDraw; i++) {
+		const FString& rowString = rowBuffer_[firstRow + i];
+		hud->DrawCachedText(rowRuns_[firstRow + i], rowString, textColor, screenCoords_.X, screenCoords_.Y + (rowHeight_ * i), Cfg().Font, Cfg().FontScale, opacity);
+	}
+}
 
-	HotHudControl* controlUnderMouse = FindTopMostControlAt(mouseLocation);
-	bool hoverTargetChanged = false;
-	if (controlUnderMouse != controlBeingHovered_) {
-		// Notify any previously hovered control it's no longer hovered over
-		if (controlBeingHovered_ != nullptr) {
-			UE_LOG(LogHUD, Warning, TEXT("Control '%s' is no longer being hovered."), *controlBeingHovered_->Name().ToString());
-			controlBeingHovered_->SetIsHovered(false);
-		}
+/*****************************************************************************/
 
-		// Invalidate drag & drop target validity state.
-		dragDropTargetValid_ = false;
+HotHudLabel::HotHudLabel(
+	const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+	const TSharedRef<HotHudTextBoxStyle>& style, const FString& text)
+	: HotHudControl(HotHudControl_Label, name, parent, geometry, false, false),
+	style_(style),
+	binding_(nullptr),
+	valueLen_(0),
+	text_(text) {
+}
 
-		// Notify the newly hovered control and do drag & drop checks.
-		if (controlUnderMouse != nullptr) {
-			controlUnderMouse->SetIsHovered(true);
-			UE_LOG(LogHUD, Warning, TEXT("Control '%s' is now being hovered."), *controlUnderMouse->Name().ToString());
-			if (controlBeingDragged_ != nullptr) {
-				// Clear out any drag state left on the last hovered control.
-				if (controlBeingHovered_ != nullptr) {
-					controlBeingHovered_->SetValidDragSource(nullptr);
-				}
+void HotHudLabel::SetStyle(const TSharedRef<HotHudTextBoxStyle>& style) {
+	style_ = style;
+}
 
-				ReceiveValidateDropTargetRequest(controlBeingDragged_->Name(), controlUnderMouse->Name(), dragDropTargetValid_);
+void HotHudLabel::SetText(const FString& text) {
+	SetBinding(nullptr);
+	valueLen_ = 0;
+	text_ = text;
+	run_.Reset();
+}
 
-				UE_LOG(
-					LogHUD, Warning, TEXT("DropTargetValidation = %d for %s -> %s"),
-					dragDropTargetValid_, *controlBeingDragged_->Name().ToString(), *controlUnderMouse->Name().ToString());
+void HotHudLabel::SetAffixes(const FString& prefix, const FString& suffix) {
+	prefix_ = prefix;
+	suffix_ = suffix;
+	if (binding_ != nullptr || valueLen_ > 0) {
+		ComposeText();
+	}
+}
 
-				// TODO(san): Refactor.
-				if (dragDropTargetValid_) {
-					controlUnderMouse->SetValidDragSource(controlBeingDragged_);
-				}
-				else {
-					controlUnderMouse->SetValidDragSource(nullptr);
-				}
-			}
-		}
-		// 
-		controlBeingHovered_ = controlUnderMouse;
-		hoverTargetChanged = true;
-	}
-
-	// Get the mouse button state.
-	FVector leftMouseButtonVector = localPlayerController_->GetInputVectorKeyState(
-		FKey(EKeys::LeftMouseButton.GetFName()));
-	bool leftMouseButtonDown = (leftMouseButtonVector.X != 0);
-
-	if (leftMouseButtonDown != lastLeftMouseButtonDown_) {
-		// Left button state has changed.
-		if (leftMouseButtonDown) {
-			if (controlBeingHovered_ != nullptr) {
-				if (controlBeingHovered_->IsMovable()) {
-					// Begin movable control move.
-					controlBeingHovered_->SetIsMoving(true);
-					controlBeingMoved_ = controlBeingHovered_;
-					mouseControlOffset_ = mouseLocation - controlBeingMoved_->ScreenCoords();
-					UE_LOG(LogHUD, Warning, TEXT("Control '%s' is now being moved."), *controlBeingMoved_->Name().ToString());
-				}
-				else if (controlBeingHovered_->IsDraggable()) {
-					// Begin draggable control drag.
-					controlBeingHovered_->SetIsDragging(true);
-					controlBeingDragged_ = controlBeingHovered_;
-					mouseControlOffset_ = mouseLocation - controlBeingDragged_->ScreenCoords();
-					UE_LOG(LogHUD, Warning, TEXT("Control '%s' is now being dragged."), *controlBeingDragged_->Name().ToString());
-				}
-			}
-		}
-		else {
-			if (controlBeingMoved_ != nullptr) {
-				UE_LOG(LogHUD, Warning, TEXT("Control '%s' is no longer being moved."), *controlBeingMoved_->Name().ToString());
-				controlBeingMoved_->SetIsMoving(false);
-				controlBeingMoved_ = nullptr;
-			}
+void HotHudLabel::SetBinding(HotHudLabelBinding* binding) {
+	delete binding_;
+	binding_ = binding;
+}
 
-			if (controlBeingDragged_ != nullptr) {
-				UE_LOG(LogHUD, Warning, TEXT("Control '%s' is no longer being dragged."), *controlBeingDragged_->Name().ToString());
-				controlBeingDragged_->SetIsDragging(false);
-				if (controlBeingHovered_ != nullptr && (controlBeingHovered_->ValidDragSource())) {
-					controlBeingHovered_->NotifyOnValidDrop(controlBeingDragged_);
-					controlBeingHovered_->SetValidDragSource(nullptr);
-				}
-				controlBeingDragged_ = nullptr;
-			}
+void HotHudLabel::ComposeText() {
+	text_.Reset();
+	text_ += prefix_;
+	text_.AppendChars(value_, valueLen_);
+	text_ += suffix_;
+	run_.Reset();
+}
+
+void HotHudLabel::PrepareDraw(AHotHud* hud, UCanvas* canvas) {
+	// Nothing is derived from the style; the glyph run notices font & color changes by itself.
+	if (binding_ != nullptr && binding_->Update(value_, valueLen_)) {
+		ComposeText();
+	}
+}
+
+void HotHudLabel::DrawChrome(AHotHud* hud, UCanvas* canvas) {
+	const FLinearColor& background = StyledColor(HotHudStyleOverride_BackgroundColor, Cfg().BackgroundColor);
+	if (background.A > 0) {
+		hud->DrawChromeRect(Faded(background), screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+	}
+}
+
+void HotHudLabel::DrawText(AHotHud* hud, UCanvas* canvas) {
+	if (text_.Len() != 0) {
+		hud->DrawCachedText(run_, text_, StyledColor(HotHudStyleOverride_TextColor, Cfg().DefaultTextColor), screenCoords_.X, screenCoords_.Y, Cfg().Font, Cfg().FontScale, EffectiveOpacity());
+	}
+}
+
+void HotHudLabel::Draw(AHotHud* hud, UCanvas* canvas) {
+	PrepareDraw(hud, canvas);
+	DrawChrome(hud, canvas);
+	hud->FlushChrome();
+	DrawText(hud, canvas);
+	hud->FlushText();
+}
+
+void HotHudLabel::SerializeState(AHotHud* hud, FArchive& ar) {
+	HotHudControl::SerializeState(hud, ar);
+	ar << prefix_ << suffix_ << text_;
+	if (ar.IsLoading()) {
+		run_.Reset();
+	}
+}
+
+void HotHudLabel::AccumulateMemoryStats(FHotHudMemoryStats& stats) const {
+	stats.LabelBytes += sizeof(HotHudLabel) + BaseAllocatedSize() + prefix_.GetCharArray().GetAllocatedSize() +
+		suffix_.GetCharArray().GetAllocatedSize() + text_.GetCharArray().GetAllocatedSize();
+}
+
+/*****************************************************************************/
+
+HotHudGauge::HotHudGauge(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const TSharedRef<HotHudGaugeStyle>& style)
+	: HotHudControl(HotHudControl_Gauge, name, parent, geometry, false, false),
+	style_(style),
+	value_(0.0f) {
+}
+
+void HotHudGauge::SetStyle(const TSharedRef<HotHudGaugeStyle>& style) {
+	style_ = style;
+}
+
+void HotHudGauge::DrawChrome(AHotHud* hud, UCanvas* canvas) {
+	const FLinearColor& background = StyledColor(HotHudStyleOverride_BackgroundColor, Cfg().BackgroundColor);
+	if (background.A > 0) {
+		hud->DrawChromeRect(Faded(background), screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+	}
+
+	float range = Cfg().MaxValue - Cfg().MinValue;
+	float fraction = (range != 0.0f) ? FMath::Clamp((value_ - Cfg().MinValue) / range, 0.0f, 1.0f) : 0.0f;
+	if (fraction <= 0.0f) {
+		return;
+	}
+	if (Cfg().Vertical) {
+		float fillHeight = geometry_.Height * fraction;
+		hud->DrawChromeRect(Faded(Cfg().FillColor), screenCoords_.X, screenCoords_.Y + geometry_.Height - fillHeight, geometry_.Width, fillHeight);
+	}
+	else {
+		hud->DrawChromeRect(Faded(Cfg().FillColor), screenCoords_.X, screenCoords_.Y, geometry_.Width * fraction, geometry_.Height);
+	}
+}
+
+void HotHudGauge::Draw(AHotHud* hud, UCanvas* canvas) {
+	DrawChrome(hud, canvas);
+	hud->FlushChrome();
+}
+
+void HotHudGauge::SerializeState(AHotHud* hud, FArchive& ar) {
+	HotHudControl::SerializeState(hud, ar);
+	ar << value_;
+}
+
+void HotHudGauge::AccumulateMemoryStats(FHotHudMemoryStats& stats) const {
+	stats.GaugeBytes += sizeof(HotHudGauge) + BaseAllocatedSize();
+}
+
+/*****************************************************************************/
+
+HotHudTileDataSource::~HotHudTileDataSource() {
+	// Unbinding modifies boundGrids_, so work from a copy.
+	TArray<HotHudTileGrid*> grids = boundGrids_;
+	for (HotHudTileGrid* grid : grids) {
+		grid->SetDataSource(grid->hud_, nullptr);
+	}
+}
+
+void HotHudTileDataSource::NotifyItemChanged(int32 index) {
+	for (HotHudTileGrid* grid : boundGrids_) {
+		grid->OnSourceItemChanged(index);
+	}
+}
+
+void HotHudTileDataSource::NotifyItemsInserted(int32 index, int32 count) {
+	for (HotHudTileGrid* grid : boundGrids_) {
+		grid->OnSourceItemsInserted(index, count);
+	}
+}
+
+void HotHudTileDataSource::NotifyItemsRemoved(int32 index, int32 count) {
+	for (HotHudTileGrid* grid : boundGrids_) {
+		grid->OnSourceItemsRemoved(index, count);
+	}
+}
+
+void HotHudTileDataSource::NotifyReset() {
+	for (HotHudTileGrid* grid : boundGrids_) {
+		grid->OnSourceReset();
+	}
+}
+
+/*****************************************************************************/
+
+HotHudTile::HotHudTile(
+	const FName& name, HotHudControl* parent, const FControlGeometry& geometry)
+	: HotHudControl(HotHudControl_Tile, name, parent, geometry, false, false),
+	slotIndex_(INDEX_NONE),
+	tileDataFetched_(false),
+	tileImage_(nullptr),
+	tileText_(""),
+	atlasKey_(0),
+	labelIsBound_(false),
+	lastDrawnFrame_(0),
+	sortKey_(0.0f),
+	isFilteredOut_(false) {
+}
+
+void HotHudTile::FetchTileData(AHotHud* hud) {
+	HotHudTileDataSource* source = nullptr;
+	if (parent_ != nullptr && parent_->Type() == HotHudControl_TileGrid) {
+		source = static_cast<HotHudTileGrid*>(parent_)->DataSource();
+	}
+
+	if (source != nullptr) {
+		tileImage_ = source->GetItemTexture(slotIndex_);
+		if (!labelIsBound_) {
+			tileText_ = source->GetItemLabel(slotIndex_);
 		}
+		isDraggable_ = source->IsItemDraggable(slotIndex_);
+	}
+	else {
+		hud->ReceiveTileInfoRequest(name_, tileImage_, isDraggable_);
+	}
+	tileDataFetched_ = true;
+	if (!labelIsBound_) {
+		labelRun_.Reset();
+	}
 
-		lastLeftMouseButtonDown_ = leftMouseButtonDown;
+	// Swap our atlas reference over to the (possibly) new image.
+	HotHudTextureAtlas* atlas = hud->TileAtlas();
+	if (atlas != nullptr) {
+		uint64 oldKey = atlasKey_;
+		atlasKey_ = atlas->Acquire(tileImage_, geometry_.Width, geometry_.Height);
+		atlas->Release(oldKey);
 	}
+}
 
-	// Draw any windows *not* being moved.
-	HotHudWindow* movingWindow = nullptr;
-	for (HotHudWindow* window : rootWindows_) {
-		if (!window->IsMoving()) {
-			window->Draw(this, this->Canvas);
+void HotHudTile::Draw(AHotHud* hud, UCanvas* canvas) {
+	DrawImage(hud, canvas, nullptr);
+	DrawText(hud, canvas);
+	hud->FlushText();
+}
+
+void HotHudTile::DrawImage(AHotHud* hud, UCanvas* canvas, HotHudTextureAtlas* atlas) {
+	lastDrawnFrame_ = GFrameCounter;
+	if (!tileDataFetched_) {
+		if (hud->DeferWork(this, HotHudWork_FetchTileData, HotHudWorkPriority_Visible)) {
+			return;
 		}
-		else {
-			movingWindow = window;
+		FetchTileData(hud);
+	}
+
+	int32 page;
+	FVector4 uvs;
+	FVector2D size;
+	if (atlas != nullptr && atlasKey_ != 0 && atlas->GetUVs(atlasKey_, page, uvs)) {
+		size = FVector2D(geometry_.Width, geometry_.Height);
+		AppendQuad(atlas->PageBatch(page), screenCoords_, size, uvs, Faded(FLinearColor::White));
+	}
+	else if (tileImage_ != nullptr) {
+		FCanvasTileItem canvasTile(screenCoords_, tileImage_->Resource, Faded(FLinearColor::White));
+		canvasTile.BlendMode = SE_BLEND_Translucent;
+		canvas->DrawItem(canvasTile);
+		size = canvasTile.Size;
+	}
+	else {
+		// TODO(san): Stock image.
+		return;
+	}
+	// Atlased or not, the capture records the tile's own texture rather than the atlas page.
+	if (hud->DrawCapture() != nullptr) {
+		hud->DrawCapture()->Record(HotHudCapture_Image, this, screenCoords_.X, screenCoords_.Y, size.X, size.Y, Faded(FLinearColor::White), tileImage_);
+	}
+}
+
+void HotHudTile::DrawText(AHotHud* hud, UCanvas* canvas) {
+	if (tileText_.Len() != 0) {
+		hud->DrawCachedText(labelRun_, tileText_, StyledColor(HotHudStyleOverride_TextColor, FLinearColor::White), screenCoords_.X + 2, screenCoords_.Y + 2, nullptr, 1.0f, EffectiveOpacity());
+	}
+}
+
+void HotHudTile::ReleaseTileData(AHotHud* hud) {
+	if (!tileDataFetched_) {
+		return;
+	}
+	HotHudTextureAtlas* atlas = hud->TileAtlas();
+	if (atlas != nullptr) {
+		atlas->Release(atlasKey_);
+	}
+	atlasKey_ = 0;
+	tileImage_ = nullptr;
+	if (!labelIsBound_) {
+		tileText_.Empty();
+		labelRun_.Reset();
+	}
+	tileDataFetched_ = false;
+}
+
+void HotHudTile::SetBoundLabel(const FString& text) {
+	bool changed = !labelIsBound_ || !tileText_.Equals(text, ESearchCase::CaseSensitive);
+	labelIsBound_ = true;
+	tileText_ = text;
+	labelRun_.Reset();
+	if (changed) {
+		InvalidateGridView();
+	}
+}
+
+void HotHudTile::ClearBoundLabel() {
+	if (labelIsBound_) {
+		labelIsBound_ = false;
+		tileText_.Empty();
+		labelRun_.Reset();
+		InvalidateTileData();
+		InvalidateGridView();
+	}
+}
+
+void HotHudTile::InvalidateGridView() {
+	// The grid's view may filter or sort on the label.
+	if (parent_ != nullptr && parent_->Type() == HotHudControl_TileGrid) {
+		HotHudTileGrid* grid = static_cast<HotHudTileGrid*>(parent_);
+		if (grid->HasView()) {
+			grid->InvalidateView();
 		}
 	}
+}
 
-	// If there's a window being moved then update it's position and draw it.
-	if (movingWindow != nullptr) {
-		movingWindow->MoveToRelative(mouseLocation - mouseControlOffset_);
-		movingWindow->Draw(this, this->Canvas);
+bool HotHudTile::RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) {
+	if (work == HotHudWork_FetchTileData && !tileDataFetched_) {
+		FetchTileData(hud);
 	}
+	return true;
+}
 
-	// Finally draw any dragging going on.
-	if (controlBeingDragged_ != nullptr) {
-		UTexture2D* texture = controlBeingDragged_->GetDragTexture();
-		if (texture != nullptr) {
-			FLinearColor color;
-			// TODO(san): Make this prettier.
-			if (dragDropTargetValid_) {
-				color = FLinearColor::Green;
-			}
-			else {
-				color = FLinearColor::Red;
-			}
-			FCanvasTileItem dragCursor((mouseLocation - mouseControlOffset_), texture->Resource, color);
-			dragCursor.BlendMode = SE_BLEND_Translucent;
-			Canvas->DrawItem(dragCursor);
+void HotHudTile::SerializeState(AHotHud* hud, FArchive& ar) {
+	HotHudControl::SerializeState(hud, ar);
+	bool imageLoaded = SerializeObjectPath(ar, tileImage_);
+	ar << tileDataFetched_;
+	// A bound label isn't the tile's own, and the binding isn't kept.
+	FString label = labelIsBound_ ? FString() : tileText_;
+	ar << label;
+	if (ar.IsLoading()) {
+		tileText_ = label;
+		labelRun_.Reset();
+		// Images which can't be loaded by path (e.g. created at runtime) are fetched again.
+		tileDataFetched_ = tileDataFetched_ && imageLoaded;
+		HotHudTextureAtlas* atlas = hud->TileAtlas();
+		if (tileDataFetched_ && atlas != nullptr) {
+			atlasKey_ = atlas->Acquire(tileImage_, geometry_.Width, geometry_.Height);
 		}
 	}
 }
 
+void HotHudTile::AccumulateMemoryStats(FHotHudMemoryStats& stats) const {
+	stats.TileBytes += sizeof(HotHudTile) + BaseAllocatedSize();
+	stats.TileDataBytes += tileText_.GetCharArray().GetAllocatedSize();
+}
+
+UTexture2D* HotHudTile::GetDragTexture() {
+	return tileImage_;
+}
+
+void HotHudTile::NotifyOnValidDrop(AHotHud* hud, HotHudControl* sourceControl) {
+	// Tiles don't know how to re-order themselves; let the grid we live in deal with it.
+	if (parent_ != nullptr && parent_->Type() == HotHudControl_TileGrid) {
+		static_cast<HotHudTileGrid*>(parent_)->HandleTileDrop(hud, sourceControl, slotIndex_);
+	}
+}
+
 /*****************************************************************************/
-HotHudControl::HotHudControl(
-	HotHudControlType type, const FName& name, HotHudControl* parent,
-	const FControlGeometry& geometry, bool isMovable, bool isDraggable)
-	: type_(type),
-	name_(name),
-	parent_(parent),
-	geometry_(geometry),
-	isMovable_(isMovable),
-	isDraggable_(isDraggable),
-	screenCoords_(FVector2D(0, 0)),
-	childOffsetTop_(0),
-	childOffsetRight_(0),
-	childOffsetBottom_(0),
-	childOffsetLeft_(0),
-	isMoving_(false),
-	isDragging_(false),
-	isHovered_(false),
-	validDragSource_(nullptr) {
-	RecomputeAbsolutePosition();
+
+void HotHudSlotSet::Add(int32 first, int32 last) {
+	if (last < first) {
+		return;
+	}
+	// Ranges before this one end short of First and are left alone.
+	int32 index = FindRange(first - 1);
+	int32 end = index;
+	while (end < Ranges.Num() && Ranges[end].First <= last + 1) {
+		first = FMath::Min(first, Ranges[end].First);
+		last = FMath::Max(last, Ranges[end].Last);
+		end++;
+	}
+	HotHudSlotRange range = { first, last };
+	if (end == index) {
+		Ranges.Insert(range, index);
+	}
+	else {
+		Ranges[index] = range;
+		Ranges.RemoveAt(index + 1, end - index - 1);
+	}
 }
 
-void HotHudControl::AddChildControl(HotHudControl* child) {
-	childControls_.Add(child);
-	child->RecomputeAbsolutePosition();
+bool HotHudSlotSet::Contains(int32 slot) const {
+	int32 index = FindRange(slot);
+	return index < Ranges.Num() && Ranges[index].First <= slot;
+}
+
+void HotHudSlotSet::Truncate(int32 lastSlot) {
+	int32 index = FindRange(lastSlot);
+	if (index < Ranges.Num() && Ranges[index].First <= lastSlot) {
+		Ranges[index].Last = lastSlot;
+		index++;
+	}
+	Ranges.RemoveAt(index, Ranges.Num() - index);
+}
+
+int32 HotHudSlotSet::FindRange(int32 slot) const {
+	int32 low = 0;
+	int32 high = Ranges.Num();
+	while (low < high) {
+		int32 middle = (low + high) / 2;
+		if (Ranges[middle].Last < slot) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/*****************************************************************************/
 
-	// Clamp the size of the child to our child viewport.
-	// TODO(san): Revisit for scrollbars.
-	int32 maxChildWidth = geometry_.Width - childOffsetLeft_ - childOffsetRight_;
-	int32 maxChildHeight = geometry_.Height - childOffsetTop_ - childOffsetBottom_;
+HotHudTileGrid::HotHudTileGrid(
+	const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+	const TSharedRef<HotHudTileGridStyle>& style)
+	: HotHudControl(HotHudControl_TileGrid, name, parent, geometry, false, false),
+	style_(style),
+	styleRevision_(style->Revision),
+	numColumns_(-1),
+	numRows_(-1),
+	dataSource_(nullptr),
+	hud_(nullptr),
+	nextSourceTileNumber_(0),
+	viewSortBy_(EHotHudTileSortBy::Slot),
+	viewDescending_(false),
+	viewUsesFilterFlags_(false),
+	viewDirty_(false),
+	viewSkipsCollapsed_(false),
+	viewIsBuilt_(false) {
+	childOffsetLeft_ = kTileSeparation;
+	childOffsetTop_ = kTileSeparation;
+	childOffsetRight_ = kTileSeparation;
+	childOffsetBottom_ = kTileSeparation;
+}
 
-	if ((child->Geometry().Width > maxChildWidth) || (child->Geometry().Height > maxChildHeight)) {
-		UE_LOG(LogHUD, Warning, TEXT("Control %s being resized from %d,%d to %d,%d for fit to %s"),
-			*child->Name().ToString(), child->Geometry().Width, child->Geometry().Height, maxChildWidth, maxChildHeight, *name_.ToString());
-		child->Resize(maxChildWidth, maxChildHeight);
+HotHudTileGrid::~HotHudTileGrid() {
+	if (dataSource_ != nullptr) {
+		dataSource_->boundGrids_.Remove(this);
 	}
 }
 
-bool HotHudControl::ContainsCoord(const FVector2D& coord) {
-	if ((coord.X >= screenCoords_.X) && (coord.X <= (screenCoords_.X + geometry_.Width)) &&
-		(coord.Y >= screenCoords_.Y) && (coord.Y <= (screenCoords_.Y + geometry_.Height))) {
-		return true;
+void HotHudTileGrid::SetDataSource(AHotHud* hud, HotHudTileDataSource* source) {
+	if (dataSource_ != nullptr) {
+		dataSource_->boundGrids_.Remove(this);
 	}
-	return false;
+	hud_ = hud;
+	dataSource_ = source;
+	if (dataSource_ != nullptr) {
+		dataSource_->boundGrids_.AddUnique(this);
+	}
+	OnSourceReset();
 }
 
-HotHudControl* HotHudControl::FindTopMostControlAt(const FVector2D& location) {
-	// Fast-path check.
-	if (!ContainsCoord(location)) {
-		return nullptr;
-	}
+HotHudTile* HotHudTileGrid::CreateSourceTile() {
+	FName tileName;
+	do {
+		tileName = FName(name_, ++nextSourceTileNumber_);
+	} while (hud_->FindControlByName(tileName) != nullptr);
 
-	HotHudControl* childHit = nullptr;
-	for (HotHudControl* child : childControls_) {
-		childHit = child->FindTopMostControlAt(location);
-		if (childHit) {
-			break;
+	FControlGeometry geom;
+	geom.Height = Cfg().TileHeight;
+	geom.Width = Cfg().TileWidth;
+	HotHudTile* newTile = new HotHudTile(tileName, this, geom);
+	hud_->RegisterControl(newTile);
+	return newTile;
+}
+
+void HotHudTileGrid::DestroyTiles(int32 slot, int32 count) {
+	for (int32 i = slot; i < slot + count; i++) {
+		HotHudControl* tile = childControls_[i];
+		if (hud_ != nullptr) {
+			hud_->ForgetControl(tile);
 		}
+		delete tile;
 	}
+	childControls_.RemoveAt(slot, count);
+}
 
-	return childHit == nullptr ? this : childHit;
+void HotHudTileGrid::OnSourceItemChanged(int32 index) {
+	if (childControls_.IsValidIndex(index)) {
+		TileAt(index)->InvalidateTileData();
+		// The item's key, label or visibility may have changed with it.
+		if (HasView()) {
+			InvalidateView();
+		}
+	}
 }
 
-bool HotHudControl::IsValidMove(const FVector2D& location) {
-	// TODO(san): This is where we'd check for sub-window constraints.
-	return true;
+void HotHudTileGrid::OnSourceItemsInserted(int32 index, int32 count) {
+	if (count <= 0) {
+		return;
+	}
+	index = FMath::Clamp(index, 0, childControls_.Num());
+	TArray<HotHudControl*> newTiles;
+	newTiles.Reserve(count);
+	for (int32 i = 0; i < count; i++) {
+		newTiles.Add(CreateSourceTile());
+	}
+	childControls_.Insert(newTiles, index);
+	// Tiles past the insertion point keep their (still valid) fetched data; they just slide over.
+	RenumberSlots(index, childControls_.Num() - 1);
+	for (HotHudControl* tile : newTiles) {
+		hud_->DeferWork(tile, HotHudWork_FetchTileData, HotHudWorkPriority_Prefetch);
+	}
 }
 
-void HotHudControl::Resize(int32 width, int32 height) {
-	geometry_.Width = width;
-	geometry_.Height = height;
+void HotHudTileGrid::OnSourceItemsRemoved(int32 index, int32 count) {
+	if (index < 0 || count <= 0 || index >= childControls_.Num()) {
+		return;
+	}
+	count = FMath::Min(count, childControls_.Num() - index);
+	DestroyTiles(index, count);
+	RenumberSlots(index, childControls_.Num() - 1);
+}
 
-	// TODO(san): Notify children? Soon.
+void HotHudTileGrid::OnSourceReset() {
+	if (childControls_.Num() > 0) {
+		DestroyTiles(0, childControls_.Num());
+	}
+	if (dataSource_ != nullptr) {
+		OnSourceItemsInserted(0, dataSource_->NumItems());
+	}
 }
 
-void HotHudControl::MoveToRelative(const FVector2D& location) {
-	if (IsValidMove(location)) {
-		geometry_.Location = location;
+void HotHudTileGrid::Resize(int32 width, int32 height) {
+	HotHudControl::Resize(width, height);
+	numColumns_ = -1;
+	numRows_ = -1;
+	MarkSlotsDirty(0, childControls_.Num() - 1);
+}
 
-		RecomputeAbsolutePosition();
+void HotHudTileGrid::SetStyle(const TSharedRef<HotHudTileGridStyle>& style) {
+	style_ = style;
+	SyncStyle();
+}
 
-		for (HotHudControl* child : this->childControls_) {
-			child->MoveToRelative(child->geometry_.Location);
+void HotHudTileGrid::SyncStyle() {
+	styleRevision_ = style_->Revision;
+	// The tile size may have changed.
+	for (HotHudControl* child : childControls_) {
+		if (child->Geometry().Width != Cfg().TileWidth || child->Geometry().Height != Cfg().TileHeight) {
+			child->Resize(Cfg().TileWidth, Cfg().TileHeight);
 		}
 	}
+	numColumns_ = -1;
+	numRows_ = -1;
+	MarkSlotsDirty(0, childControls_.Num() - 1);
 }
 
-void HotHudControl::RecomputeAbsolutePosition() {
-	if (parent_ == nullptr) {
-		screenCoords_ = geometry_.Location;
-	}
-	else {
-		screenCoords_.X = parent_->ScreenCoords().X + parent_->ChildOffsetLeft() + geometry_.Location.X;
-		screenCoords_.Y = parent_->ScreenCoords().Y + parent_->ChildOffsetTop() + geometry_.Location.Y;
+void HotHudTileGrid::AddTiles(TMap<FName, HotHudControl*>* controlMap, const TArray<FName>& tileNames) {
+	childControls_.Reserve(childControls_.Num() + tileNames.Num());
+	for (const FName& tileName : tileNames) {
+		FControlGeometry geom;
+		geom.Height = Cfg().TileHeight;
+		geom.Width = Cfg().TileWidth;
+		HotHudTile* newTile = new HotHudTile(tileName, this, geom);
+		AddChildControl(newTile);
+		controlMap->Add(tileName, newTile);
 	}
 }
 
-void HotHudControl::NotifyOnValidDrop(HotHudControl* sourceControl) {
+void HotHudTileGrid::AddChildControl(HotHudControl* child) {
+	HotHudControl::AddChildControl(child);
+	int32 slot = childControls_.Num() - 1;
+	RenumberSlots(slot, slot);
+}
 
+void HotHudTileGrid::RemoveChildControl(HotHudControl* child) {
+	// Every tile after the removed one slides back a slot.
+	int32 slot = static_cast<HotHudTile*>(child)->SlotIndex();
+	check(childControls_[slot] == child);
+	childControls_.RemoveAt(slot);
+	static_cast<HotHudTile*>(child)->SetSlotIndex(INDEX_NONE);
+	RenumberSlots(slot, childControls_.Num() - 1);
 }
 
-/*****************************************************************************/
+bool HotHudTileGrid::MoveTile(int32 fromSlot, int32 toSlot) {
+	if (!childControls_.IsValidIndex(fromSlot) || !childControls_.IsValidIndex(toSlot)) {
+		return false;
+	}
+	if (fromSlot == toSlot) {
+		return true;
+	}
 
-HotHudWindow::HotHudWindow(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const FManagedWindowBuildOptions& cfg)
-: HotHudControl(HotHudControl_Window, name, parent, geometry, cfg.IsMovable, false),
-    cfg_(cfg ) {
-	childOffsetLeft_ = kWindowBorderWidth;
-	childOffsetTop_ = kWindowBorderWidth + cfg_.TitleBarHeight;
-	childOffsetRight_ = childOffsetLeft_;
-	childOffsetBottom_ = childOffsetLeft_;
+	// Rotate only the affected span rather than RemoveAt/Insert which would shuffle the whole tail.
+	HotHudControl* tile = childControls_[fromSlot];
+	if (fromSlot < toSlot) {
+		for (int32 i = fromSlot; i < toSlot; i++) {
+			childControls_[i] = childControls_[i + 1];
+		}
+	}
+	else {
+		for (int32 i = fromSlot; i > toSlot; i--) {
+			childControls_[i] = childControls_[i - 1];
+		}
+	}
+	childControls_[toSlot] = tile;
+	RenumberSlots(FMath::Min(fromSlot, toSlot), FMath::Max(fromSlot, toSlot));
+	return true;
 }
 
-void HotHudWindow::DrawBox(AHUD* hud, float x1, float y1, float x2, float y2, const FLinearColor& color) {
-	hud->DrawLine(x1, y1, x2, y1, color);
-	hud->DrawLine(x2, y1, x2, y2, color);
-	hud->DrawLine(x2, y2, x1, y2, color);
-	hud->DrawLine(x1, y2, x1, y1, color);
+bool HotHudTileGrid::SwapTiles(int32 firstSlot, int32 secondSlot) {
+	if (!childControls_.IsValidIndex(firstSlot) || !childControls_.IsValidIndex(secondSlot)) {
+		return false;
+	}
+	if (firstSlot == secondSlot) {
+		return true;
+	}
+	childControls_.Swap(firstSlot, secondSlot);
+	RenumberSlots(firstSlot, firstSlot);
+	RenumberSlots(secondSlot, secondSlot);
+	return true;
 }
 
-void HotHudWindow::DrawBorder(AHUD* hud) {
-	FLinearColor colorBlack(0, 0, 0, 1.0);
-	FLinearColor colorLessBlack(0, 0, 0, 0.75);
+void HotHudTileGrid::InsertTile(HotHudTile* tile, int32 slot) {
+	HotHudControl* oldParent = tile->Parent();
+	if (oldParent == this) {
+		MoveTile(tile->SlotIndex(), FMath::Min(slot, childControls_.Num() - 1));
+		return;
+	}
+	if (oldParent != nullptr) {
+		oldParent->RemoveChildControl(tile);
+	}
 
-	DrawBox(hud, screenCoords_.X, screenCoords_.Y, screenCoords_.X + geometry_.Width, screenCoords_.Y + geometry_.Height, colorBlack);
-	DrawBox(hud, screenCoords_.X + 1, screenCoords_.Y + 1, screenCoords_.X + geometry_.Width - 1, screenCoords_.Y + geometry_.Height - 1, colorLessBlack);
+	slot = FMath::Min(slot, childControls_.Num());
+	tile->SetParent(this);
+	tile->Resize(Cfg().TileWidth, Cfg().TileHeight);
+	if (tile->IsCollapsed()) {
+		viewSkipsCollapsed_ = true;
+	}
+	childControls_.Insert(tile, slot);
+	RenumberSlots(slot, childControls_.Num() - 1);
 }
 
-void HotHudWindow::DrawTitlebar(AHUD* hud) {
-	if (cfg_.Title.Len() != 0) {
-		int32 x, y, w;
+void HotHudTileGrid::HandleTileDrop(AHotHud* hud, HotHudControl* sourceControl, int32 targetSlot) {
+	if (sourceControl->Type() != HotHudControl_Tile || Cfg().DropAction == ETileGridDropAction::None) {
+		return;
+	}
+	HotHudTile* sourceTile = static_cast<HotHudTile*>(sourceControl);
+	HotHudControl* sourceParent = sourceTile->Parent();
+	bool isForeign = (sourceParent != this);
+	if (isForeign && (!Cfg().AcceptForeignTiles || sourceParent == nullptr || sourceParent->Type() != HotHudControl_TileGrid)) {
+		return;
+	}
+	HotHudTileGrid* sourceGrid = static_cast<HotHudTileGrid*>(sourceParent);
+	int32 sourceSlot = sourceTile->SlotIndex();
 
-		x = screenCoords_.X + kWindowBorderWidth;
-		y = screenCoords_.Y + kWindowBorderWidth;
-		w = geometry_.Width - (kWindowBorderWidth * 2);
+	// Grids bound to a data source don't own their ordering; hand the drop to the source, which
+	// re-orders its items and notifies us. Tiles can't migrate between sources.
+	if (dataSource_ != nullptr || sourceGrid->DataSource() != nullptr) {
+		if (!isForeign) {
+			dataSource_->RequestMoveItem(sourceSlot, targetSlot == INDEX_NONE ? childControls_.Num() - 1 : targetSlot,
+				Cfg().DropAction == ETileGridDropAction::Swap);
+		}
+		return;
+	}
 
-		hud->DrawRect(cfg_.TitleBarColor, x, y, w, cfg_.TitleBarHeight);
-		hud->DrawText(cfg_.Title, cfg_.TitleTextColor, x, y, cfg_.TitleFont, cfg_.TitleFontScale, false);
+	// Dropping onto the grid background (or onto the tile itself) means 'put it at the end'.
+	if (targetSlot == INDEX_NONE) {
+		targetSlot = isForeign ? childControls_.Num() : childControls_.Num() - 1;
+	}
+	else if (!isForeign && targetSlot == sourceSlot) {
+		return;
 	}
-}
 
-void HotHudWindow::Draw(AHotHud* hud, UCanvas* canvas) {
-	// Draw window background.
-	hud->DrawRect(cfg_.BackgroundColor, screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+	if (Cfg().DropAction == ETileGridDropAction::Swap && childControls_.IsValidIndex(targetSlot)) {
+		if (!isForeign) {
+			SwapTiles(sourceSlot, targetSlot);
+			hud->ReceiveTilesReordered(name_, FMath::Min(sourceSlot, targetSlot), FMath::Max(sourceSlot, targetSlot));
+			return;
+		}
+		// Trade the two tiles between grids. Nobody else moves.
+		HotHudTile* targetTile = TileAt(targetSlot);
+		sourceGrid->childControls_[sourceSlot] = targetTile;
+		targetTile->SetParent(sourceGrid);
+		targetTile->Resize(sourceGrid->Cfg().TileWidth, sourceGrid->Cfg().TileHeight);
+		sourceGrid->RenumberSlots(sourceSlot, sourceSlot);
 
-	// Draw window border.
-	DrawBorder(hud);
+		childControls_[targetSlot] = sourceTile;
+		sourceTile->SetParent(this);
+		sourceTile->Resize(Cfg().TileWidth, Cfg().TileHeight);
+		RenumberSlots(targetSlot, targetSlot);
 
-	// Draw titlebar (if any).
-	DrawTitlebar(hud);
+		hud->ReceiveTilesReordered(sourceGrid->Name(), sourceSlot, sourceSlot);
+		hud->ReceiveTilesReordered(name_, targetSlot, targetSlot);
+		return;
+	}
 
-	// Draw children.
-	for (HotHudControl* child : childControls_) {
-		child->Draw(hud, canvas);
+	if (!isForeign) {
+		MoveTile(sourceSlot, targetSlot);
+		hud->ReceiveTilesReordered(name_, FMath::Min(sourceSlot, targetSlot), FMath::Max(sourceSlot, targetSlot));
+		return;
 	}
+	InsertTile(sourceTile, targetSlot);
+	hud->ReceiveTilesReordered(sourceGrid->Name(), sourceSlot, sourceGrid->NumTiles() - 1);
+	hud->ReceiveTilesReordered(name_, sourceTile->SlotIndex(), childControls_.Num() - 1);
 }
 
-/*****************************************************************************/
+void HotHudTileGrid::NotifyOnValidDrop(AHotHud* hud, HotHudControl* sourceControl) {
+	HandleTileDrop(hud, sourceControl, INDEX_NONE);
+}
 
-HotHudTextBox::HotHudTextBox(
-	const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const FTextBoxBuildOptions& cfg)
-	: HotHudControl(HotHudControl_TextBox, name, parent, geometry, false, false),
-	cfg_(cfg),
-	numColumns_(-1),
-	numRows_(-1),
-	rowHeight_(0),
-	virtualCursorRow_(0),
-	virtualCursorColumn_(0) {
-	childOffsetLeft_ = kTextBoxBorderLeftWidth;
-	childOffsetTop_ = kTextBoxBorderTopHeight;
-	childOffsetRight_ = kTextBoxBorderRightWidth;
-	childOffsetBottom_ = kTextBoxBorderBottomHeight;
-	if (cfg_.Text.Len()) {
-		PrintLine(cfg_.Text);
+void HotHudTileGrid::RenumberSlots(int32 firstSlot, int32 lastSlot) {
+	for (int32 i = firstSlot; i <= lastSlot; i++) {
+		static_cast<HotHudTile*>(childControls_[i])->SetSlotIndex(i);
+	}
+	// A view holds slot numbers, so any change to the slots means it has to be rebuilt. Positions
+	// which showed one of these slots are re-laid out even if the slot number stays put.
+	if (HasView()) {
+		staleViewSlots_.Add(firstSlot, lastSlot);
+		InvalidateView();
+	}
+	else {
+		MarkSlotsDirty(firstSlot, lastSlot);
 	}
 }
 
-void HotHudTextBox::Resize(int32 width, int32 height) {
-	HotHudControl::Resize(width, height);
-	numColumns_ = -1;
-	numRows_ = -1;
+void HotHudTileGrid::SetViewSort(EHotHudTileSortBy::Type sortBy, bool descending) {
+	viewSortBy_ = sortBy;
+	viewDescending_ = descending;
+	InvalidateView();
 }
 
-void HotHudTextBox::Clear() {
-	rowBuffer_.Empty();
-	virtualCursorRow_ = 0;
-	virtualCursorColumn_ = 0;
+void HotHudTileGrid::SetViewFilter(bool useFilterFlags, const FString& labelFilter) {
+	viewUsesFilterFlags_ = useFilterFlags;
+	viewLabelFilter_ = labelFilter;
+	InvalidateView();
 }
 
-void HotHudTextBox::PrintLine(const FString& line) {
-	rowBuffer_.Add(line);
-	virtualCursorRow_++;
+void HotHudTileGrid::ClearView() {
+	viewSortBy_ = EHotHudTileSortBy::Slot;
+	viewUsesFilterFlags_ = false;
+	viewLabelFilter_.Empty();
+	InvalidateView();
 }
 
-void HotHudTextBox::Draw(AHotHud* hud, UCanvas* canvas) {
-	// Re-calculate the number of rows and columns we can display if needed.
-	// TODO(san): Investigate the cost of creating a temporary Canvas so we don't need to do this in Draw().
-	if (numColumns_ == -1) {
-		FString testString = "XgGZP";
+void HotHudTileGrid::InvalidateView() {
+	viewDirty_ = true;
+}
 
-		float testStringWidth;
-		float testStringHeight;
-		canvas->TextSize(cfg_.Font, testString, testStringWidth, testStringHeight);
-		rowHeight_ = testStringHeight;
-		numColumns_ = geometry_.Width / (testStringWidth / testString.Len());
-		numRows_ = geometry_.Height / testStringHeight;
+void HotHudTileGrid::OnTileCollapsedChanged() {
+	viewSkipsCollapsed_ = true;
+	InvalidateView();
+}
 
-		UE_LOG(LogHUD, Warning, TEXT("Textbox can contain %d columns and %d rows, font %x"), numColumns_, numRows_, cfg_.Font);
+void HotHudTileGrid::UpdateView() {
+	if (!viewDirty_) {
+		return;
 	}
-	
-	// Draw background.
-	hud->DrawRect(cfg_.BackgroundColor, screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
-
-	// Draw text.
-	int numItemsToDraw = (rowBuffer_.Num() > numRows_) ? numRows_ : rowBuffer_.Num();
-	for (int i = 0; i < numItemsToDraw; i++) {
-		const FString& rowString = rowBuffer_[i];
-		hud->DrawText(rowString, cfg_.DefaultTextColor, screenCoords_.X, screenCoords_.Y + (rowHeight_ * i), cfg_.Font, cfg_.FontScale, false);
+	viewDirty_ = false;
+	if (viewSkipsCollapsed_) {
+		viewSkipsCollapsed_ = false;
+		for (HotHudControl* tile : childControls_) {
+			if (tile->IsCollapsed()) {
+				viewSkipsCollapsed_ = true;
+				break;
+			}
+		}
+	}
+	// The old order is kept so that only the positions now showing a different tile are re-laid out.
+	Swap(viewOrder_, previousViewOrder_);
+	bool hadView = viewIsBuilt_;
+	viewIsBuilt_ = HasView();
+	viewOrder_.Reset();
+	if (viewIsBuilt_) {
+		BuildViewOrder();
 	}
-}
-/*****************************************************************************/
 
-HotHudTile::HotHudTile(
-	const FName& name, HotHudControl* parent, const FControlGeometry& geometry)
-	: HotHudControl(HotHudControl_Tile, name, parent, geometry, false, false),
-	tileDataFetched_(false),
-	tileImage_(nullptr),
-	tileText_("") {
+	int32 numSlots = childControls_.Num();
+	int32 numPrevious = hadView ? previousViewOrder_.Num() : numSlots;
+	for (int32 position = 0; position < NumShownTiles(); position++) {
+		int32 slot = viewIsBuilt_ ? viewOrder_[position] : position;
+		if (position >= numPrevious) {
+			MarkSlotsDirty(position, NumShownTiles() - 1);
+			break;
+		}
+		int32 previousSlot = hadView ? previousViewOrder_[position] : position;
+		// A renumbered (or removed) slot may hold another tile now, even if its number is unchanged.
+		bool previousIsStale = previousSlot >= numSlots || staleViewSlots_.Contains(previousSlot);
+		if (slot != previousSlot || previousIsStale) {
+			MarkSlotsDirty(position, position);
+		}
+	}
+	staleViewSlots_.Reset();
 }
 
-void HotHudTile::Draw(AHotHud* hud, UCanvas* canvas) {
-	if (!tileDataFetched_) {
-		hud->ReceiveTileInfoRequest(name_, tileImage_, isDraggable_);
-		tileDataFetched_ = true;
+void HotHudTileGrid::BuildViewOrder() {
+	// Everything which touches the tiles or the data source happens here on the game thread; the
+	// sort itself only compares the keys gathered up front.
+	int32 numSlots = childControls_.Num();
+	TArray<FString> sourceLabels;
+	if (dataSource_ != nullptr && (viewSortBy_ == EHotHudTileSortBy::Label || !viewLabelFilter_.IsEmpty())) {
+		sourceLabels.Reserve(numSlots);
+		for (int32 slot = 0; slot < numSlots; slot++) {
+			sourceLabels.Add(dataSource_->GetItemLabel(slot));
+		}
 	}
+	auto labelOf = [this, &sourceLabels](int32 slot) -> const FString& {
+		return (sourceLabels.Num() > 0) ? sourceLabels[slot] : TileAt(slot)->Label();
+	};
 
-	if (tileImage_ != nullptr) {
-		FCanvasTileItem canvasTile(screenCoords_, tileImage_->Resource, FLinearColor::White);
-		canvasTile.BlendMode = SE_BLEND_Translucent;
-		canvas->DrawItem(canvasTile);
-	}
-	else {
-		// TODO(san): Stock image.
+	viewOrder_.Reserve(numSlots);
+	for (int32 slot = 0; slot < numSlots; slot++) {
+		if (viewSkipsCollapsed_ && TileAt(slot)->IsCollapsed()) {
+			continue;
+		}
+		if (viewUsesFilterFlags_ && (dataSource_ != nullptr ? !dataSource_->IsItemShown(slot) : TileAt(slot)->IsFilteredOut())) {
+			continue;
+		}
+		if (!viewLabelFilter_.IsEmpty() && !labelOf(slot).Contains(viewLabelFilter_)) {
+			continue;
+		}
+		viewOrder_.Add(slot);
 	}
-	if (tileText_ != "") {
 
+	switch (viewSortBy_) {
+	case EHotHudTileSortBy::Key: {
+		TArray<float> keys;
+		keys.AddZeroed(numSlots);
+		for (int32 slot : viewOrder_) {
+			keys[slot] = (dataSource_ != nullptr) ? dataSource_->GetItemSortKey(slot) : TileAt(slot)->SortKey();
+		}
+		SortSlots(viewOrder_, viewDescending_, [&keys](int32 first, int32 second) {
+			return (keys[first] < keys[second]) ? -1 : (keys[second] < keys[first] ? 1 : 0);
+		});
+		break;
+	}
+	case EHotHudTileSortBy::Label:
+		SortSlots(viewOrder_, viewDescending_, [&labelOf](int32 first, int32 second) {
+			return labelOf(first).Compare(labelOf(second), ESearchCase::IgnoreCase);
+		});
+		break;
+	case EHotHudTileSortBy::Name:
+		SortSlots(viewOrder_, viewDescending_, [this](int32 first, int32 second) {
+			return TileAt(first)->Name().Compare(TileAt(second)->Name());
+		});
+		break;
+	default:
+		break;
 	}
 }
 
-UTexture2D* HotHudTile::GetDragTexture() {
-	return tileImage_;
+void HotHudTileGrid::MarkSlotsDirty(int32 firstSlot, int32 lastSlot) {
+	// Kept apart from other dirty slots, so that e.g. swapping the first & last tiles only moves those two.
+	dirtySlots_.Add(firstSlot, lastSlot);
 }
 
-/*****************************************************************************/
+void HotHudTileGrid::LayoutDirtySlots(int32 maxSlots) {
+	// Recalculate tile positions if needed. This can happen when one of the following occurs:
+	//   1. Tiles are added to, removed from or re-ordered within the grid.
+	//   2. The grid is re-sized.
+	// Only the slots which actually changed are touched.
+	UpdateView();
+	dirtySlots_.Truncate(NumShownTiles() - 1);
+	int32 numDone = 0;
+	while (numDone < dirtySlots_.Ranges.Num() && maxSlots > 0) {
+		HotHudSlotRange& range = dirtySlots_.Ranges[numDone];
+		int32 lastSlot = (maxSlots <= range.Last - range.First) ? range.First + maxSlots - 1 : range.Last;
+		for (int32 i = range.First; i <= lastSlot; i++) {
+			int childRow = i / numColumns_;
+			int childCol = i % numColumns_;
+			int childX = childCol * (Cfg().TileWidth + kTileSeparation);
+			int childY = childRow * (Cfg().TileHeight + kTileSeparation);
 
-HotHudTileGrid::HotHudTileGrid(
-	const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
-	const FTileGridBuildOptions& cfg)
-	: HotHudControl(HotHudControl_TileGrid, name, parent, geometry, false, false),
-	cfg_(cfg),
-	numColumns_(-1),
-	numRows_(-1),
-	tilePositionsNeedRecalc_(true) {
-	childOffsetLeft_ = kTileSeparation;
-	childOffsetTop_ = kTileSeparation;
-	childOffsetRight_ = kTileSeparation;
-	childOffsetBottom_ = kTileSeparation;
+			FVector2D childRelCoord(childX, childY);
+			ShownTileAt(i)->MoveToRelative(childRelCoord);
+		}
+		maxSlots -= lastSlot - range.First + 1;
+		if (lastSlot < range.Last) {
+			range.First = lastSlot + 1;
+			break;
+		}
+		numDone++;
+	}
+	dirtySlots_.Ranges.RemoveAt(0, numDone);
 }
 
-void HotHudTileGrid::Resize(int32 width, int32 height) {
-	HotHudControl::Resize(width, height);
-	numColumns_ = -1;
-	numRows_ = -1;
-	tilePositionsNeedRecalc_ = true;
+bool HotHudTileGrid::RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) {
+	// The column count isn't known until we've been drawn; Draw() queues the work again if needed.
+	if (work != HotHudWork_Layout || numColumns_ == -1) {
+		return true;
+	}
+	LayoutDirtySlots(kLayoutChunkSlots);
+	return dirtySlots_.IsEmpty();
 }
 
-void HotHudTileGrid::AddTiles(TMap<FName, HotHudControl*>* controlMap, const TArray<FName>& tileNames) {
-	for (const FName& tileName : tileNames) {
-		FControlGeometry geom;
-		geom.Height = cfg_.TileHeight;
-		geom.Width = cfg_.TileWidth;
-		HotHudTile* newTile = new HotHudTile(tileName, this, geom);
-		AddChildControl(newTile);
-		controlMap->Add(tileName, newTile);
-	}
-	tilePositionsNeedRecalc_ = true;
+void HotHudTileGrid::AccumulateMemoryStats(FHotHudMemoryStats& stats) const {
+	stats.TileGridBytes += sizeof(HotHudTileGrid) + BaseAllocatedSize() + viewOrder_.GetAllocatedSize() + viewLabelFilter_.GetAllocatedSize() +
+		dirtySlots_.Ranges.GetAllocatedSize() + staleViewSlots_.Ranges.GetAllocatedSize() + previousViewOrder_.GetAllocatedSize();
 }
 
-void HotHudTileGrid::AddChildControl(HotHudControl* child) {
-	HotHudControl::AddChildControl(child);
-	tilePositionsNeedRecalc_ = true;
+HotHudControl* HotHudTileGrid::FindTopMostControlAt(const FVector2D& location) {
+	if (!ContainsCoord(location)) {
+		return nullptr;
+	}
+	UpdateView();
+	if (numColumns_ <= 0 || !ClientRect().Contains(location)) {
+		return this;
+	}
+
+	// Shown positions go row by row from the top-left of the client area, one tile pitch apart.
+	FVector2D offset = location - (screenCoords_ + FVector2D(childOffsetLeft_, childOffsetTop_) - scrollOffset_);
+	int32 column = FMath::FloorToInt(offset.X / (Cfg().TileWidth + kTileSeparation));
+	int32 row = FMath::FloorToInt(offset.Y / (Cfg().TileHeight + kTileSeparation));
+	int32 position = row * numColumns_ + column;
+	if (column < 0 || column >= numColumns_ || row < 0 || position >= NumShownTiles() || IsSlotDirty(position)) {
+		return this;
+	}
+	HotHudTile* tile = ShownTileAt(position);
+	if (!tile->IsVisible()) {
+		return this;
+	}
+	HotHudControl* tileHit = tile->FindTopMostControlAt(location);
+	return tileHit == nullptr ? this : tileHit;
 }
 
-void HotHudTileGrid::Draw(AHotHud* hud, UCanvas* canvas) {
+void HotHudTileGrid::PrepareDraw(AHotHud* hud, UCanvas* canvas) {
+	if (styleRevision_ != style_->Revision) {
+		SyncStyle();
+	}
+
 	if (numColumns_ == -1) {
-		numColumns_ = geometry_.Width / (cfg_.TileWidth + kTileSeparation);
-		numRows_ = geometry_.Height / (cfg_.TileHeight + kTileSeparation);
-		UE_LOG(LogHUD, Warning, TEXT("TileGrid can contain %d columns and %d rows"), numColumns_, numRows_);
+		numColumns_ = FMath::Max(1, geometry_.Width / (Cfg().TileWidth + kTileSeparation));
+		numRows_ = geometry_.Height / (Cfg().TileHeight + kTileSeparation);
+		HOTHUD_TRACE_EVENT(HotHudTrace_Layout, HotHudTraceEvent_TileGridMeasured, name_, numColumns_, numRows_);
+	}
+
+	// Up to a screenful of slots is laid out right away (dirty slots which are on screen come first), the
+	// rest in chunks by the scheduler.
+	UpdateView();
+	if (!dirtySlots_.IsEmpty()) {
+		LayoutDirtySlots(numColumns_ * FMath::Max(numRows_, 1));
+		if (!dirtySlots_.IsEmpty() && !hud->DeferWork(this, HotHudWork_Layout, HotHudWorkPriority_Normal)) {
+			LayoutDirtySlots(MAX_int32);
+		}
 	}
+}
 
+void HotHudTileGrid::DrawChrome(AHotHud* hud, UCanvas* canvas) {
 	// Draw background.
-	hud->DrawRect(cfg_.BackgroundColor, screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
+	hud->DrawChromeRect(Faded(StyledColor(HotHudStyleOverride_BackgroundColor, Cfg().BackgroundColor)), screenCoords_.X, screenCoords_.Y, geometry_.Width, geometry_.Height);
 
 	// TODO(san): Draw border.
 
 	// TODO(san): Draw grid.
+}
 
-	// Recalculate tile positions if needed. This can happen when one of the following occurs:
-	//   1. A tile is added to or removed from the grid.
-	//   2. The grid is re-sized.
-	if (tilePositionsNeedRecalc_ && childControls_.Num() > 0) {
-		for (int i = 0; i < childControls_.Num(); i++) {
-			int childRow = i / numColumns_;
-			int childCol = i % numColumns_;
-			int childX = childCol * (cfg_.TileWidth + kTileSeparation);
-			int childY = childRow * (cfg_.TileHeight + kTileSeparation);
-
-			FVector2D childRelCoord(childX, childY);
-			childControls_[i]->MoveToRelative(childRelCoord);
+void HotHudTileGrid::AppendDrawableTiles(TArray<HotHudTile*>& tiles, const HotHudClipRect& clip) const {
+	HotHudClipRect visible = clip.Intersection(Bounds());
+	// A stale view is brought up to date by PrepareDraw(); until then its slots can't be trusted.
+	if (numColumns_ <= 0 || visible.MaxY <= visible.MinY || viewDirty_) {
+		return;
+	}
+	// Slots go row by row, so only the rows overlapping the visible rect need to be looked at.
+	float rowPitch = Cfg().TileHeight + kTileSeparation;
+	int32 firstRow = FMath::Max(0, FMath::FloorToInt((visible.MinY - screenCoords_.Y) / rowPitch));
+	int32 lastRow = FMath::FloorToInt((visible.MaxY - screenCoords_.Y) / rowPitch);
+	int32 firstSlot = firstRow * numColumns_;
+	int32 endSlot = FMath::Min(NumShownTiles(), (lastRow + 1) * numColumns_);
+	for (int32 i = firstSlot; i < endSlot; i++) {
+		// Tiles which are still waiting to be laid out aren't drawn.
+		if (IsSlotDirty(i)) {
+			continue;
+		}
+		HotHudTile* tile = ShownTileAt(i);
+		if (tile->IsVisible() && visible.Intersects(tile->ScreenCoords().X, tile->ScreenCoords().Y, tile->Geometry().Width, tile->Geometry().Height)) {
+			tiles.Add(tile);
 		}
-		tilePositionsNeedRecalc_ = false;
 	}
+}
 
-	// Draw children.
-	for (HotHudControl* child : childControls_) {
-		child->Draw(hud, canvas);
+void HotHudTileGrid::Draw(AHotHud* hud, UCanvas* canvas) {
+	PrepareDraw(hud, canvas);
+	DrawChrome(hud, canvas);
+	hud->FlushChrome();
+
+	TArray<HotHudTile*> tiles;
+	AppendDrawableTiles(tiles, Bounds());
+	DrawTileImages(hud, canvas, tiles);
+	for (HotHudTile* tile : tiles) {
+		tile->DrawText(hud, canvas);
 	}
+	hud->FlushText();
 }
@@ -24,12 +24,17 @@
  * Some of HotHuds notable features include:
  *  - Dynamic player movable windows with title-bars, borders..
  *  - Single / Multi-line player editable text-boxes.
+ *  - Labels which can be bound to live numbers (FPS, ammo, timers..) without per-frame allocations.
+ *  - Controls (text boxes, labels, tile labels and gauges) bound to UObject properties by path.
  *	- TileGrid controls for displaying lists of items which can be dragged & dropped
  *	  by the player.
  *	- Easy(?) to deal with co-ordinate system (controls are relative to their parent).
+ *  - Windows scroll (wheel & scroll-bars) when their contents don't fit, and clip what they draw.
+ *  - Split-screen players can share styles, text layout and tile images, or one whole set of controls.
+ *  - Controls can be hidden or collapsed individually; hidden subtrees cost nothing and keep their state.
+ *  - Draw commands can be captured to a file and diffed against a golden capture (Tools/HotHudCaptureTool.cpp).
  *
  * List of things I'm working on and hoping to get done soon:
- *  - Smart automatic scroll-bars.
  *  - More controls
  *  - Texture support for window chrome.
  *
@@ -43,9 +48,11 @@
  *  - Textures are not yet supported for window chrome. This will be changed once
  *    i have some good textures to use - as it turns out I suck at drawing ;)
  *  
- *  - Editable text boxes do not work yet.
+ *  - Mouse buttons and the wheel are picked up automatically, but the engine has no
+ *    generic key / character hook for HUDs, so games need to forward keyboard input
+ *    with HandleKeyInput() / HandleCharacterInput() (or AHotHud::InputKey() / InputChar()
+ *    from native code) for editable text boxes to receive it.
  *
- *  - TextBoxes do not scroll properly yet.
  *  - There are lots of internal code cleanups needed - this is very much a work in
  *    progress :).
  *
@@ -53,6 +60,13 @@
 #pragma once
 
 #include "GameFramework/HUD.h"
+#include "HotHudAtlas.h"
+#include "HotHudBinding.h"
+#include "HotHudCapture.h"
+#include "HotHudFormat.h"
+#include "HotHudStyle.h"
+#include "HotHudText.h"
+#include "HotHudTrace.h"
 #include "HotHud.generated.h"
 
 class AHotHud;
@@ -156,6 +170,106 @@ struct FTextBoxBuildOptions {
 	}
 };
 
+// What a TileGrid does with a tile which is dropped onto one of its slots.
+UENUM(BlueprintType)
+namespace ETileGridDropAction {
+	enum Type {
+		// The dropped tile and the tile in the target slot trade places.
+		Swap,
+		// The dropped tile is inserted at the target slot and the tiles in-between shift over by one.
+		Insert,
+		// Drops are left entirely to the blueprint.
+		None,
+	};
+}
+
+// What a TileGrid view orders its tiles by (see AHotHud::SortTileGrid()).
+UENUM(BlueprintType)
+namespace EHotHudTileSortBy {
+	enum Type {
+		// Slot order, i.e. unsorted.
+		Slot,
+		// Per-tile numeric keys (see AHotHud::SetTileSortKeys()), or the data source's item keys.
+		Key,
+		// Tile label, ignoring case.
+		Label,
+		// Tile name.
+		Name,
+	};
+}
+
+// Event trace categories (see AHotHud::SetTraceCategoryEnabled()). Mirrors HotHudTraceCategory.
+UENUM(BlueprintType)
+namespace EHotHudTraceCategory {
+	enum Type {
+		// The control under the mouse changing.
+		Hover,
+		// Window moves, tile drags & drops.
+		Interaction,
+		// Text boxes & tile grids measuring themselves.
+		Layout,
+		// Controls being created & deleted.
+		Lifecycle,
+	};
+}
+
+UENUM(BlueprintType)
+namespace ETextBoxCursorMove {
+	enum Type {
+		Left,
+		Right,
+		// Up & down move by (wrapped) row.
+		Up,
+		Down,
+		// Start / end of the current (wrapped) row.
+		Home,
+		End,
+	};
+}
+
+// Easing curves for tweens.
+UENUM(BlueprintType)
+namespace EHotHudEasing {
+	enum Type {
+		Linear,
+		// Quadratic ease in / out.
+		EaseIn,
+		EaseOut,
+		// Smoothstep.
+		EaseInOut,
+		// Cubic ease in / out.
+		EaseInCubic,
+		EaseOutCubic,
+	};
+}
+
+// How a label shows a bound number.
+UENUM(BlueprintType)
+namespace EHotHudNumberFormat {
+	enum Type {
+		// Rounded to a whole number.
+		Integer,
+		// One, two or three digits after the point.
+		Fixed1,
+		Fixed2,
+		Fixed3,
+		// Seconds as m:ss (h:mm:ss from an hour up).
+		Clock,
+	};
+}
+
+// How often a control bound with BindControlToProperty() re-reads its property.
+UENUM(BlueprintType)
+namespace EHotHudBindingRate {
+	enum Type {
+		EveryFrame,
+		// Ten times a second (of real time).
+		TenHz,
+		// Only when RefreshBindings() is called.
+		OnDemand,
+	};
+}
+
 // Contains visual-cfg options for a TileGrid.
 USTRUCT(BlueprintType)
 struct FTileGridBuildOptions {
@@ -177,12 +291,55 @@ struct FTileGridBuildOptions {
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
 		FLinearColor BackgroundColor;
 
+	// What to do when a (validated) tile is dropped onto this grid.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		TEnumAsByte<ETileGridDropAction::Type> DropAction;
+
+	// Set if tiles from other TileGrids may be dropped into this grid.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		bool AcceptForeignTiles;
+
 	FTileGridBuildOptions() {
 		TileWidth = 64;
 		TileHeight = 64;
 		MaxCols = 8;
 		MaxRows = 0;
 		BackgroundColor = FLinearColor(0, 0, 0, 0.5f);
+		DropAction = ETileGridDropAction::Swap;
+		AcceptForeignTiles = true;
+	}
+};
+
+// Contains visual-cfg options for a Gauge.
+USTRUCT(BlueprintType)
+struct FGaugeBuildOptions {
+	GENERATED_USTRUCT_BODY()
+
+	// Color of the empty part of the gauge.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		FLinearColor BackgroundColor;
+
+	// Color of the filled part of the gauge.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		FLinearColor FillColor;
+
+	// Values shown as an empty / full gauge. Values outside the range are clamped.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		float MinValue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		float MaxValue;
+
+	// Set if the gauge fills bottom to top rather than left to right.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+		bool Vertical;
+
+	FGaugeBuildOptions() {
+		BackgroundColor = FLinearColor(0, 0, 0, 0.5f);
+		FillColor = FLinearColor(0.2f, 0.8f, 0.2f, 1.0f);
+		MinValue = 0.0f;
+		MaxValue = 1.0f;
+		Vertical = false;
 	}
 };
 
@@ -210,11 +367,270 @@ struct FControlGeometry {
 	}
 };
 
+// Approximate heap usage of a HUD, in bytes. Control fields cover the control objects themselves;
+// the data they hold is split out by subsystem.
+USTRUCT(BlueprintType)
+struct FHotHudMemoryStats {
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 WindowBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TextBoxBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 LabelBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 GaugeBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TileGridBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TileBytes;
+
+	// TextBox scrollback and documents.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TextBytes;
+
+	// Tile labels and other fetched tile data.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TileDataBytes;
+
+	// Laid out glyph runs and the text batch.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 GlyphCacheBytes;
+
+	// Tile atlas pages (CPU shadow, CPU mip and GPU copies) and tables.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TileAtlasBytes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 StyleBytes;
+
+	// The HUD's own tables (control map, tweens, input queue..).
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 HudBytes;
+
+	// Sum of all of the above.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TotalBytes;
+
+	FHotHudMemoryStats() {
+		WindowBytes = 0;
+		TextBoxBytes = 0;
+		LabelBytes = 0;
+		GaugeBytes = 0;
+		TileGridBytes = 0;
+		TileBytes = 0;
+		TextBytes = 0;
+		TileDataBytes = 0;
+		GlyphCacheBytes = 0;
+		TileAtlasBytes = 0;
+		StyleBytes = 0;
+		HudBytes = 0;
+		TotalBytes = 0;
+	}
+};
+
+// Deferred work scheduler counters (see 'WorkBudgetMs').
+USTRUCT(BlueprintType)
+struct FHotHudWorkStats {
+	GENERATED_USTRUCT_BODY()
+
+	// Number of work items run during the last frame.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 LastFrameItemsRun;
+
+	// Time spent running work items during the last frame.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	float LastFrameTimeMs;
+
+	// Work items carried over to the next frame, per priority.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 PendingVisible;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 PendingNormal;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 PendingPrefetch;
+
+	// Number of frames which ended with work carried over.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 FramesWithDeferredWork;
+
+	// Number of work items run since the HUD was created.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TotalItemsRun;
+
+	FHotHudWorkStats() {
+		LastFrameItemsRun = 0;
+		LastFrameTimeMs = 0.0f;
+		PendingVisible = 0;
+		PendingNormal = 0;
+		PendingPrefetch = 0;
+		FramesWithDeferredWork = 0;
+		TotalItemsRun = 0;
+	}
+};
+
+// Results of a soak run (see AHotHud::StartSoak()).
+USTRUCT(BlueprintType)
+struct FHotHudSoakReport {
+	GENERATED_USTRUCT_BODY()
+
+	// Seed the operations were generated from. The same seed replays the same run.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 Seed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 OperationsRun;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 FramesRun;
+
+	// Control tree invariant violations found. The run stops at the first check which finds any,
+	// leaving the controls in place for inspection.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 InvariantViolations;
+
+	// Most controls alive at once.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 PeakControls;
+
+	// Time spent in the HUD per frame (the soak's operations, layout and drawing), or per step of a run
+	// without drawing (see AHotHud::RunSoak()).
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	float FrameMsP50;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	float FrameMsP99;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	float FrameMsMax;
+
+	// Memory tracked by GetMemoryStats() when the run started, at its peak and once the run's controls
+	// were deleted again.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TrackedBytesStart;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TrackedBytesPeak;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TrackedBytesEnd;
+
+	// Growth of the process' memory use over the run, once the run's controls were deleted. Catches
+	// leaks GetMemoryStats() can't see.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 ProcessKBGrowth;
+
+	FHotHudSoakReport() {
+		Seed = 0;
+		OperationsRun = 0;
+		FramesRun = 0;
+		InvariantViolations = 0;
+		PeakControls = 0;
+		FrameMsP50 = 0.0f;
+		FrameMsP99 = 0.0f;
+		FrameMsMax = 0.0f;
+		TrackedBytesStart = 0;
+		TrackedBytesPeak = 0;
+		TrackedBytesEnd = 0;
+		ProcessKBGrowth = 0;
+	}
+};
+
+// Hashing & comparison for interning anonymous styles (see THotHudStyleRegistry). Per-control fields
+// (window titles, initial text, ...) are not part of a style and are ignored.
+uint32 GetStyleHash(const FManagedWindowBuildOptions& options);
+bool StylesEqual(const FManagedWindowBuildOptions& a, const FManagedWindowBuildOptions& b);
+uint32 GetStyleHash(const FTextBoxBuildOptions& options);
+bool StylesEqual(const FTextBoxBuildOptions& a, const FTextBoxBuildOptions& b);
+uint32 GetStyleHash(const FTileGridBuildOptions& options);
+bool StylesEqual(const FTileGridBuildOptions& a, const FTileGridBuildOptions& b);
+uint32 GetStyleHash(const FGaugeBuildOptions& options);
+bool StylesEqual(const FGaugeBuildOptions& a, const FGaugeBuildOptions& b);
+
+typedef THotHudStyle<FManagedWindowBuildOptions> HotHudWindowStyle;
+typedef THotHudStyle<FTextBoxBuildOptions> HotHudTextBoxStyle;
+typedef THotHudStyle<FTileGridBuildOptions> HotHudTileGridStyle;
+typedef THotHudStyle<FGaugeBuildOptions> HotHudGaugeStyle;
+
+// Style fields a control can override without leaving its shared style.
+typedef enum HotHudStyleOverride {
+	HotHudStyleOverride_BackgroundColor = 1,
+	HotHudStyleOverride_TextColor = 2,
+};
+
+// Per-control exceptions to a shared style. Only allocated for controls which have any.
+struct HotHudStyleOverrides {
+	// HotHudStyleOverride bits of the fields which are set.
+	uint8 Mask;
+	FLinearColor BackgroundColor;
+	FLinearColor TextColor;
+
+	HotHudStyleOverrides() : Mask(0) {}
+};
+
+// Kinds of control work which can be deferred to the scheduler (see AHotHud::DeferWork()).
+typedef enum HotHudWorkType {
+	// Re-positioning a TileGrid's tiles.
+	HotHudWork_Layout,
+	// Measuring a TextBox's font.
+	HotHudWork_Measure,
+	// Fetching a tile's image & label.
+	HotHudWork_FetchTileData,
+	HotHudWork_NumTypes,
+};
+
+// Deferred work priorities, most urgent first.
+typedef enum HotHudWorkPriority {
+	// Needed by something which is being drawn.
+	HotHudWorkPriority_Visible,
+	HotHudWorkPriority_Normal,
+	// Speculative work, e.g. data for tiles which haven't been drawn yet.
+	HotHudWorkPriority_Prefetch,
+	HotHudWorkPriority_NumPriorities,
+};
+
+// An axis aligned screen rectangle, used for clipping & culling.
+struct HotHudClipRect {
+	float MinX;
+	float MinY;
+	float MaxX;
+	float MaxY;
+
+	HotHudClipRect() : MinX(0), MinY(0), MaxX(0), MaxY(0) {}
+	HotHudClipRect(float minX, float minY, float maxX, float maxY) : MinX(minX), MinY(minY), MaxX(maxX), MaxY(maxY) {}
+
+	// True if the X,Y,Width,Height rectangle overlaps / lies entirely within this one.
+	bool Intersects(float x, float y, float width, float height) const {
+		return x < MaxX && y < MaxY && x + width > MinX && y + height > MinY;
+	}
+	bool Contains(float x, float y, float width, float height) const {
+		return x >= MinX && y >= MinY && x + width <= MaxX && y + height <= MaxY;
+	}
+	bool Contains(const FVector2D& point) const {
+		return point.X >= MinX && point.X <= MaxX && point.Y >= MinY && point.Y <= MaxY;
+	}
+	HotHudClipRect Intersection(const HotHudClipRect& other) const {
+		return HotHudClipRect(FMath::Max(MinX, other.MinX), FMath::Max(MinY, other.MinY), FMath::Min(MaxX, other.MaxX), FMath::Min(MaxY, other.MaxY));
+	}
+};
+
 typedef enum HotHudControlType {
+	// Matches every type in lookups. No control has this type.
+	HotHudControl_Any = 0,
 	HotHudControl_Window = 1,
 	HotHudControl_TextBox = 2,
 	HotHudControl_Tile = 3,
 	HotHudControl_TileGrid = 4,
+	HotHudControl_Label = 5,
+	HotHudControl_Gauge = 6,
 };
 
 // Base implementation for a HotHud HUD control.
@@ -230,24 +646,56 @@ public:
 		HotHudControlType type, const FName& name, HotHudControl* parentName,
 		const FControlGeometry& geometry, bool isMovable, bool isDraggable);
 
-	virtual ~HotHudControl() {}
+	virtual ~HotHudControl() { delete styleOverrides_; }
 
 	virtual void Draw(AHotHud* hud, UCanvas* canvas) = 0;
 
 	virtual void AddChildControl(HotHudControl* child);
+	virtual void RemoveChildControl(HotHudControl* child);
 	virtual void MoveToRelative(const FVector2D& location);
 	virtual void Resize(int32 width, int32 height);
 	virtual UTexture2D* GetDragTexture() { return nullptr; }
 
-	// Returns the top-most (highest on the Z-order) control at the specified location.
+	// Returns the top-most (highest on the Z-order) control at the specified location. Children are
+	// only found within this control's client rect, which is also all that is drawn of them.
 	// May return NULL.
 	virtual HotHudControl* FindTopMostControlAt(const FVector2D& location);
 	bool ContainsCoord(const FVector2D& coord);
-
-	virtual void NotifyOnValidDrop(HotHudControl* sourceControl);
+	// Screen rect of the control / of the area its children are placed in (inside the chrome).
+	HotHudClipRect Bounds() const;
+	HotHudClipRect ClientRect() const;
+
+	// Called when a previously validated drag source is dropped onto this control.
+	virtual void NotifyOnValidDrop(AHotHud* hud, HotHudControl* sourceControl);
+
+	// Input handlers. Return true if the event was consumed; unconsumed wheel and key events are
+	// offered to the parent next. Delta is positive when the wheel is scrolled up.
+	virtual bool OnMouseWheel(float delta) { return false; }
+	virtual bool OnKeyDown(const FKey& key) { return false; }
+	virtual bool OnCharacter(TCHAR character) { return false; }
+	// Returns true if clicking this control should give it keyboard focus.
+	virtual bool IsFocusable() const { return false; }
+
+	// Adds the memory used by this control (but not its children) to Stats. TotalBytes is left alone.
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const = 0;
+
+	// Reads or writes (as Ar dictates) the state a HUD snapshot keeps for this control beyond what its
+	// constructor takes. Children are handled by the HUD. Overrides must call the base class first.
+	virtual void SerializeState(AHotHud* hud, FArchive& ar);
+
+	// Runs a piece of work deferred with AHotHud::DeferWork(). Returns true once Work is complete, or
+	// false if some remains, in which case it is run again when the scheduler next has time.
+	virtual bool RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) { return true; }
+	// Scheduler bookkeeping: whether Work is queued for this control at Priority.
+	bool IsWorkQueued(HotHudWorkType work, HotHudWorkPriority priority) const { return (queuedWork_ & WorkBit(work, priority)) != 0; }
+	void SetWorkQueued(HotHudWorkType work, HotHudWorkPriority priority) { queuedWork_ |= WorkBit(work, priority); }
+	// Clears Work at every priority, so any other queued entries for it are skipped.
+	void ClearQueuedWork(HotHudWorkType work) { queuedWork_ &= ~(((1 << HotHudWorkPriority_NumPriorities) - 1) << (work * HotHudWorkPriority_NumPriorities)); }
 
 	HotHudControlType Type() const { return type_; }
 	const FName& Name() const { return name_; }
+	HotHudControl* Parent() const { return parent_; }
+	const TArray<HotHudControl*>& Children() const { return childControls_; }
 	bool IsMovable() const { return isMovable_; }
 	bool IsDraggable() const { return isDraggable_; }
 	const FVector2D& ScreenCoords() const { return screenCoords_;  }
@@ -255,18 +703,56 @@ public:
 	int32 ChildOffsetRight() const { return childOffsetRight_; }
 	int32 ChildOffsetBottom() const { return childOffsetBottom_; }
 	int32 ChildOffsetLeft() const { return childOffsetLeft_; }
+	// Amount the children are scrolled by (positive moves them up & left).
+	const FVector2D& ScrollOffset() const { return scrollOffset_; }
 	const FControlGeometry& Geometry() const { return geometry_; }
 	bool IsMoving() const { return isMoving_; }
+	// Hidden controls - and everything under them - aren't laid out, drawn or hit-tested, but keep their
+	// place. Collapsed controls are hidden and also take up no room in their parent (window content size,
+	// tile grid slots). Either way cached layout and text are kept, so showing the control again is instant.
+	bool IsVisible() const { return isVisible_; }
+	bool IsCollapsed() const { return isCollapsed_; }
+	bool IsShown() const { return isVisible_ && !isCollapsed_; }
+	// True if neither this control nor any of its ancestors is hidden. Walks up the tree, so callers which
+	// keep asking cache the answer until ShownGeneration() changes.
+	bool IsShownInTree() const;
+	// Bumped whenever any control is shown, hidden or re-parented.
+	static int32 ShownGeneration() { return shownGeneration_; }
+	// True if this control is Ancestor or lies under it.
+	bool IsWithin(const HotHudControl* ancestor) const;
 	HotHudControl* ValidDragSource() const { return validDragSource_; }
+	float Opacity() const { return opacity_; }
+	// Opacity of this control multiplied by that of all its parents.
+	float EffectiveOpacity() const;
+	// Returns Color with its alpha scaled by EffectiveOpacity().
+	FLinearColor Faded(const FLinearColor& color) const;
+	// Returns this control's override of Field if it has one, otherwise StyleValue.
+	const FLinearColor& StyledColor(HotHudStyleOverride field, const FLinearColor& styleValue) const {
+		if (styleOverrides_ == nullptr || (styleOverrides_->Mask & field) == 0) {
+			return styleValue;
+		}
+		return (field == HotHudStyleOverride_BackgroundColor) ? styleOverrides_->BackgroundColor : styleOverrides_->TextColor;
+	}
 
 	void SetIsMoving(bool isMoving) { isMoving_ = isMoving; }
 	void SetIsDragging(bool isDragging) { isDragging_ = isDragging; }
 	void SetIsHovered(bool isHovered) { isHovered_ = isHovered; }
+	void SetIsFocused(bool isFocused) { isFocused_ = isFocused; }
+	void SetVisible(bool visible);
+	void SetCollapsed(bool collapsed);
+	void SetOpacity(float opacity) { opacity_ = FMath::Clamp(opacity, 0.0f, 1.0f); }
+	void SetStyleOverride(HotHudStyleOverride field, const FLinearColor& color);
+	void ClearStyleOverrides();
 	void SetValidDragSource(HotHudControl* validDragSource) { validDragSource_ = validDragSource; }
+	// Re-parents this control. Does not touch either parent's child list.
+	void SetParent(HotHudControl* parent);
 
 protected:
 	void RecomputeAbsolutePosition();
 	bool IsValidMove(const FVector2D& location);
+	// Bytes allocated by the base class (child list, style overrides).
+	int32 BaseAllocatedSize() const;
+	static uint16 WorkBit(HotHudWorkType work, HotHudWorkPriority priority) { return 1 << (work * HotHudWorkPriority_NumPriorities + priority); }
 
 	// Internal type identifier for this control.
 	HotHudControlType type_;
@@ -290,12 +776,26 @@ protected:
 	int childOffsetBottom_;
 	// Number of pixels this control needs for chrome on the left.
 	int childOffsetLeft_;
+	// Amount the children are scrolled by.
+	FVector2D scrollOffset_;
 	// Set if the control is currently being moved.
 	bool isMoving_;
 	// Set if the control is currently being dragged
 	bool isDragging_;
 	// Set if the control is currently being hovered over with the mouse.
 	bool isHovered_;
+	// Set if the control currently has keyboard focus.
+	bool isFocused_;
+	// See IsVisible() / IsCollapsed().
+	bool isVisible_;
+	bool isCollapsed_;
+	static int32 shownGeneration_;
+	// Opacity (0..1) applied to everything the control and its children draw.
+	float opacity_;
+	// Overrides of shared style fields. nullptr if there are none. Owned.
+	HotHudStyleOverrides* styleOverrides_;
+	// WorkBit()s of the deferred work queued for this control.
+	uint16 queuedWork_;
 	// Array of child controls. Pointers are owned.
 	TArray<HotHudControl*> childControls_;
 	// Pointer to the control which is currently being dragged over this one. It as assumed that
@@ -311,24 +811,72 @@ public:
 	// Construct a HotHudWindow.
 	// Name is the name of the window.
 	// Parent is the parent for this control. May be nullptr. Ownership not taken.
-	// IsMovable should be set if the window should allow being relocated by the user.
+	// Style is the shared style of the window.
 	// Title to be displayed on the titlebar of the window.
-	// TitleColor is the color to render the titlebar text in.
-	HotHudWindow(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const FManagedWindowBuildOptions& cfg);
+	// IsMovable should be set if the window should allow being relocated by the user.
+	HotHudWindow(
+		const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+		const TSharedRef<HotHudWindowStyle>& style, const FString& title, bool isMovable);
 
 	virtual ~HotHudWindow() {}
 
 	virtual void Draw(AHotHud* hud, UCanvas* canvas) override;
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const override;
+	// Windows scroll rather than shrinking children which don't fit.
+	virtual void AddChildControl(HotHudControl* child) override;
+	// Scrolls vertically. Returns false (so the parent gets a go) if already at the end.
+	virtual bool OnMouseWheel(float delta) override;
+
+	// Draw passes used by AHotHud's layered draw; Draw() runs them all. PrepareDraw() returns false if
+	// the window (and so everything in it) shouldn't be drawn.
+	bool PrepareDraw();
+	void DrawChrome(AHotHud* hud, UCanvas* canvas);
+	void DrawText(AHotHud* hud, UCanvas* canvas);
+
+	const FManagedWindowBuildOptions& Cfg() const { return style_->Options; }
+	const HotHudWindowStyle& Style() const { return *style_; }
+	void SetStyle(const TSharedRef<HotHudWindowStyle>& style);
+	const FString& Title() const { return title_; }
+
+	// Scrolls the children to Offset, clamped so the content always covers the client area.
+	void ScrollTo(const FVector2D& offset);
+	// Extent of the children, relative to the top-left of the client area.
+	const FVector2D& ContentSize() const { return contentSize_; }
+
+	// Handles a press at Location. Returns false if it isn't on a scrollbar. A press on a track but off
+	// the thumb first jumps the thumb there. Vertical is set to the bar which was hit and GrabOffset to
+	// where along the thumb it was grabbed, for DragScrollbar().
+	bool PressScrollbar(const FVector2D& location, bool& vertical, float& grabOffset);
+	// Scrolls so that the thumb of the Vertical (or horizontal) bar starts at ThumbStart (in screen pixels).
+	void DragScrollbar(bool vertical, float thumbStart);
 
 private:
-	static const int kWindowBorderWidth = 2;
-
-	void DrawTitlebar(AHUD* hud);
-	void DrawBorder(AHUD* hud);
-	void DrawBox(AHUD* hud, float x1, float y1, float x2, float y2, const FLinearColor& color);
+	// Refreshes state derived from the style.
+	void SyncStyle();
+	// Re-measures the content, decides which scrollbars are needed (adjusting the client area for them)
+	// and re-clamps the scroll offset.
+	void UpdateScrollbars();
+	// Screen rects of the track & thumb of a scrollbar. Returns false if the bar isn't shown.
+	bool GetScrollbarRects(bool vertical, HotHudClipRect& track, HotHudClipRect& thumb) const;
 
-	// Window cfg as provided by the BP.
-	FManagedWindowBuildOptions cfg_;
+	static const int kWindowBorderWidth = 2;
+	static const int kScrollbarWidth = 10;
+	static const int kScrollbarMinThumb = 16;
+	// Pixels scrolled per wheel notch.
+	static const int kWindowWheelPixels = 48;
+
+	void DrawBorder(AHotHud* hud);
+	void DrawScrollbars(AHotHud* hud);
+
+	// Shared style, and the style revision our derived state is for.
+	TSharedRef<HotHudWindowStyle> style_;
+	int32 styleRevision_;
+	FString title_;
+	// Cached layout of the title text.
+	TSharedPtr<HotHudGlyphRun> titleRun_;
+	FVector2D contentSize_;
+	bool hasHBar_;
+	bool hasVBar_;
 };
 
 // A n-line text-box..
@@ -338,34 +886,253 @@ public:
 	// Name is the name of the TextBox.
 	// ParentControl is the control which this panel is parented to. MUST NOT BE NULL.
 	// Geometry is the geometry of the TextBox.
-	HotHudTextBox(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const FTextBoxBuildOptions& cfg);
+	// Style is the shared style of the TextBox.
+	// Text is the initial text.
+	// Editable should be set if the TextBox can be edited.
+	HotHudTextBox(
+		const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+		const TSharedRef<HotHudTextBoxStyle>& style, const FString& text, bool editable);
 	virtual ~HotHudTextBox() {}
 
 	void PrintLine(const FString& line);
+	// Appends every line of Text (separated by '\n') as PrintLine() would, in one go. Long texts are
+	// split (and, if editable, wrapped) on the worker threads.
+	void AppendText(const FString& text);
 	void Clear();
 	virtual void Draw(AHotHud* hud, UCanvas* canvas) override;
 	virtual void Resize(int32 width, int32 height) override;
 
+	// Draw passes used by AHotHud's layered draw; Draw() runs them all.
+	void PrepareDraw(AHotHud* hud, UCanvas* canvas);
+	void DrawChrome(AHotHud* hud, UCanvas* canvas);
+	void DrawText(AHotHud* hud, UCanvas* canvas);
+	// Draws the caret.
+	void DrawOverlay(AHotHud* hud, UCanvas* canvas);
+
+	bool IsEditable() const { return editable_; }
+	const FTextBoxBuildOptions& Cfg() const { return style_->Options; }
+	const HotHudTextBoxStyle& Style() const { return *style_; }
+	void SetStyle(const TSharedRef<HotHudTextBoxStyle>& style);
+	// Replaces / returns the whole contents. Rows (or paragraphs when editable) are separated by '\n'.
+	void SetText(const FString& text);
+	FString GetText() const;
+
+	// Editing. These only apply to editable text boxes and act at the cursor.
+	void InsertText(const FString& text);
+	void DeleteCharacter(bool forward);
+	void MoveCursor(ETextBoxCursorMove::Type move);
+
+	virtual bool OnMouseWheel(float delta) override;
+	virtual bool OnKeyDown(const FKey& key) override;
+	virtual bool OnCharacter(TCHAR character) override;
+	virtual bool IsFocusable() const override { return editable_; }
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const override;
+	virtual bool RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) override;
+	virtual void SerializeState(AHotHud* hud, FArchive& ar) override;
+
+	// Drops the oldest rows of a read-only text box so that at most KeepRows remain. Editable text
+	// boxes are left alone. Returns the number of rows dropped.
+	int32 TrimScrollback(int32 keepRows);
+
 private:
+	// Refreshes state derived from the style.
+	void SyncStyle();
+	// Works out the row height and how many rows & columns fit, from the font.
+	void Measure(UCanvas* canvas);
+	// Draws the text of an editable text box from the scroll anchor down.
+	void DrawDocument(AHotHud* hud, UCanvas* canvas);
+	// Moves the scroll anchor the least amount needed to keep the cursor's row on screen.
+	void ScrollToCursor();
+	// Looks for the cursor's row within a screen's worth of rows from the scroll anchor and sets
+	// virtualCursorRow_ to it. Returns false (with virtualCursorRow_ past the last row) if it's off screen.
+	bool LocateCursorRow();
+	// Moves the scroll anchor of an editable text box by Rows (down if positive) without moving the cursor.
+	void ScrollDocument(int32 rows);
+	// Syncs the scroll anchor, virtual cursor and caret with the document after an edit.
+	void OnDocumentChanged(UCanvas* canvas);
+
 	static const int kTextBoxBorderTopHeight = 2;
 	static const int kTextBoxBorderLeftWidth = 2;
 	static const int kTextBoxBorderRightWidth = 2;
 	static const int kTextBoxBorderBottomHeight = 2;
-
-	// TextBox cfg as provided by the BP.
-	FTextBoxBuildOptions cfg_;
+	static const int kTextBoxCaretWidth = 2;
+	// Number of rows scrolled per wheel notch.
+	static const int kTextBoxWheelRows = 3;
+
+	// Shared style, and the style revision our derived state is for.
+	TSharedRef<HotHudTextBoxStyle> style_;
+	int32 styleRevision_;
+	bool editable_;
 	// Total number of columns we can fit given our font and size.
 	int numColumns_;
 	// Total number of rows we can fit given our font and size.
 	int numRows_;
 	// Height in pixels of a row of text.
 	int rowHeight_;
-	// Virtual cursor row.
+	// Virtual cursor row. For editable text boxes, the row of the cursor relative to the scroll anchor.
 	int virtualCursorRow_;
-	// Virtual cursor column.
+	// Virtual cursor column. For editable text boxes, the column of the cursor within its wrapped row.
 	int virtualCursorColumn_;
-	// An array of strings used as backing buffers (one string per row).
+	// An array of strings used as backing buffers (one string per row). Unused when editable.
 	TArray<FString> rowBuffer_;
+	// Cached layout of each row in rowBuffer_. Entries are filled in lazily when first drawn.
+	TArray<TSharedPtr<HotHudGlyphRun>> rowRuns_;
+	// Number of rows scrolled back from the newest rows of rowBuffer_.
+	int32 scrollbackOffset_;
+	// Contents of an editable text box.
+	HotHudTextDocument document_;
+	// First visible (paragraph, wrapped row) of an editable text box.
+	int32 scrollParagraph_;
+	int32 scrollRow_;
+	// Document revision the caret position was last measured for, and the measured offset.
+	int32 caretRevision_;
+	float caretX_;
+	// Scratch string for laying out rows, kept to avoid re-allocation.
+	FString rowScratch_;
+};
+
+// A single line of text, optionally bound to a live number which is formatted in place (with a fixed
+// prefix & suffix) and only re-laid out when the displayed value changes. Drawn with a TextBox style.
+class HotHudLabel : public HotHudControl {
+public:
+	// Construct a HotHudLabel.
+	// Name is the name of the Label.
+	// ParentControl is the control which this label is parented to. MUST NOT BE NULL.
+	// Geometry is the geometry of the Label.
+	// Style is the shared style of the Label. Only the font, colors and scale are used.
+	// Text is the initial (unbound) text.
+	HotHudLabel(
+		const FName& name, HotHudControl* parent, const FControlGeometry& geometry,
+		const TSharedRef<HotHudTextBoxStyle>& style, const FString& text);
+	virtual ~HotHudLabel() { delete binding_; }
+
+	virtual void Draw(AHotHud* hud, UCanvas* canvas) override;
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const override;
+	// Bindings are native and aren't kept; the label restores showing its last text.
+	virtual void SerializeState(AHotHud* hud, FArchive& ar) override;
+
+	// Draw passes used by AHotHud's layered draw; Draw() runs them all. PrepareDraw() samples the binding.
+	void PrepareDraw(AHotHud* hud, UCanvas* canvas);
+	void DrawChrome(AHotHud* hud, UCanvas* canvas);
+	void DrawText(AHotHud* hud, UCanvas* canvas);
+
+	const FTextBoxBuildOptions& Cfg() const { return style_->Options; }
+	const HotHudTextBoxStyle& Style() const { return *style_; }
+	void SetStyle(const TSharedRef<HotHudTextBoxStyle>& style);
+
+	// Shows fixed text. Removes any binding.
+	void SetText(const FString& text);
+	const FString& GetText() const { return text_; }
+	// Sets the text shown before / after a bound value.
+	void SetAffixes(const FString& prefix, const FString& suffix);
+
+	// Binds the label to Binding (ownership taken), replacing any previous binding. nullptr unbinds and
+	// leaves the last value showing.
+	void SetBinding(HotHudLabelBinding* binding);
+	// Binds to a number read through Value every frame, e.g. BindPointer<THotHudFixedFormat<1>>(&Fps).
+	template <typename FormatType, typename ValueType>
+	void BindPointer(const ValueType* value) {
+		SetBinding(MakeHotHudLabelBinding<FormatType>(THotHudPointerReader<ValueType>(value)));
+	}
+	// Binds to the number returned by Function (any callable, e.g. a lambda) every frame.
+	template <typename FormatType, typename FunctionType>
+	void BindFunction(const FunctionType& function) {
+		SetBinding(MakeHotHudLabelBinding<FormatType>(function));
+	}
+
+private:
+	// Rebuilds text_ from the affixes and the last formatted value.
+	void ComposeText();
+
+	// Shared style.
+	TSharedRef<HotHudTextBoxStyle> style_;
+	// Source of the displayed value. May be nullptr. Owned.
+	HotHudLabelBinding* binding_;
+	FString prefix_;
+	FString suffix_;
+	// Last formatted value.
+	TCHAR value_[kHotHudFormatCapacity];
+	int32 valueLen_;
+	// Displayed text. Rebuilt in place, so its allocation is reused.
+	FString text_;
+	// Cached layout of text_.
+	TSharedPtr<HotHudGlyphRun> run_;
+};
+
+// A bar which fills in proportion to a value, e.g. health or a reload timer.
+class HotHudGauge : public HotHudControl {
+public:
+	// Construct a HotHudGauge.
+	// Name is the name of the Gauge.
+	// ParentControl is the control which this gauge is parented to. MUST NOT BE NULL.
+	// Geometry is the geometry of the Gauge.
+	// Style is the shared style of the Gauge.
+	HotHudGauge(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const TSharedRef<HotHudGaugeStyle>& style);
+	virtual ~HotHudGauge() {}
+
+	virtual void Draw(AHotHud* hud, UCanvas* canvas) override;
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const override;
+	virtual void SerializeState(AHotHud* hud, FArchive& ar) override;
+
+	// Draw pass used by AHotHud's layered draw. Gauges are chrome only.
+	void DrawChrome(AHotHud* hud, UCanvas* canvas);
+
+	const FGaugeBuildOptions& Cfg() const { return style_->Options; }
+	const HotHudGaugeStyle& Style() const { return *style_; }
+	void SetStyle(const TSharedRef<HotHudGaugeStyle>& style);
+	float Value() const { return value_; }
+	void SetValue(float value) { value_ = value; }
+
+private:
+	// Shared style.
+	TSharedRef<HotHudGaugeStyle> style_;
+	float value_;
+};
+
+class HotHudTileGrid;
+
+// Native source of tile content for a TileGrid. Implement this in C++ and bind it with
+// AHotHud::SetTileGridDataSource() to drive a grid by item index rather than through the
+// 'ReceiveTileInfoRequest' event. Implementations report changes through the Notify* methods so
+// that only the affected tiles are created, destroyed or re-fetched.
+class HotHudTileDataSource {
+public:
+	HotHudTileDataSource() {}
+	virtual ~HotHudTileDataSource();
+
+	// Number of items (and therefore tiles) this source provides.
+	virtual int32 NumItems() const = 0;
+	// Texture to display for item Index. May be nullptr.
+	virtual UTexture2D* GetItemTexture(int32 index) const = 0;
+	// Label to draw over item Index. May be empty.
+	virtual FString GetItemLabel(int32 index) const { return FString(); }
+	// True if item Index can be dragged by the player.
+	virtual bool IsItemDraggable(int32 index) const { return true; }
+	// Sort key of item Index for grid views sorted by EHotHudTileSortBy::Key.
+	virtual float GetItemSortKey(int32 index) const { return 0.0f; }
+	// False to leave item Index out of filtered grid views.
+	virtual bool IsItemShown(int32 index) const { return true; }
+
+	// Called when the player drops item FromIndex onto slot ToIndex of a grid bound to this source.
+	// The source owns the ordering, so it should re-order its items and Notify accordingly.
+	// Swap is set if the grid is configured to swap rather than insert. Default ignores the drop.
+	virtual void RequestMoveItem(int32 fromIndex, int32 toIndex, bool swap) {}
+
+protected:
+	// Item Index changed; its tile is re-fetched on the next draw.
+	void NotifyItemChanged(int32 index);
+	// Count items were inserted before Index.
+	void NotifyItemsInserted(int32 index, int32 count);
+	// Count items starting at Index were removed.
+	void NotifyItemsRemoved(int32 index, int32 count);
+	// Everything changed. Every tile is rebuilt.
+	void NotifyReset();
+
+private:
+	friend class HotHudTileGrid;
+
+	// Grids currently bound to this source. Pointers not owned.
+	TArray<HotHudTileGrid*> boundGrids_;
 };
 
 // A drag & droppable tile.
@@ -380,11 +1147,89 @@ public:
 
 	virtual void Draw(AHotHud* hud, UCanvas* canvas) override;
 	virtual UTexture2D* GetDragTexture() override;
+	virtual void NotifyOnValidDrop(AHotHud* hud, HotHudControl* sourceControl) override;
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const override;
+	virtual bool RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) override;
+	// Keeps the image (by asset path) and label, so a restored tile doesn't need to fetch them again.
+	virtual void SerializeState(AHotHud* hud, FArchive& ar) override;
+
+	// Index of the grid slot this tile currently occupies.
+	int32 SlotIndex() const { return slotIndex_; }
+	void SetSlotIndex(int32 slotIndex) { slotIndex_ = slotIndex; }
+
+	// Causes the tile's image, label & draggable flag to be fetched again on the next draw.
+	void InvalidateTileData() { tileDataFetched_ = false; }
+	const FString& Label() const { return tileText_; }
+
+	// Sort key & filter flag used by the grid's view (unless the grid has a data source). They stay
+	// with the tile as it moves between slots. Call HotHudTileGrid::InvalidateView() after changing them.
+	float SortKey() const { return sortKey_; }
+	void SetSortKey(float sortKey) { sortKey_ = sortKey; }
+	bool IsFilteredOut() const { return isFilteredOut_; }
+	void SetFilteredOut(bool isFilteredOut) { isFilteredOut_ = isFilteredOut; }
+
+	// Draws the tile as part of a grid. If the tile's image is in Atlas (may be nullptr) a quad is
+	// appended to the atlas page batch instead of drawing it; the grid submits the batches.
+	void DrawImage(AHotHud* hud, UCanvas* canvas, HotHudTextureAtlas* atlas);
+	// Draws the tile's label (if any).
+	void DrawText(AHotHud* hud, UCanvas* canvas);
+	UTexture2D* Image() const { return tileImage_; }
+
+	// Key of the tile's image in the tile atlas. 0 if the image isn't atlased.
+	uint64 AtlasKey() const { return atlasKey_; }
+	// GFrameCounter when the tile's image was last drawn.
+	uint64 LastDrawnFrame() const { return lastDrawnFrame_; }
+	// Drops the tile's image, atlas entry & label. They are fetched again if the tile is drawn.
+	void ReleaseTileData(AHotHud* hud);
+	// Shows Text as the label, in place of the fetched one, until ClearBoundLabel() is called.
+	void SetBoundLabel(const FString& text);
+	void ClearBoundLabel();
 
 private:
+	// Pulls tile info from the grid's data source if it has one, or from the blueprint otherwise.
+	void FetchTileData(AHotHud* hud);
+	// Rebuilds the parent grid's view, if it has one, after the label changed.
+	void InvalidateGridView();
+
+	// Slot in the parent TileGrid. Maintained by the grid so drops don't need to search for it.
+	int32 slotIndex_;
 	bool tileDataFetched_;
 	UTexture2D* tileImage_;
 	FString tileText_;
+	// Key of tileImage_ in the HUD's tile atlas (0 if not atlased).
+	uint64 atlasKey_;
+	// Cached layout of tileText_.
+	TSharedPtr<HotHudGlyphRun> labelRun_;
+	// Set while tileText_ comes from a property binding rather than the tile data.
+	bool labelIsBound_;
+	uint64 lastDrawnFrame_;
+	float sortKey_;
+	bool isFilteredOut_;
+};
+
+// An inclusive run of slots.
+struct HotHudSlotRange {
+	int32 First;
+	int32 Last;
+};
+
+// A set of slots kept as sorted, disjoint ranges, so that a run of slots costs as much as one slot
+// and scattered slots don't drag in everything between them.
+struct HotHudSlotSet {
+	// Sorted, with a gap of at least one slot between neighbours.
+	TArray<HotHudSlotRange> Ranges;
+
+	bool IsEmpty() const { return Ranges.Num() == 0; }
+	void Reset() { Ranges.Reset(); }
+	// Adds [First, Last], merging it with the ranges it overlaps or touches.
+	void Add(int32 first, int32 last);
+	bool Contains(int32 slot) const;
+	// Drops every slot after LastSlot.
+	void Truncate(int32 lastSlot);
+
+private:
+	// Index of the first range ending at or after Slot (Ranges.Num() if none does).
+	int32 FindRange(int32 slot) const;
 };
 
 // A panel which contains a grid of tiles which are HotHud by col/row instead of x,y.
@@ -394,28 +1239,388 @@ public:
 	// Name is the name of the TileGrid.
 	// ParentControl is the control which this panel is parented to. MUST NOT BE NULL.
 	// 
-	HotHudTileGrid(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const FTileGridBuildOptions& cfg);
-	virtual ~HotHudTileGrid() {}
+	// Style is the shared style of the TileGrid.
+	HotHudTileGrid(const FName& name, HotHudControl* parent, const FControlGeometry& geometry, const TSharedRef<HotHudTileGridStyle>& style);
+	virtual ~HotHudTileGrid();
 
 	virtual void AddTiles(TMap<FName, HotHudControl*>* controlMap, const TArray<FName>& tileNames);
 
 	virtual void Draw(AHotHud* hud, UCanvas* canvas) override;
 	virtual void Resize(int32 width, int32 height) override;
 	virtual void AddChildControl(HotHudControl* child) override;
-
-	const FTileGridBuildOptions& Cfg() const { return cfg_;  }
+	virtual void RemoveChildControl(HotHudControl* child) override;
+	virtual void NotifyOnValidDrop(AHotHud* hud, HotHudControl* sourceControl) override;
+	virtual void AccumulateMemoryStats(FHotHudMemoryStats& stats) const override;
+	virtual bool RunDeferredWork(AHotHud* hud, UCanvas* canvas, HotHudWorkType work) override;
+	// Looks the position up from the row & column under Location rather than testing every tile.
+	virtual HotHudControl* FindTopMostControlAt(const FVector2D& location) override;
+
+	// The view: which tiles are shown, and in what order. Tiles keep their slots (and fetched data); the
+	// view only decides where each one is shown.
+	// Shows the tiles sorted by SortBy. Ties are shown in slot order.
+	void SetViewSort(EHotHudTileSortBy::Type sortBy, bool descending);
+	// Leaves out tiles which are filtered out (or not shown by the data source) if UseFilterFlags is set,
+	// and those whose label doesn't contain LabelFilter if it isn't empty.
+	void SetViewFilter(bool useFilterFlags, const FString& labelFilter);
+	void ClearView();
+	// Rebuilds the view on the next draw, e.g. after sort keys or filter flags changed.
+	void InvalidateView();
+	// Recomputes the view if it is stale, and marks the shown positions whose tile changed for
+	// re-layout. Done before the grid is laid out, drawn or hit-tested.
+	void UpdateView();
+	bool HasView() const { return viewSortBy_ != EHotHudTileSortBy::Slot || viewUsesFilterFlags_ || !viewLabelFilter_.IsEmpty() || viewSkipsCollapsed_; }
+	// Called when one of the grid's tiles is collapsed or expanded. Collapsed tiles are left out of the view.
+	void OnTileCollapsedChanged();
+	// Number of tiles shown and the tile at a shown position.
+	int32 NumShownTiles() const { return HasView() ? viewOrder_.Num() : childControls_.Num(); }
+	HotHudTile* ShownTileAt(int32 position) const { return TileAt(HasView() ? viewOrder_[position] : position); }
+
+	// Moves the tile in slot FromSlot to ToSlot, shifting the tiles in-between by one.
+	// Returns false if either slot is out of range.
+	bool MoveTile(int32 fromSlot, int32 toSlot);
+	// Exchanges the tiles in two slots. Returns false if either slot is out of range.
+	bool SwapTiles(int32 firstSlot, int32 secondSlot);
+	// Inserts Tile at Slot (clamped to the end of the grid). The tile may currently live in
+	// another grid, in which case it is removed from there first.
+	void InsertTile(HotHudTile* tile, int32 slot);
+
+	// Handles a validated drop of SourceControl onto TargetSlot (INDEX_NONE for the grid background).
+	void HandleTileDrop(AHotHud* hud, HotHudControl* sourceControl, int32 targetSlot);
+
+	// Binds the grid to a native data source (or unbinds it if Source is nullptr). Any existing tiles
+	// are destroyed and one tile per source item is created. Ownership of Source not taken.
+	void SetDataSource(AHotHud* hud, HotHudTileDataSource* source);
+
+	int32 NumTiles() const { return childControls_.Num(); }
+	HotHudTile* TileAt(int32 slot) const { return static_cast<HotHudTile*>(childControls_[slot]); }
+	HotHudTileDataSource* DataSource() const { return dataSource_; }
+	const FTileGridBuildOptions& Cfg() const { return style_->Options; }
+	const HotHudTileGridStyle& Style() const { return *style_; }
+
+	// Draw passes used by AHotHud's layered draw; Draw() runs them all. Tiles are drawn through their
+	// own passes once the grid has appended the ones which are ready.
+	void PrepareDraw(AHotHud* hud, UCanvas* canvas);
+	void DrawChrome(AHotHud* hud, UCanvas* canvas);
+	// Appends the laid out tiles which overlap both Clip and the grid.
+	void AppendDrawableTiles(TArray<HotHudTile*>& tiles, const HotHudClipRect& clip) const;
+	void SetStyle(const TSharedRef<HotHudTileGridStyle>& style);
 
 private:
-	const static int kTileSeparation = 2;
+	friend class HotHudTileDataSource;
 
-	// TileGrid cfg as provided by the BP.
-	FTileGridBuildOptions cfg_;
+	const static int kTileSeparation = 2;
+	// Number of off screen slots laid out per deferred layout work item.
+	const static int kLayoutChunkSlots = 256;
+
+	// Data source change handlers.
+	void OnSourceItemChanged(int32 index);
+	void OnSourceItemsInserted(int32 index, int32 count);
+	void OnSourceItemsRemoved(int32 index, int32 count);
+	void OnSourceReset();
+	// Creates an (unregistered with the grid) tile for a data source item and registers it with the HUD.
+	HotHudTile* CreateSourceTile();
+	// Unregisters and destroys Count tiles starting at Slot.
+	void DestroyTiles(int32 slot, int32 count);
+
+	// Refreshes the slot index of every tile in [FirstSlot, LastSlot] and marks them for re-layout.
+	void RenumberSlots(int32 firstSlot, int32 lastSlot);
+	// Adds [FirstSlot, LastSlot] to the slots which need to be re-positioned. While a view is active
+	// these are shown positions rather than slots.
+	void MarkSlotsDirty(int32 firstSlot, int32 lastSlot);
+	// Fills viewOrder_ with the slots the view shows, in the order it shows them.
+	void BuildViewOrder();
+	// Re-positions up to MaxSlots of the dirty slots, front first (and only those).
+	void LayoutDirtySlots(int32 maxSlots);
+	bool IsSlotDirty(int32 slot) const { return dirtySlots_.Contains(slot); }
+	// Refreshes state derived from the style.
+	void SyncStyle();
+
+	// Shared style, and the style revision our derived state is for.
+	TSharedRef<HotHudTileGridStyle> style_;
+	int32 styleRevision_;
 	// Total number of columns we can fit.
 	int numColumns_;
 	// Total number of rows we can fit.
 	int numRows_;
-	// Set when something changes that requires us to recompute child tile locations.
-	bool tilePositionsNeedRecalc_;
+	// Slots whose tiles need their location recomputed.
+	HotHudSlotSet dirtySlots_;
+	// Native source of tile content. May be nullptr. Not owned.
+	HotHudTileDataSource* dataSource_;
+	// HUD which owns this grid. Only set while bound to a data source. Not owned.
+	AHotHud* hud_;
+	// Counter used to give data source tiles unique names.
+	int32 nextSourceTileNumber_;
+	// The view (see SetViewSort()). viewOrder_ holds the slot shown at each position while HasView().
+	EHotHudTileSortBy::Type viewSortBy_;
+	bool viewDescending_;
+	bool viewUsesFilterFlags_;
+	FString viewLabelFilter_;
+	bool viewDirty_;
+	// Set while some of the tiles may be collapsed. Cleared by UpdateView() once none are.
+	bool viewSkipsCollapsed_;
+	TArray<int32> viewOrder_;
+	// Whether viewOrder_ was built for a view, and the order before the last rebuild (kept to compare
+	// against, and to reuse its allocation).
+	bool viewIsBuilt_;
+	TArray<int32> previousViewOrder_;
+	// Slots renumbered since the view was built.
+	HotHudSlotSet staleViewSlots_;
+};
+
+// The controls of one z-layer, bucketed by type for AHotHud's draw pass. A layer is a window and its
+// descendants, minus sub-windows which get layers of their own on top. Each pass draws a whole bucket,
+// which only keeps overlap order if no control overlaps an earlier one; a control which does (other
+// than its own ancestors) starts a new layer, drawn on top and without the window.
+struct HotHudDrawLayer {
+	TArray<HotHudWindow*> Windows;
+	TArray<HotHudTextBox*> TextBoxes;
+	TArray<HotHudLabel*> Labels;
+	TArray<HotHudGauge*> Gauges;
+	TArray<HotHudTileGrid*> TileGrids;
+	TArray<HotHudTile*> Tiles;
+	// Every control above gathered directly (not a grid's tiles), checked by Overlaps(), and the
+	// rect which bounds them all.
+	TArray<HotHudControl*> Occupants;
+	HotHudClipRect OccupiedBounds;
+	// Set if anything in the layer pokes out of the window's client rect, so its images & text need masking.
+	bool ClipContent;
+
+	HotHudDrawLayer() : ClipContent(false) {}
+
+	void Reset() {
+		Windows.Reset();
+		TextBoxes.Reset();
+		Labels.Reset();
+		Gauges.Reset();
+		TileGrids.Reset();
+		Tiles.Reset();
+		Occupants.Reset();
+		OccupiedBounds = HotHudClipRect();
+		ClipContent = false;
+	}
+	void AddOccupant(HotHudControl* control) {
+		HotHudClipRect bounds(control->ScreenCoords().X, control->ScreenCoords().Y,
+			control->ScreenCoords().X + control->Geometry().Width, control->ScreenCoords().Y + control->Geometry().Height);
+		if (Occupants.Num() == 0) {
+			OccupiedBounds = bounds;
+		}
+		else {
+			OccupiedBounds = HotHudClipRect(FMath::Min(OccupiedBounds.MinX, bounds.MinX), FMath::Min(OccupiedBounds.MinY, bounds.MinY),
+				FMath::Max(OccupiedBounds.MaxX, bounds.MaxX), FMath::Max(OccupiedBounds.MaxY, bounds.MaxY));
+		}
+		Occupants.Add(control);
+	}
+	// True if Control would be drawn out of order in this layer: it overlaps a control already in the
+	// layer which isn't one of its ancestors (children are expected to sit on their parent).
+	bool Overlaps(const HotHudControl* control) const {
+		float x = control->ScreenCoords().X;
+		float y = control->ScreenCoords().Y;
+		// Controls laid out one after another never reach the occupants (nor does anything in an empty layer).
+		if (Occupants.Num() == 0 || !OccupiedBounds.Intersects(x, y, control->Geometry().Width, control->Geometry().Height)) {
+			return false;
+		}
+		for (const HotHudControl* occupant : Occupants) {
+			HotHudClipRect bounds(occupant->ScreenCoords().X, occupant->ScreenCoords().Y,
+				occupant->ScreenCoords().X + occupant->Geometry().Width, occupant->ScreenCoords().Y + occupant->Geometry().Height);
+			if (!bounds.Intersects(x, y, control->Geometry().Width, control->Geometry().Height)) {
+				continue;
+			}
+			const HotHudControl* ancestor = control->Parent();
+			while (ancestor != nullptr && ancestor != occupant) {
+				ancestor = ancestor->Parent();
+			}
+			if (ancestor == nullptr) {
+				return true;
+			}
+		}
+		return false;
+	}
+	int32 GetAllocatedSize() const {
+		return Windows.GetAllocatedSize() + TextBoxes.GetAllocatedSize() + Labels.GetAllocatedSize() +
+			Gauges.GetAllocatedSize() + TileGrids.GetAllocatedSize() + Tiles.GetAllocatedSize() + Occupants.GetAllocatedSize();
+	}
+};
+
+// Native drop-target validator. Given the names of the control being dragged and the control under
+// the cursor, returns true if the drop is allowed. Bound from C++ to keep validation out of the BP VM.
+DECLARE_DELEGATE_RetVal_TwoParams(bool, FHotHudValidateDropTarget, const FName&, const FName&);
+
+// Control property animated by a tween.
+typedef enum HotHudTweenProperty {
+	HotHudTween_Position,
+	HotHudTween_Size,
+	// Only X is used.
+	HotHudTween_Opacity,
+	HotHudTween_NumProperties,
+};
+
+// Active tweens. Each field lives in its own contiguous array so that a frame's worth of tweens is
+// stepped in a few branch-free loops; every easing curve is a cubic polynomial for the same reason.
+class HotHudTweenSet {
+public:
+	// Starts a tween of Property on Control, replacing any running tween of the same property.
+	void Add(HotHudControl* control, HotHudTweenProperty property, const FVector2D& from, const FVector2D& to,
+		float startTime, float duration, EHotHudEasing::Type easing);
+	// Removes every tween of Control, parked or not.
+	void Remove(HotHudControl* control);
+	// Parks the tweens of Control: they stop advancing and are left out of Num() until UpdateParked()
+	// finds the control shown again.
+	void Park(HotHudControl* control, float now);
+	// Parks the tweens of controls which aren't shown, and resumes parked ones whose control is shown
+	// again from where they stopped.
+	void UpdateParked(float now);
+	// Removes tweens which reached their end in the last Step().
+	void RemoveFinished();
+
+	// Advances every tween to Now, updating Value() and IsFinished().
+	void Step(float now);
+
+	// Number of running (not parked) tweens.
+	int32 Num() const { return controls_.Num(); }
+	HotHudControl* Control(int32 index) const { return controls_[index]; }
+	HotHudTweenProperty Property(int32 index) const { return (HotHudTweenProperty)properties_[index]; }
+	const FVector2D& Value(int32 index) const { return values_[index]; }
+	const FVector2D& Target(int32 index) const { return to_[index]; }
+	bool IsFinished(int32 index) const { return progress_[index] >= 1.0f; }
+	int32 GetAllocatedSize() const;
+
+private:
+	// A tween taken out of the arrays while its control is hidden.
+	struct ParkedTween {
+		HotHudControl* Control;
+		uint8 Property;
+		// Time it had been running for when parked.
+		float Elapsed;
+		float InvDuration;
+		float EaseA;
+		float EaseB;
+		float EaseC;
+		FVector2D From;
+		FVector2D To;
+		FVector2D Value;
+	};
+
+	// Finds the tween of Property on Control or appends an (uninitialized) one. Returns its index.
+	int32 FindOrAddSlot(HotHudControl* control, HotHudTweenProperty property, const FVector2D& from);
+	void RemoveAt(int32 index);
+	void ParkAt(int32 index, float now);
+	void RemoveParkedAt(int32 index);
+
+	TArray<HotHudControl*> controls_;
+	TArray<uint8> properties_;
+	TArray<float> startTimes_;
+	TArray<float> invDurations_;
+	// Easing polynomial: E(t) = t * (A + t * (B + t * C)).
+	TArray<float> easeA_;
+	TArray<float> easeB_;
+	TArray<float> easeC_;
+	TArray<FVector2D> from_;
+	TArray<FVector2D> to_;
+	// Outputs of the last Step().
+	TArray<float> progress_;
+	TArray<FVector2D> values_;
+	TArray<ParkedTween> parked_;
+	// Index of each control's tween of a property, per property, in the arrays above and in parked_.
+	// Kept up to date as removals swap the last tween into the gap.
+	TMap<HotHudControl*, int32> indices_[HotHudTween_NumProperties];
+	TMap<HotHudControl*, int32> parkedIndices_[HotHudTween_NumProperties];
+};
+
+// A piece of deferred control work. Controls are referred to by name so that entries for controls
+// deleted while queued simply fail to resolve.
+struct HotHudWorkItem {
+	FName Control;
+	HotHudWorkType Type;
+};
+
+// State of a running soak (see AHotHud::StartSoak()).
+struct HotHudSoakState {
+	FRandomStream Random;
+	int32 OperationsLeft;
+	int32 OperationsPerFrame;
+	// Controls the soak created, by type. Entries for controls deleted along with an ancestor are
+	// dropped when they are next picked.
+	TArray<FName> Windows;
+	TArray<FName> TextBoxes;
+	TArray<FName> TileGrids;
+	// Numbers the names of created controls.
+	int32 NextName;
+	TArray<float> FrameTimesMs;
+	uint64 StartProcessBytes;
+	FHotHudSoakReport Report;
+
+	HotHudSoakState(int32 seed, int32 numOperations, int32 operationsPerFrame)
+		: Random(seed),
+		OperationsLeft(numOperations),
+		OperationsPerFrame(operationsPerFrame),
+		NextName(0),
+		StartProcessBytes(0) {
+		Report.Seed = seed;
+	}
+};
+
+// A control bound to an object property (see AHotHud::BindControlToProperty()).
+struct HotHudPropertyBinding {
+	// Bound control. Bindings are removed when their control is forgotten, so this is always live.
+	HotHudControl* Control;
+	TWeakObjectPtr<UObject> Object;
+	HotHudPropertyPath Path;
+	EHotHudBindingRate::Type Rate;
+	// Real time at which a TenHz binding is next read.
+	float NextPollTime;
+	// Set once a value has been pushed to the control; until then any value counts as a change.
+	bool HasValue;
+	// Whether the control was shown when HotHudControl::ShownGeneration() was ShownGeneration. Bindings
+	// of hidden controls aren't read, and are read again as soon as the control is shown.
+	bool ControlShown;
+	int32 ShownGeneration;
+	// Set to read the property on the next poll regardless of Rate.
+	bool RefreshRequested;
+	// Last value pushed to the control. Numeric paths only use LastNumber, others only LastText.
+	double LastNumber;
+	FString LastText;
+};
+
+// A raw input event, queued as it arrives and dispatched to controls on the next DrawHUD.
+struct HotHudInputEvent {
+	enum EventType {
+		MouseMove,
+		ButtonDown,
+		ButtonUp,
+		Wheel,
+		Key,
+		Character,
+	};
+
+	EventType Type;
+	// Mouse location when the event arrived.
+	FVector2D Location;
+	// Key pressed, for Key events.
+	FKey Key;
+	// Wheel notches (positive is up), for Wheel events.
+	float WheelDelta;
+	// Character typed, for Character events.
+	TCHAR Char;
+};
+
+// Resources which don't depend on a player: styles, laid out text and the tile atlas. Held by reference
+// so that the HUDs of split-screen players can share one set (see AHotHud::ShareResources).
+struct HotHudSharedResources {
+	THotHudStyleRegistry<FManagedWindowBuildOptions> WindowStyles;
+	THotHudStyleRegistry<FTextBoxBuildOptions> TextBoxStyles;
+	THotHudStyleRegistry<FTileGridBuildOptions> TileGridStyles;
+	THotHudStyleRegistry<FGaugeBuildOptions> GaugeStyles;
+	HotHudGlyphRunCache GlyphRunCache;
+	// Shared atlas for tile images. May be nullptr. Owned.
+	HotHudTextureAtlas* TileAtlas;
+	// GFrameCounter of the last periodic trim, so sharing HUDs only trim once per interval.
+	uint64 LastTrimFrame;
+
+	HotHudSharedResources() : TileAtlas(nullptr), LastTrimFrame(0) {}
+	~HotHudSharedResources() { delete TileAtlas; }
+
+	// Drops idle glyph runs and unused anonymous styles, unless it was already done this frame.
+	void Trim(uint64 maxIdleFrames);
 };
 
 /**
@@ -427,7 +1632,7 @@ class SHIVER_API AHotHud : public AHUD
 	GENERATED_BODY()
 public:
 	AHotHud(const FObjectInitializer& ObjectInitializer);
-	virtual ~AHotHud() {}
+	virtual ~AHotHud();
 
 	//// 
 	//// Public properties exposed to blueprints.
@@ -437,6 +1642,59 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
 	bool SupressHud;
 
+	// When set, 'ReceiveResolveDropTargetsRequest' is fired once as each drag begins so the blueprint can
+	// hand back every valid target in one go instead of being asked per hovered control.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+	bool PreResolveDropTargets;
+
+	// When set, tile images are copied into shared atlas pages so each TileGrid can draw all of its
+	// tiles with one item per page. Read once when the HUD initializes.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	bool UseTileAtlas;
+
+	// Width & height of each tile atlas page in texels.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TileAtlasPageSize;
+
+	// Maximum number of tile atlas pages. Once they're full, unused images are evicted.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	int32 TileAtlasMaxPages;
+
+	// When set, the HUD shares styles, laid out text and the tile atlas with the other HUDs in the world
+	// which have it set (e.g. those of split-screen players), rather than building its own. The tile atlas
+	// settings of the first such HUD are used. Read once when the HUD initializes. Memory stats of each
+	// sharing HUD include the shared resources in full.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = HotHud)
+	bool ShareResources;
+
+	// Memory budget in KB (see 'GetMemoryStats'). When exceeded, caches are emptied, images of tiles which
+	// haven't been drawn recently are released and text box scrollback is trimmed, in that order, until
+	// usage is back under budget. While trimming can't get under budget it's retried less often, up to
+	// every half minute or so. 0 disables the budget.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+	int32 MemoryBudgetKB;
+
+	// Number of rows of scrollback read-only text boxes keep when trimmed for the memory budget.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+	int32 MinScrollbackRows;
+
+	// Number of frames a tile must go undrawn before its image may be released for the memory budget.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+	int32 TileReleaseIdleFrames;
+
+	// Time in milliseconds per frame given to deferred work (tile data fetches, off screen grid layout,
+	// font measurement..). Work for visible controls runs first and prefetches last; whatever doesn't
+	// fit carries over to the next frame. 0 disables deferral so everything runs when it is needed.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HotHud)
+	float WorkBudgetMs;
+
+	//// 
+	//// Public native hooks.
+	////
+
+	// If bound, used instead of the 'ReceiveValidateDropTargetRequest' event to validate drop targets.
+	FHotHudValidateDropTarget NativeDropTargetValidator;
+
 
 	//// 
 	//// Public methods exposed to blueprints.
@@ -454,7 +1712,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = HotHud)
 	void CreateManagedWindow(FName name, FName parentName, const FControlGeometry& geometry, const FManagedWindowBuildOptions& buildOptions, FName& nameThru, bool& error);
 
-	// Deletes a previously created control. Control will not get shown on the next draw event.
+	// Deletes a previously created control along with every control under it. Control will not get
+	// shown on the next draw event. Tiles of grids driven by a data source can't be deleted individually.
 	// Name is the name of the control to delete.
 	// Error is set if the operation failed. Logs will have more details on the failure.
 	UFUNCTION(BlueprintCallable, Category = HotHud)
@@ -464,6 +1723,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = HotHud)
 	void DeleteAllControls();
 
+	// Shows / hides a control and everything under it. Hidden controls aren't laid out, drawn or hit-tested
+	// (their subtree isn't even walked) but keep their place and all of their cached state, so showing them
+	// again is instant. Hiding a control ends any focus, move, drag or scrollbar drag within it.
+	// Error is set if the control could not be found.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetControlVisible(const FName& name, bool visible, bool& error);
+
+	// As SetControlVisible() for a batch of controls, e.g. the pages of a tabbed menu.
+	// Error is set if any of the controls could not be found; the others are still shown / hidden.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetControlsVisible(const TArray<FName>& names, bool visible, bool& error);
+
+	// Collapses / expands a control. A collapsed control is hidden and also gives up its room: it no longer
+	// counts towards its window's scrollable content, and a collapsed tile gives up its grid slot.
+	// Error is set if the control could not be found.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetControlCollapsed(const FName& name, bool collapsed, bool& error);
+
+	// Returns whether a control is visible and whether it is collapsed. Error is set if the control could not
+	// be found.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetControlVisibility(const FName& name, bool& visible, bool& collapsed, bool& error);
+
 	// Creates a TextBox suitable for displaying rows of text.
 	// Name is the BP provided name of the new TextBox.
 	// Parent is the parent control. Cannot be 'None'.
@@ -482,12 +1764,125 @@ public:
 	UFUNCTION(BlueprintCallable, Category = HotHud)
 		void PrintLineToTextBox(const FName& textBoxName, const FString& text, bool& error);
 
+	// Adds many lines of text to the textbox at once, e.g. a pasted document or a chat history.
+	// Equivalent to 'PrintLineToTextBox' for each line, but long texts are split up on worker threads
+	// rather than line by line on the game thread.
+	// TextBoxName is the name of a previously created TextBox.
+	// Text is the text to add. Lines are separated by '\n'.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void AppendTextToTextBox(const FName& textBoxName, const FString& text, bool& error);
+
 	// Clears the contents of a TextBox and resets the cursor to the first row.
 	// TextBoxName is the name of a previously created TextBox.
 	// Error is set if the operation failed. Logs will have more details on the failure.
 	UFUNCTION(BlueprintCallable, Category = HotHud)
 		void ClearTextBox(const FName& textBoxName, bool& error);
 
+	// Replaces the contents of a TextBox. Lines are separated by '\n'.
+	// TextBoxName is the name of a previously created TextBox.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetTextBoxText(const FName& textBoxName, const FString& text, bool& error);
+
+	// Returns the contents of a TextBox. Lines are separated by '\n'.
+	// TextBoxName is the name of a previously created TextBox.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetTextBoxText(const FName& textBoxName, FString& text, bool& error);
+
+	// Inserts text at the cursor of an editable TextBox. '\n' starts a new paragraph.
+	// TextBoxName is the name of a previously created, editable TextBox.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void InsertTextIntoTextBox(const FName& textBoxName, const FString& text, bool& error);
+
+	// Deletes the character before (backspace) or after (delete) the cursor of an editable TextBox.
+	// TextBoxName is the name of a previously created, editable TextBox.
+	// Forward selects delete rather than backspace.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void DeleteTextBoxCharacter(const FName& textBoxName, bool forward, bool& error);
+
+	// Moves the cursor of an editable TextBox.
+	// TextBoxName is the name of a previously created, editable TextBox.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void MoveTextBoxCursor(const FName& textBoxName, TEnumAsByte<ETextBoxCursorMove::Type> move, bool& error);
+
+	// Creates a Label, a single line of text which can be bound to a live number.
+	// Name is the BP provided name of the new Label.
+	// Parent is the parent control. Cannot be 'None'.
+	// Geometry specifies the location and size of the Label in pixels. Location is relative to Parent.
+	// BuildOptions contain the font & colors of the Label; 'Text' is its initial text and 'Editable' is ignored.
+	// NameThru is set to a copy of the passed in Name.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void CreateLabel(FName name, const FName& parentName, const FControlGeometry& geometry, const FTextBoxBuildOptions& buildOptions, FName& nameThru, bool& error);
+
+	// Shows fixed text on a Label, removing any binding.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetLabelText(const FName& labelName, const FString& text, bool& error);
+
+	// Sets the text shown before & after a Label's bound value, e.g. 'FPS: ' and ''.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetLabelAffixes(const FName& labelName, const FString& prefix, const FString& suffix, bool& error);
+
+	// Binds a Label to a numeric (int or float) property of an object. The property is read every frame
+	// and the label only changes when the formatted value does.
+	// LabelName is the name of the Label.
+	// Object is the object holding the property. The binding reads 0 once the object is destroyed.
+	// PropertyName is the name of the property.
+	// Format is how the number is shown.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void BindLabelToProperty(const FName& labelName, UObject* object, FName propertyName, TEnumAsByte<EHotHudNumberFormat::Type> format, bool& error);
+
+	// Removes a Label's binding. The last value stays on screen.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void UnbindLabel(const FName& labelName, bool& error);
+
+	// Creates a Gauge, a bar which fills in proportion to a value.
+	// Name is the BP provided name of the new Gauge.
+	// Parent is the parent control. Cannot be 'None'.
+	// Geometry specifies the location and size of the Gauge in pixels. Location is relative to Parent.
+	// BuildOptions contain the colors and value range of the Gauge.
+	// NameThru is set to a copy of the passed in Name.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void CreateGauge(FName name, const FName& parentName, const FControlGeometry& geometry, const FGaugeBuildOptions& buildOptions, FName& nameThru, bool& error);
+
+	// Sets the value shown by a Gauge.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetGaugeValue(const FName& gaugeName, float value, bool& error);
+
+	// Binds a control to a property of an object, replacing any previous binding of the control. The
+	// path is resolved once; after that the property is read at Rate and the control is only touched
+	// when the value changes. A TextBox shows the value as text, a Tile as its label and a Gauge as its
+	// fill (which needs a number or bool). Labels are bound with BindLabelToProperty instead.
+	// ControlName is the name of a TextBox, Tile or Gauge.
+	// Object is the object to read from. The control keeps its last value once the object is destroyed.
+	// PropertyPath is a property name, or a dotted path through struct and object properties,
+	// e.g. 'Stats.Health' or 'Weapon.AmmoCount'.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void BindControlToProperty(const FName& controlName, UObject* object, const FString& propertyPath, TEnumAsByte<EHotHudBindingRate::Type> rate, bool& error);
+
+	// Removes the property binding of a control. The last value stays on screen, except for tiles
+	// which go back to their fetched label.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void UnbindControl(const FName& controlName, bool& error);
+
+	// Re-reads bound properties on the next frame, whatever their rate. Use for 'OnDemand' bindings.
+	// ControlName is the control to refresh, or 'None' for every binding.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void RefreshBindings(const FName& controlName);
+
 	// Creates a grid of tiles
 	// Name is the BP provided name of the new TileGrid.
 	// Parent is the parent control. Cannot be 'None'.
@@ -514,6 +1909,322 @@ public:
 	UFUNCTION(BlueprintCallable, Category = HotHud)
 		void AddTilesToTileGrid(const FName& tileGridName, const TArray<FName>& tileNames, bool& error);
 
+	// Moves the tile at FromIndex to ToIndex, shifting the tiles in-between over by one slot.
+	// TileGridName is the Name of the TileGrid containing the tiles.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void MoveTileInTileGrid(const FName& tileGridName, int32 fromIndex, int32 toIndex, bool& error);
+
+	// Exchanges the tiles at FirstIndex and SecondIndex.
+	// TileGridName is the Name of the TileGrid containing the tiles.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SwapTilesInTileGrid(const FName& tileGridName, int32 firstIndex, int32 secondIndex, bool& error);
+
+	// Inserts an existing tile at Index of a TileGrid. The tile may currently belong to a different grid.
+	// TileGridName is the Name of the destination TileGrid.
+	// TileName is the Name of a previously added tile.
+	// Index is the destination slot. Values past the end append the tile.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void InsertTileIntoTileGrid(const FName& tileGridName, const FName& tileName, int32 index, bool& error);
+
+	// Sets the keys tiles are ordered by when a TileGrid is sorted by EHotHudTileSortBy::Key. Keys stay
+	// with their tiles as they move. Grids bound to a data source use the source's keys instead.
+	// TileGridName is the Name of the TileGrid.
+	// SortKeys holds one key per slot, in slot order.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetTileSortKeys(const FName& tileGridName, const TArray<float>& sortKeys, bool& error);
+
+	// Shows the tiles of a TileGrid sorted, without moving them between slots or re-fetching them.
+	// Slot indices (and 'ReceiveTilesReordered') are unaffected. The view is kept up to date as tiles are
+	// added, moved or removed.
+	// TileGridName is the Name of the TileGrid.
+	// SortBy is what to order the tiles by. 'Slot' turns sorting off.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SortTileGrid(const FName& tileGridName, TEnumAsByte<EHotHudTileSortBy::Type> sortBy, bool descending, bool& error);
+
+	// Leaves tiles out of a TileGrid's view. Hidden tiles keep their slots, images and labels.
+	// TileGridName is the Name of the TileGrid.
+	// ShownSlots holds one flag per slot, in slot order. Empty shows every tile (grids bound to a data
+	// source ask the source instead).
+	// LabelFilter, if not empty, hides tiles whose label doesn't contain it (ignoring case).
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void FilterTileGrid(const FName& tileGridName, const TArray<bool>& shownSlots, const FString& labelFilter, bool& error);
+
+	// Removes any sorting & filtering from a TileGrid so every tile is shown in slot order.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void ClearTileGridView(const FName& tileGridName, bool& error);
+
+	// Returns the names of the tiles a TileGrid shows, in the order they are shown.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetTileGridView(const FName& tileGridName, TArray<FName>& tileNames, bool& error);
+
+	// Drop target validation results are cached for the lifetime of a drag. Call this if the rules
+	// which decide what may be dropped where change while a drag is in progress.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void InvalidateDropTargetCache();
+
+	// Returns tile atlas statistics. All zero if the atlas is disabled.
+	// NumPages is the number of atlas pages allocated.
+	// NumEntries is the number of resident tile images. NumReferenced of those are currently in use.
+	// Evictions and Repacks count how often space had to be reclaimed.
+	// Occupancy is the fraction of atlas texels in use.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetTileAtlasStats(int32& numPages, int32& numEntries, int32& numReferenced, int32& evictions, int32& repacks, float& occupancy);
+
+	// Returns glyph run cache statistics.
+	// Hits and Misses count cache lookups. Replays counts strings drawn from an already held run.
+	// NumEntries is the number of laid out strings currently cached.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetGlyphRunCacheStats(int32& hits, int32& misses, int32& replays, int32& numEntries);
+
+	// Defines a named window style, or changes an existing one. Every window using it is restyled on
+	// the next frame. Title and IsMovable are per-window and ignored here.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void DefineWindowStyle(const FName& styleName, const FManagedWindowBuildOptions& options);
+
+	// Defines a named TextBox style, or changes an existing one. Text and Editable are per-TextBox and
+	// ignored here.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void DefineTextBoxStyle(const FName& styleName, const FTextBoxBuildOptions& options);
+
+	// Defines a named TileGrid style, or changes an existing one.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void DefineTileGridStyle(const FName& styleName, const FTileGridBuildOptions& options);
+
+	// Defines a named Gauge style, or changes an existing one.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void DefineGaugeStyle(const FName& styleName, const FGaugeBuildOptions& options);
+
+	// Switches a control over to a named style. The style must be of the control's type.
+	// ControlName is the name of a Window, TextBox, Label, TileGrid or Gauge.
+	// StyleName is the name of a previously defined style.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void ApplyStyleToControl(const FName& controlName, const FName& styleName, bool& error);
+
+	// Overrides the background color of one control without affecting the rest of its style.
+	// ControlName is the name of the control.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetControlBackgroundColor(const FName& controlName, const FLinearColor& color, bool& error);
+
+	// Overrides the text color of one control (window title, TextBox text or tile label).
+	// ControlName is the name of the control.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetControlTextColor(const FName& controlName, const FLinearColor& color, bool& error);
+
+	// Drops every style override of a control so it follows its style again.
+	// ControlName is the name of the control.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void ClearControlStyleOverrides(const FName& controlName, bool& error);
+
+	// Animates a control to a new location (relative to its parent). Replaces any running position tween.
+	// ControlName is the name of the control.
+	// Duration is in seconds of real time, so tweens keep running while the game is paused.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void TweenControlPosition(const FName& controlName, FVector2D location, float duration, TEnumAsByte<EHotHudEasing::Type> easing, bool& error);
+
+	// Animates a control to a new size. Replaces any running size tween.
+	// ControlName is the name of the control.
+	// Duration is in seconds of real time.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void TweenControlSize(const FName& controlName, int32 width, int32 height, float duration, TEnumAsByte<EHotHudEasing::Type> easing, bool& error);
+
+	// Fades a control (and its children) to Opacity (0..1). Replaces any running opacity tween.
+	// ControlName is the name of the control.
+	// Duration is in seconds of real time.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void TweenControlOpacity(const FName& controlName, float opacity, float duration, TEnumAsByte<EHotHudEasing::Type> easing, bool& error);
+
+	// Stops every tween running on a control. 'ReceiveTweensCompleted' is not fired for them.
+	// ControlName is the name of the control.
+	// SnapToEnd jumps the control to the tweens' final values rather than leaving it where it is.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void CancelControlTweens(const FName& controlName, bool snapToEnd, bool& error);
+
+	// Forwards a key press to the control with keyboard focus. Call this from the PlayerController's
+	// key handling; HotHud picks up mouse buttons and the wheel by itself.
+	// Key is the key which was pressed.
+	// Consumed is set if a control has focus and the key should not be processed further.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void HandleKeyInput(const FKey& key, bool& consumed);
+
+	// Forwards typed characters to the control with keyboard focus.
+	// Characters is the typed text.
+	// Consumed is set if a control has focus and the characters should not be processed further.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void HandleCharacterInput(const FString& characters, bool& consumed);
+
+	// Gives a control keyboard focus. Focus otherwise follows clicks onto focusable controls.
+	// ControlName is the name of the control, or 'None' to clear focus.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void FocusControl(const FName& controlName, bool& error);
+
+	// Returns the approximate memory used by the HUD, broken down by control type and subsystem.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetMemoryStats(FHotHudMemoryStats& stats);
+
+	// Applies every trimming policy of 'MemoryBudgetKB' now, regardless of the budget.
+	// Stats is set to the memory used afterwards.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void TrimMemory(FHotHudMemoryStats& stats);
+
+	// Scrolls a window's contents.
+	// WindowName is the name of the window.
+	// Offset is how far the content is scrolled from its top-left. It is clamped to the content size.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void ScrollWindow(const FName& windowName, FVector2D offset, bool& error);
+
+	// Returns how far a window's contents are scrolled and how large they are.
+	// Error is set if the operation failed. Logs will have more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetWindowScroll(const FName& windowName, FVector2D& offset, FVector2D& contentSize, bool& error);
+
+	// Makes this HUD show the controls of another one (e.g. split-screen players sharing player one's HUD)
+	// rather than its own. Hover, drag, move, focus and scrolling by the mouse stay per HUD; the controls,
+	// their styles & text, tweens, bindings and deferred work all live on Owner, and are created and
+	// changed through Owner. Resources are shared with Owner too.
+	// Owner is the HUD whose controls to show. It must not itself be showing another HUD's controls.
+	// Error is set if the operation failed, e.g. because this HUD already has controls of its own.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void ShareControlTree(AHotHud* owner, bool& error);
+
+	// Places the controls on this HUD's viewport: a control at X,Y is drawn at Offset + X,Y * Scale, and
+	// the mouse is mapped back the same way. Lets HUDs sharing a control tree lay it out per player.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetViewportTransform(const FVector2D& offset, float scale);
+
+	// Saves every control - the tree & z-order, geometry, styles, text & scrollback, tile order and scroll
+	// positions - into a compact binary snapshot, e.g. to carry the HUD across a level change. Native
+	// bindings (label & property bindings, tile data sources and their tiles) are not included.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SaveSnapshot(TArray<uint8>& data);
+
+	// Rebuilds the controls of a snapshot made by SaveSnapshot(). The HUD must not have any controls yet.
+	// Error is set if the operation failed, in which case the HUD is left without controls. Logs will have
+	// more details on the failure.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void RestoreSnapshot(const TArray<uint8>& data, bool& error);
+
+	// Records every draw command (chrome rects, text and images, with their rect, color, texture, text hash
+	// and the control which issued them) of the next NumFrames frames, then writes them to FileName. Relative
+	// names are under the game's Saved directory. Use Tools/HotHudCaptureTool.cpp to summarize or diff captures.
+	// Error is set if a capture is already running or NumFrames is less than 1.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void StartDrawCapture(const FString& fileName, int32 numFrames, bool& error);
+
+	// Ends the running capture early, writing the frames captured so far.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void StopDrawCapture();
+
+	// Returns the deferred work scheduler counters.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void GetWorkStats(FHotHudWorkStats& stats);
+
+	// Checks the control tree for consistency: every control in the control map is reachable from a root
+	// window through its parent's children (and nothing else is), parent & child links agree, tiles sit in
+	// their slot, and screen co-ordinates match the geometry. Error is set if anything is inconsistent;
+	// each problem is logged.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void ValidateControlTree(bool& error);
+
+	// Starts a soak run: every frame, OperationsPerFrame randomized operations (creating windows, text boxes,
+	// tile grids & tiles, printing text, moving windows & tiles, deleting controls..) generated from Seed are
+	// run until NumOperations have been run. The tree is validated periodically and frame times & memory are
+	// tracked; the results are logged and passed to 'ReceiveSoakFinished'. The HUD must not have any controls,
+	// and those the run creates are deleted when it ends. Error is set if the soak couldn't be started.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void StartSoak(int32 seed, int32 numOperations, int32 operationsPerFrame, bool& error);
+
+	// Ends the running soak early. Report is the results so far.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void StopSoak(FHotHudSoakReport& report);
+
+	// Runs a whole soak (see 'StartSoak') at once without drawing: each step runs OperationsPerFrame
+	// operations, then the tweens & bindings, as a frame would. Needs no player, canvas or world, and
+	// ignores 'SupressHud', so it can be driven from an automation test or commandlet. Report is the
+	// results; error is set if the soak couldn't be started.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void RunSoak(int32 seed, int32 numOperations, int32 operationsPerFrame, FHotHudSoakReport& report, bool& error);
+
+	// Starts / stops recording a category of events into the event trace. The trace is shared by every HUD
+	// and keeps the most recent events; it is also written to the log if the game crashes. Does nothing
+	// when the trace is compiled out (HOTHUD_TRACE is 0, the default in shipping builds).
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void SetTraceCategoryEnabled(TEnumAsByte<EHotHudTraceCategory::Type> category, bool enabled);
+
+	// Writes the event trace to FileName (relative names are under the game's Saved directory), or to
+	// the log if FileName is empty. Error is set if the file couldn't be written.
+	UFUNCTION(BlueprintCallable, Category = HotHud)
+		void DumpTrace(const FString& fileName, bool& error);
+
+	////
+	//// Public native methods.
+	////
+
+	// Binds a native data source to a TileGrid (nullptr unbinds). The grid's tiles are then driven by the
+	// source instead of 'AddTilesToTileGrid' / 'ReceiveTileInfoRequest'. Ownership of Source not taken; it
+	// must outlive the binding. Returns false if the grid could not be found.
+	bool SetTileGridDataSource(const FName& tileGridName, HotHudTileDataSource* source);
+
+	// Returns the control named Name, or nullptr.
+	HotHudControl* FindControlByName(const FName& name);
+	// Queues Text for drawing at X,Y using a cached glyph run. Run is the caller's handle for this
+	// piece of text; reset it whenever the text changes. Falls back to DrawText for fonts which can't
+	// be cached. Queued text is drawn by FlushText().
+	// Opacity scales the text's alpha without invalidating the run.
+	void DrawCachedText(
+		TSharedPtr<HotHudGlyphRun>& run, const FString& text, const FLinearColor& color,
+		float x, float y, UFont* font, float scale, float opacity = 1.0f);
+	// Draws all text queued by DrawCachedText().
+	void FlushText();
+	// Queues a flat colored rectangle / 1 pixel outline of a rectangle. Queued chrome is drawn as a single
+	// triangle list by FlushChrome(). Chrome is clipped to the clip rect of the layer being drawn.
+	void DrawChromeRect(const FLinearColor& color, float x, float y, float width, float height);
+	void DrawChromeOutline(const FLinearColor& color, float x, float y, float width, float height);
+	void FlushChrome();
+	// Running draw capture, or nullptr. Draw sites record into it as they queue / draw items.
+	HotHudDrawCapture* DrawCapture() const { return capture_; }
+	// Control the current draw pass is drawing, which captured commands are attributed to.
+	HotHudControl* DrawingControl() const { return drawingControl_; }
+	void SetDrawingControl(HotHudControl* control) { drawingControl_ = control; }
+
+	// Tile atlas. nullptr if 'UseTileAtlas' is clear.
+	HotHudTextureAtlas* TileAtlas() const { return resources_->TileAtlas; }
+	// Adds a control created outside of the Create* methods to the control map.
+	void RegisterControl(HotHudControl* control);
+	// Removes a control which is about to be destroyed from the control map and drops every transient
+	// reference (hover, drag, move, focus..) the HUD holds to it.
+	void ForgetControl(HotHudControl* control);
+	// Queues a key press / typed character for the focused control. Returns true if a control has
+	// focus, i.e. the input should not be processed further.
+	bool InputKey(const FKey& key);
+	bool InputChar(TCHAR character);
+	// Queues Work for Control on the frame budgeted scheduler, unless it is already queued at Priority
+	// or higher. Returns false if deferral is disabled ('WorkBudgetMs' is 0), in which case the caller
+	// should do the work itself right away.
+	bool DeferWork(HotHudControl* control, HotHudWorkType work, HotHudWorkPriority priority);
+	// Forces the control under the mouse to be re-evaluated on the next frame, by every HUD showing
+	// the controls. Call after controls under a stationary mouse were moved around.
+	void InvalidateHover();
+	// HUD whose controls this one shows (itself unless 'ShareControlTree' was used).
+	AHotHud* TreeOwner() { return treeOwner_.IsValid() ? treeOwner_.Get() : this; }
+
 
 	//// 
 	//// Functions which are overridden in blueprints that we call out to.
@@ -528,6 +2239,35 @@ public:
 		const FName& sourceControl, const FName& targetControl,
 		bool& okToDrop);
 
+	// Fired once at the start of a drag when 'PreResolveDropTargets' is set.
+	// SourceControl is the control being dragged.
+	// ValidTargets should be filled with the names of every control SourceControl may be dropped onto.
+	// Handled should be set if ValidTargets is authoritative. If it is left clear, targets are
+	// validated lazily through 'ReceiveValidateDropTargetRequest' as usual.
+	UFUNCTION(BlueprintImplementableEvent, Category = HotHud)
+		void ReceiveResolveDropTargetsRequest(const FName& sourceControl, TArray<FName>& validTargets, bool& handled);
+
+	// Fired after a player drop re-ordered the tiles of a TileGrid. Only the slots in
+	// [FirstIndex, LastIndex] changed. Re-orders requested from BP do not fire this event.
+	UFUNCTION(BlueprintImplementableEvent, Category = HotHud)
+		void ReceiveTilesReordered(const FName& tileGridName, int32 firstIndex, int32 lastIndex);
+
+	// Fired once per frame with the names of every control which had a tween finish that frame.
+	// A control appears once per finished tween.
+	UFUNCTION(BlueprintImplementableEvent, Category = HotHud)
+		void ReceiveTweensCompleted(const TArray<FName>& controlNames);
+
+	// Fired when memory use goes over 'MemoryBudgetKB', after the trimming policies have run.
+	// Stats is the memory used after trimming.
+	// UnderBudget is set if trimming brought usage back under the budget. If it is clear the event
+	// won't fire again until usage has dropped under the budget and exceeded it once more.
+	UFUNCTION(BlueprintImplementableEvent, Category = HotHud)
+		void ReceiveMemoryBudgetExceeded(const FHotHudMemoryStats& stats, bool underBudget);
+
+	// Fired when a soak run (see 'StartSoak') finishes, or stops at an invariant violation.
+	UFUNCTION(BlueprintImplementableEvent, Category = HotHud)
+		void ReceiveSoakFinished(const FHotHudSoakReport& report);
+
 protected:
 	virtual void DrawHUD() override;
 	virtual void PostInitializeComponents() override;
@@ -535,8 +2275,97 @@ protected:
 private:
 	HotHudControl* HandleControlLookup(
 		const FName& name, HotHudControlType type, bool& bpReturnCode);
-	HotHudControl* FindControlByName(const FName& name);
+	// As HandleControlLookup(), but also fails if the TextBox isn't editable.
+	HotHudTextBox* HandleEditableTextBoxLookup(const FName& name, bool& bpReturnCode);
 	HotHudControl* FindTopMostControlAt(const FVector2D& location);
+	// Root windows of the control tree this HUD shows.
+	const TArray<HotHudWindow*>& TreeRootWindows() { return TreeOwner()->rootWindows_; }
+	// Drops this HUD's hover, drag, move, focus and scrolling references to Control.
+	void ForgetInteraction(HotHudControl* control);
+	// Ends this HUD's focus, move, drag and scrollbar drag of anything within Hidden.
+	void ForgetInteractionWithin(HotHudControl* hidden);
+	// Brings every HUD showing the controls up to date after Control was shown or hidden.
+	void OnControlShownChanged(HotHudControl* control);
+	// Forgets & deletes Control and its descendants. Control must already be detached from its parent.
+	void DestroyControl(HotHudControl* control);
+	// Appends a description of every control tree inconsistency found to Problems.
+	void CollectTreeProblems(TArray<FString>& problems);
+
+	// Advances active tweens, writes their values back to the controls and fires 'ReceiveTweensCompleted'.
+	void StepTweens();
+	// Steps everything which doesn't need a canvas: tweens, then bindings.
+	void StepLogic();
+	// Real time used by tweens & bindings; the world's if there is one, so HUDs without one still step.
+	float RealTimeSeconds() const;
+	// Shared implementation of the Tween* BP methods.
+	void StartTween(const FName& controlName, HotHudTweenProperty property, const FVector2D& to, float duration, EHotHudEasing::Type easing, bool& error);
+
+	// Checks memory use against 'MemoryBudgetKB', trimming and firing 'ReceiveMemoryBudgetExceeded' as needed.
+	void EnforceMemoryBudget();
+	// Runs the trimming policies in order until Stats is no more than BudgetBytes. Stats must be current
+	// on entry and is kept current.
+	void ApplyTrimPolicies(int64 budgetBytes, FHotHudMemoryStats& stats);
+	// Runs queued work, most urgent first, until the queues are empty or 'WorkBudgetMs' is used up.
+	void RunDeferredWork();
+
+	// Runs the soak's operations for this frame.
+	void StepSoak();
+	// Runs one randomized soak operation.
+	void RunSoakOperation(HotHudSoakState& soak);
+	// Picks a live control out of Names. Returns nullptr if there are none left.
+	HotHudControl* PickSoakControl(HotHudSoakState& soak, TArray<FName>& names);
+	// Records the frame's time, validates the tree every so often and finishes the run when it's done.
+	// Returns true, with Report filled in, once the run has finished.
+	bool EndSoakFrame(double frameMs, FHotHudSoakReport& report);
+	// Ends the soak: deletes its controls (unless the tree is inconsistent), fills in the report,
+	// logs it and fires 'ReceiveSoakFinished'.
+	void FinishSoak(FHotHudSoakReport& report);
+
+	// Reads every binding which is due and pushes changed values to their controls.
+	void PollBindings();
+	// Reads Binding's property and updates its control if the value changed (or Force is set).
+	void UpdateBinding(HotHudPropertyBinding& binding, bool force);
+
+	// Writes Control and its descendants to a snapshot.
+	void SaveControl(FArchive& ar, HotHudControl* control);
+	// Reads a control written by SaveControl() (and its descendants), parents and registers it.
+	// Returns nullptr if the snapshot is malformed.
+	HotHudControl* LoadControl(FArchive& ar, HotHudControl* parent);
+
+	// Draws Window as a layer clipped to Clip, followed by the layers of its sub-windows.
+	void DrawWindowLayers(HotHudWindow* window, const HotHudClipRect& clip);
+	// Adds Parent's descendants which overlap Clip to drawLayer_, stopping at (and collecting) sub-windows.
+	// Draws and restarts the layer when a descendant overlaps a control gathered before it.
+	// WindowClip & Clip are the clips of the window and of its contents.
+	void GatherLayer(HotHudControl* parent, const HotHudClipRect& windowClip, const HotHudClipRect& clip, TArray<HotHudWindow*>& subWindows);
+	// Draws drawLayer_ pass by pass. The window (if the layer has one) is clipped to WindowClip and its
+	// contents to ContentClip.
+	void DrawLayer(const HotHudClipRect& windowClip, const HotHudClipRect& contentClip);
+
+	// Binds mouse buttons & the wheel on the owning PlayerController. Returns true once bound.
+	bool BindInput();
+	void OnLeftMouseButtonPressed();
+	void OnLeftMouseButtonReleased();
+	void OnMouseScrollUp();
+	void OnMouseScrollDown();
+	// Current mouse location, or the last known one if it can't be read.
+	FVector2D PollMouseLocation() const;
+	// Appends an event to pendingInput_, folding consecutive mouse moves into one. Returns the event
+	// so the caller can fill in type specific fields.
+	HotHudInputEvent& QueueInput(HotHudInputEvent::EventType type, const FVector2D& location);
+	// Dispatches (and empties) pendingInput_.
+	void DispatchInput();
+	// Updates the hovered control (and drop target state) for the mouse being at Location.
+	void UpdateHover(const FVector2D& location);
+	void HandleLeftButtonDown(const FVector2D& location);
+	void HandleLeftButtonUp();
+	void SetFocusedControl(HotHudControl* control);
+
+	// Starts / ends a drag session, (re)setting the drop target validation cache.
+	void BeginDragSession(HotHudControl* source);
+	void EndDragSession();
+	// Returns true if the control being dragged may be dropped onto Target. Results are memoized per drag.
+	bool ValidateDropTarget(HotHudControl* target);
 
 	// Map of all controls.
 	TMap<FName, HotHudControl*> controlMap_;
@@ -547,10 +2376,83 @@ private:
 	// PlayerController for the current client machine. Pointer not owned.
 	APlayerController* localPlayerController_;
 
-	bool lastLeftMouseButtonDown_;
+	// Set once mouse input is bound on the PlayerController.
+	bool inputBound_;
+	// Input received since the last frame, in arrival order.
+	TArray<HotHudInputEvent> pendingInput_;
+	// Last known mouse location.
+	FVector2D mouseLocation_;
+	// Location the hovered control was last evaluated at, and whether that evaluation is stale.
+	FVector2D hoverLocation_;
+	bool hoverDirty_;
+	HotHudControl* focusedControl_;
 	HotHudControl* controlBeingHovered_;
 	HotHudControl* controlBeingDragged_;
 	HotHudControl* controlBeingMoved_;
 	FVector2D mouseControlOffset_;
+	// Window whose scrollbar is being dragged, which bar and where along the thumb it was grabbed.
+	HotHudWindow* scrollbarDragWindow_;
+	bool scrollbarDragVertical_;
+	float scrollbarGrabOffset_;
 	bool dragDropTargetValid_;
+
+	// HUD whose control tree is shown instead of our own, and the HUDs showing ours.
+	TWeakObjectPtr<AHotHud> treeOwner_;
+	TArray<TWeakObjectPtr<AHotHud>> treeFollowers_;
+	// Maps the control tree onto the viewport (see 'SetViewportTransform').
+	FVector2D viewportOffset_;
+	float viewportScale_;
+
+	// Drop target validation results for the current drag. The source is fixed for the duration of
+	// a drag so only the target is needed as a key.
+	TMap<HotHudControl*, bool> dropTargetCache_;
+	// Set when the cache holds every valid target (bulk pre-resolved), so misses mean 'invalid'.
+	bool dropTargetCacheComplete_;
+
+	// Styles, glyph runs and the tile atlas. Possibly shared with other HUDs.
+	TSharedRef<HotHudSharedResources> resources_;
+
+	// Running tweens, and the names of controls whose tweens finished this frame.
+	HotHudTweenSet tweens_;
+	// HotHudControl::ShownGeneration() the tweens were last parked / resumed for.
+	int32 tweenShownGeneration_;
+	TArray<FName> completedTweens_;
+
+	// Batch cached text is queued into.
+	HotHudTextBatch textBatch_;
+	int32 glyphRunReplays_;
+
+	// Set while memory use is over budget and trimming couldn't fix it.
+	bool memoryBudgetExceeded_;
+	// Budget checks skipped after the last failed trim, and how many are still to be skipped.
+	int32 memoryBudgetBackoff_;
+	int32 memoryBudgetChecksToSkip_;
+
+	// Deferred work per priority. Each queue is consumed from its head index and emptied once drained.
+	TArray<HotHudWorkItem> workQueues_[HotHudWorkPriority_NumPriorities];
+	int32 workQueueHeads_[HotHudWorkPriority_NumPriorities];
+	// Work for hidden controls, per priority. Queued again once the control is shown; checked whenever
+	// HotHudControl::ShownGeneration() moves past parkedWorkGeneration_.
+	TArray<HotHudWorkItem> parkedWork_[HotHudWorkPriority_NumPriorities];
+	int32 parkedWorkGeneration_;
+	FHotHudWorkStats workStats_;
+
+	// Property bindings, in the order they were made.
+	TArray<HotHudPropertyBinding> bindings_;
+	// Scratch string bindings read text into, kept to avoid re-allocation.
+	FString bindingScratch_;
+
+	// Layer being drawn. Kept to avoid re-allocating the buckets every frame.
+	HotHudDrawLayer drawLayer_;
+	// Chrome queued by DrawChrome*(). Kept between frames to avoid re-allocation.
+	TArray<FCanvasUVTri> chromeBatch_;
+	// Rect chrome is currently clipped to.
+	HotHudClipRect chromeClip_;
+
+	// Soak run in progress (see 'StartSoak'), or nullptr.
+	HotHudSoakState* soak_;
+
+	// Draw capture in progress (see 'StartDrawCapture'), and the control being drawn.
+	HotHudDrawCapture* capture_;
+	HotHudControl* drawingControl_;
 };
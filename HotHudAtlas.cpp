@@ -0,0 +1,279 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudAtlas.h"
+
+/*****************************************************************************/
+
+HotHudTextureAtlas::HotHudTextureAtlas(int32 pageSize, int32 maxPages)
+	: packer_(pageSize, maxPages, 1) {
+}
+
+uint64 HotHudTextureAtlas::MakeKey(UTexture2D* texture, int32 width, int32 height) {
+	// Objects are at least 8-byte aligned and well below 2^47, leaving 20 bits for a 10:10 size.
+	return (((uint64)(PTRINT)texture >> 3) << 20) | ((uint64)width << 10) | (uint64)height;
+}
+
+uint64 HotHudTextureAtlas::Acquire(UTexture2D* texture, int32 width, int32 height) {
+	if (texture == nullptr || width <= 0 || height <= 0 || width >= 1024 || height >= 1024) {
+		return 0;
+	}
+	if (rejectedTextures_.Contains(TWeakObjectPtr<UTexture2D>(texture))) {
+		return 0;
+	}
+	if (texture->PlatformData == nullptr || texture->PlatformData->Mips.Num() == 0 ||
+		texture->PlatformData->PixelFormat != PF_B8G8R8A8) {
+		rejectedTextures_.Add(texture);
+		return 0;
+	}
+
+	uint64 key = MakeKey(texture, width, height);
+	bool isNew = false;
+	const HotHudAtlasEntry* entry = packer_.Acquire(key, width, height, (uint32)GFrameCounter, isNew);
+	if (entry == nullptr) {
+		return 0;
+	}
+	int32 page = entry->Page;
+	HotHudAtlasEntry placed = *entry;
+	// Creates the page if it's new and re-copies it if a re-pack moved things around to make room.
+	SyncPages();
+
+	if (isNew) {
+		if (!CopyTexels(texture, placed)) {
+			packer_.Release(key);
+			rejectedTextures_.Add(texture);
+			return 0;
+		}
+		keyTextures_.Add(key, texture);
+		int32 padding = packer_.Padding();
+		MarkPageDirty(page, HotHudAtlasRect(placed.Rect.X - padding, placed.Rect.Y - padding,
+			placed.Rect.Width + padding * 2, placed.Rect.Height + padding * 2));
+	}
+	return key;
+}
+
+void HotHudTextureAtlas::Release(uint64 key) {
+	if (key != 0) {
+		packer_.Release(key);
+	}
+}
+
+int32 HotHudTextureAtlas::EvictUnreferenced() {
+	for (auto it = rejectedTextures_.CreateIterator(); it; ++it) {
+		if (!it->IsValid()) {
+			it.RemoveCurrent();
+		}
+	}
+	int32 evicted = packer_.EvictUnreferenced();
+	if (evicted > 0) {
+		SyncPages();
+	}
+	return evicted;
+}
+
+bool HotHudTextureAtlas::GetUVs(uint64 key, int32& outPage, FVector4& outUVs) const {
+	const HotHudAtlasEntry* entry = packer_.Find(key);
+	if (entry == nullptr) {
+		return false;
+	}
+	float invSize = 1.0f / packer_.PageSize();
+	outPage = entry->Page;
+	outUVs = FVector4(
+		entry->Rect.X * invSize, entry->Rect.Y * invSize,
+		(entry->Rect.X + entry->Rect.Width) * invSize, (entry->Rect.Y + entry->Rect.Height) * invSize);
+	return true;
+}
+
+void HotHudTextureAtlas::SyncPages() {
+	int32 pageSize = packer_.PageSize();
+	while (pageTextures_.Num() < packer_.NumPages()) {
+		UTexture2D* page = UTexture2D::CreateTransient(pageSize, pageSize, PF_B8G8R8A8);
+		page->SRGB = true;
+		page->UpdateResource();
+		pageTextures_.Add(page);
+		pageTexels_.AddDefaulted();
+		pageTexels_.Last().AddZeroed(pageSize * pageSize);
+		pageRevisions_.Add(0);
+		pageDirtyRects_.Add(HotHudAtlasRect(0, 0, pageSize, pageSize));
+		pageBatches_.AddDefaulted();
+	}
+	// Pages which were re-packed by someone else's Acquire() also need rebuilding.
+	for (int32 i = 0; i < pageRevisions_.Num(); i++) {
+		if (pageRevisions_[i] != packer_.PageRevision(i)) {
+			RebuildPage(i);
+		}
+	}
+}
+
+bool HotHudTextureAtlas::CopyTexels(UTexture2D* texture, const HotHudAtlasEntry& entry) {
+	FTexture2DMipMap& mip = texture->PlatformData->Mips[0];
+	if (!mip.BulkData.IsBulkDataLoaded()) {
+		// Mip data isn't resident on the CPU (typical for cooked, streamed textures).
+		return false;
+	}
+	const FColor* source = static_cast<const FColor*>(mip.BulkData.Lock(LOCK_READ_ONLY));
+	if (source == nullptr) {
+		mip.BulkData.Unlock();
+		return false;
+	}
+
+	const int32 sourceWidth = mip.SizeX;
+	const int32 sourceHeight = mip.SizeY;
+	const int32 pageSize = packer_.PageSize();
+	const int32 padding = packer_.Padding();
+	const HotHudAtlasRect& rect = entry.Rect;
+	TArray<FColor>& dest = pageTexels_[entry.Page];
+
+	// Box filter the source down (or point sample it up) to the entry size.
+	for (int32 y = 0; y < rect.Height; y++) {
+		int32 sy0 = (y * sourceHeight) / rect.Height;
+		int32 sy1 = FMath::Max(sy0 + 1, ((y + 1) * sourceHeight) / rect.Height);
+		for (int32 x = 0; x < rect.Width; x++) {
+			int32 sx0 = (x * sourceWidth) / rect.Width;
+			int32 sx1 = FMath::Max(sx0 + 1, ((x + 1) * sourceWidth) / rect.Width);
+			uint32 r = 0, g = 0, b = 0, a = 0, n = 0;
+			for (int32 sy = sy0; sy < sy1; sy++) {
+				const FColor* row = source + sy * sourceWidth;
+				for (int32 sx = sx0; sx < sx1; sx++) {
+					r += row[sx].R;
+					g += row[sx].G;
+					b += row[sx].B;
+					a += row[sx].A;
+					n++;
+				}
+			}
+			dest[(rect.Y + y) * pageSize + rect.X + x] = FColor((uint8)(r / n), (uint8)(g / n), (uint8)(b / n), (uint8)(a / n));
+		}
+	}
+	mip.BulkData.Unlock();
+
+	// Extend the edges into the gutter so bilinear filtering doesn't bleed in neighbours.
+	for (int32 p = 1; p <= padding; p++) {
+		for (int32 y = 0; y < rect.Height; y++) {
+			FColor* row = &dest[(rect.Y + y) * pageSize];
+			row[rect.X - p] = row[rect.X];
+			row[rect.X + rect.Width - 1 + p] = row[rect.X + rect.Width - 1];
+		}
+		int32 left = rect.X - padding;
+		int32 count = rect.Width + padding * 2;
+		FMemory::Memcpy(&dest[(rect.Y - p) * pageSize + left], &dest[rect.Y * pageSize + left], count * sizeof(FColor));
+		FMemory::Memcpy(&dest[(rect.Y + rect.Height - 1 + p) * pageSize + left], &dest[(rect.Y + rect.Height - 1) * pageSize + left], count * sizeof(FColor));
+	}
+	return true;
+}
+
+void HotHudTextureAtlas::RebuildPage(int32 page) {
+	FMemory::Memzero(pageTexels_[page].GetData(), pageTexels_[page].Num() * sizeof(FColor));
+	// Anything we can't re-copy is left blank. Should only happen if a texture's mips went away.
+	packer_.ForEachEntryOnPage(page, [this](uint64 key, const HotHudAtlasEntry& entry) {
+		UTexture2D** texture = keyTextures_.Find(key);
+		if (texture != nullptr) {
+			CopyTexels(*texture, entry);
+		}
+	});
+	// Drop source textures for entries which were evicted.
+	for (auto it = keyTextures_.CreateIterator(); it; ++it) {
+		if (packer_.Find(it.Key()) == nullptr) {
+			it.RemoveCurrent();
+		}
+	}
+	pageRevisions_[page] = packer_.PageRevision(page);
+	MarkPageDirty(page, HotHudAtlasRect(0, 0, packer_.PageSize(), packer_.PageSize()));
+}
+
+void HotHudTextureAtlas::MarkPageDirty(int32 page, const HotHudAtlasRect& rect) {
+	HotHudAtlasRect& dirty = pageDirtyRects_[page];
+	if (dirty.Width == 0) {
+		dirty = rect;
+		return;
+	}
+	int32 right = FMath::Max(dirty.X + dirty.Width, rect.X + rect.Width);
+	int32 bottom = FMath::Max(dirty.Y + dirty.Height, rect.Y + rect.Height);
+	dirty.X = FMath::Min(dirty.X, rect.X);
+	dirty.Y = FMath::Min(dirty.Y, rect.Y);
+	dirty.Width = right - dirty.X;
+	dirty.Height = bottom - dirty.Y;
+}
+
+void HotHudTextureAtlas::FlushPendingUploads() {
+	int32 pageSize = packer_.PageSize();
+	for (int32 i = 0; i < pageTextures_.Num(); i++) {
+		HotHudAtlasRect& rect = pageDirtyRects_[i];
+		if (rect.Width == 0) {
+			continue;
+		}
+		UTexture2D* page = pageTextures_[i];
+		const FColor* source = pageTexels_[i].GetData() + rect.Y * pageSize + rect.X;
+		int32 rowBytes = rect.Width * sizeof(FColor);
+
+		// The texture's own mip is kept in step, so a re-created resource comes back with the same texels.
+		FTexture2DMipMap& mip = page->PlatformData->Mips[0];
+		FColor* mipTexels = static_cast<FColor*>(mip.BulkData.Lock(LOCK_READ_WRITE)) + rect.Y * pageSize + rect.X;
+		// Only the rect is sent to the GPU. The render thread gets its own copy as the shadow keeps changing.
+		uint8* regionTexels = static_cast<uint8*>(FMemory::Malloc(rect.Height * rowBytes));
+		for (int32 y = 0; y < rect.Height; y++) {
+			FMemory::Memcpy(mipTexels + y * pageSize, source + y * pageSize, rowBytes);
+			FMemory::Memcpy(regionTexels + y * rowBytes, source + y * pageSize, rowBytes);
+		}
+		mip.BulkData.Unlock();
+
+		FUpdateTextureRegion2D region(rect.X, rect.Y, 0, 0, rect.Width, rect.Height);
+		ENQUEUE_UNIQUE_RENDER_COMMAND_THREEPARAMETER(
+			HotHudAtlasUploadRegion,
+			FTexture2DResource*, Resource, static_cast<FTexture2DResource*>(page->Resource),
+			FUpdateTextureRegion2D, Region, region,
+			uint8*, Texels, regionTexels,
+			{
+				RHIUpdateTexture2D(Resource->GetTexture2DRHI(), 0, Region, Region.Width * sizeof(FColor), Texels);
+				FMemory::Free(Texels);
+			});
+		rect = HotHudAtlasRect();
+	}
+}
+
+const FTexture* HotHudTextureAtlas::PageResource(int32 page) const {
+	return pageTextures_[page]->Resource;
+}
+
+int32 HotHudTextureAtlas::GetAllocatedSize() const {
+	int32 pageBytes = packer_.PageSize() * packer_.PageSize() * sizeof(FColor);
+	int32 bytes = pageTextures_.Num() * pageBytes * 2;
+	for (int32 i = 0; i < pageTexels_.Num(); i++) {
+		bytes += pageTexels_[i].GetAllocatedSize();
+		bytes += pageBatches_[i].GetAllocatedSize();
+	}
+	bytes += pageTextures_.GetAllocatedSize() + pageTexels_.GetAllocatedSize() + pageRevisions_.GetAllocatedSize();
+	bytes += pageDirtyRects_.GetAllocatedSize() + pageBatches_.GetAllocatedSize();
+	bytes += keyTextures_.GetAllocatedSize() + rejectedTextures_.GetAllocatedSize();
+	return bytes;
+}
+
+TArray<FCanvasUVTri>& HotHudTextureAtlas::PageBatch(int32 page) {
+	return pageBatches_[page];
+}
+
+void HotHudTextureAtlas::AddReferencedObjects(FReferenceCollector& collector) {
+	collector.AddReferencedObjects(pageTextures_);
+	for (auto it = keyTextures_.CreateIterator(); it; ++it) {
+		collector.AddReferencedObject(it.Value());
+	}
+}
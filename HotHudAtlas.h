@@ -0,0 +1,88 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Runtime texture atlas used to batch tile icons. Packing is done by HotHudAtlasPacker; this
+ * layers UTexture2D pages and texel copying on top of it.
+ */
+#pragma once
+
+#include "HotHudAtlasPacker.h"
+
+// A set of UTexture2D atlas pages which tile icons are copied into, so that every tile on a page can
+// be drawn with a single FCanvasTriangleItem.
+//
+// Only textures whose first mip is resident in memory as uncompressed B8G8R8A8 can be copied. Anything
+// else is rejected (once - rejections are remembered) and should be drawn on its own as before.
+class HotHudTextureAtlas : public FGCObject {
+public:
+	HotHudTextureAtlas(int32 pageSize, int32 maxPages);
+	virtual ~HotHudTextureAtlas() {}
+
+	// Gets an atlas entry for Texture scaled to Width x Height, copying its texels in if needed.
+	// Returns the key to later Release() (0 if the texture can't be atlased).
+	uint64 Acquire(UTexture2D* texture, int32 width, int32 height);
+	void Release(uint64 key);
+	// Evicts every unreferenced entry (dropping its source texture) and rebuilds the affected pages.
+	// Returns the number evicted.
+	int32 EvictUnreferenced();
+
+	// Returns the UV rect (min in XY, max in ZW) and page for Key. Returns false if not resident.
+	bool GetUVs(uint64 key, int32& outPage, FVector4& outUVs) const;
+
+	// Uploads the parts of pages modified since the last call. Must be called before PageResource() is used.
+	void FlushPendingUploads();
+	const FTexture* PageResource(int32 page) const;
+	int32 NumPages() const { return pageTextures_.Num(); }
+
+	// Scratch triangle list for Page. Reset by the caller before use; kept to avoid re-allocation.
+	TArray<FCanvasUVTri>& PageBatch(int32 page);
+
+	const HotHudAtlasStats& Stats() const { return packer_.Stats(); }
+	// Approximate bytes held by the atlas: page shadows, page textures (CPU mip & GPU copies) and tables.
+	int32 GetAllocatedSize() const;
+
+	// FGCObject interface.
+	virtual void AddReferencedObjects(FReferenceCollector& collector) override;
+
+private:
+	static uint64 MakeKey(UTexture2D* texture, int32 width, int32 height);
+	// Makes sure we have a texture & CPU shadow for every packer page.
+	void SyncPages();
+	// Box-filters Texture into the shadow copy of its page at Entry.
+	bool CopyTexels(UTexture2D* texture, const HotHudAtlasEntry& entry);
+	// Re-copies every entry on a page after a re-pack moved them.
+	void RebuildPage(int32 page);
+	// Adds Rect to the part of Page uploaded by the next FlushPendingUploads().
+	void MarkPageDirty(int32 page, const HotHudAtlasRect& rect);
+
+	HotHudAtlasPacker packer_;
+	// Atlas page textures. Kept alive through AddReferencedObjects.
+	TArray<UTexture2D*> pageTextures_;
+	// CPU shadow copy of each page.
+	TArray<TArray<FColor>> pageTexels_;
+	// Packer revision each page shadow was last built for.
+	TArray<int32> pageRevisions_;
+	// Part of each page which needs to be uploaded. Empty (zero width) when the page is up to date.
+	TArray<HotHudAtlasRect> pageDirtyRects_;
+	// Triangle batches, one per page.
+	TArray<TArray<FCanvasUVTri>> pageBatches_;
+	// Source texture for each resident key, so pages can be rebuilt after a re-pack.
+	TMap<uint64, UTexture2D*> keyTextures_;
+	// Textures which can't be atlased. Weak, so they don't keep the textures alive and a texture
+	// created where a collected one used to be isn't taken for it.
+	TSet<TWeakObjectPtr<UTexture2D>> rejectedTextures_;
+};
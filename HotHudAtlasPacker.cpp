@@ -0,0 +1,323 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudAtlasPacker.h"
+
+/*****************************************************************************/
+
+HotHudAtlasPacker::HotHudAtlasPacker(int32 pageSize, int32 maxPages, int32 padding)
+	: pageSize_(pageSize),
+	maxPages_(maxPages),
+	padding_(padding) {
+}
+
+int32 HotHudAtlasPacker::AddPage() {
+	int32 index = pages_.AddDefaulted();
+	Page& page = pages_[index];
+	page.UsedTexels = 0;
+	page.ReclaimableTexels = 0;
+	page.Revision = 0;
+	ResetSkyline(page);
+	return index;
+}
+
+void HotHudAtlasPacker::ResetSkyline(Page& page) {
+	page.Skyline.Reset();
+	SkylineNode node;
+	node.X = 0;
+	node.Y = 0;
+	node.Width = pageSize_;
+	page.Skyline.Add(node);
+}
+
+int64 HotHudAtlasPacker::PaddedArea(const HotHudAtlasEntry& entry) const {
+	return (int64)(entry.Rect.Width + padding_ * 2) * (int64)(entry.Rect.Height + padding_ * 2);
+}
+
+int32 HotHudAtlasPacker::Fit(const Page& page, int32 nodeIndex, int32 paddedWidth, int32 paddedHeight) const {
+	int32 x = page.Skyline[nodeIndex].X;
+	if (x + paddedWidth > pageSize_) {
+		return -1;
+	}
+	int32 widthLeft = paddedWidth;
+	int32 y = page.Skyline[nodeIndex].Y;
+	int32 i = nodeIndex;
+	while (widthLeft > 0) {
+		if (i >= page.Skyline.Num()) {
+			return -1;
+		}
+		y = FMath::Max(y, page.Skyline[i].Y);
+		if (y + paddedHeight > pageSize_) {
+			return -1;
+		}
+		widthLeft -= page.Skyline[i].Width;
+		i++;
+	}
+	return y;
+}
+
+bool HotHudAtlasPacker::Insert(Page& page, int32 paddedWidth, int32 paddedHeight, int32& outX, int32& outY) {
+	// Bottom-left heuristic: lowest resulting top edge wins, ties go to the narrowest node.
+	int32 bestIndex = INDEX_NONE;
+	int32 bestTop = MAX_int32;
+	int32 bestWidth = MAX_int32;
+	for (int32 i = 0; i < page.Skyline.Num(); i++) {
+		int32 y = Fit(page, i, paddedWidth, paddedHeight);
+		if (y < 0) {
+			continue;
+		}
+		int32 top = y + paddedHeight;
+		if (top < bestTop || (top == bestTop && page.Skyline[i].Width < bestWidth)) {
+			bestIndex = i;
+			bestTop = top;
+			bestWidth = page.Skyline[i].Width;
+			outX = page.Skyline[i].X;
+			outY = y;
+		}
+	}
+	if (bestIndex == INDEX_NONE) {
+		return false;
+	}
+	AddSkylineLevel(page, bestIndex, outX, outY, paddedWidth, paddedHeight);
+	return true;
+}
+
+void HotHudAtlasPacker::AddSkylineLevel(Page& page, int32 nodeIndex, int32 x, int32 y, int32 paddedWidth, int32 paddedHeight) {
+	SkylineNode newNode;
+	newNode.X = x;
+	newNode.Y = y + paddedHeight;
+	newNode.Width = paddedWidth;
+	page.Skyline.Insert(newNode, nodeIndex);
+
+	// Trim (or drop) the nodes now covered by the new one.
+	for (int32 i = nodeIndex + 1; i < page.Skyline.Num(); i++) {
+		SkylineNode& node = page.Skyline[i];
+		const SkylineNode& previous = page.Skyline[i - 1];
+		int32 previousRight = previous.X + previous.Width;
+		if (node.X >= previousRight) {
+			break;
+		}
+		int32 shrink = previousRight - node.X;
+		node.X += shrink;
+		node.Width -= shrink;
+		if (node.Width > 0) {
+			break;
+		}
+		page.Skyline.RemoveAt(i);
+		i--;
+	}
+
+	// Merge neighbours at the same height.
+	for (int32 i = 0; i < page.Skyline.Num() - 1; i++) {
+		if (page.Skyline[i].Y == page.Skyline[i + 1].Y) {
+			page.Skyline[i].Width += page.Skyline[i + 1].Width;
+			page.Skyline.RemoveAt(i + 1);
+			i--;
+		}
+	}
+}
+
+const HotHudAtlasEntry* HotHudAtlasPacker::Acquire(uint64 key, int32 width, int32 height, uint32 frame, bool& isNew) {
+	isNew = false;
+	HotHudAtlasEntry* existing = entries_.Find(key);
+	if (existing != nullptr) {
+		if (existing->RefCount++ == 0) {
+			pages_[existing->Page].ReclaimableTexels -= PaddedArea(*existing);
+			stats_.NumReferencedEntries++;
+		}
+		existing->LastUsedFrame = frame;
+		UpdateStats();
+		return existing;
+	}
+
+	int32 paddedWidth = width + padding_ * 2;
+	int32 paddedHeight = height + padding_ * 2;
+	if (paddedWidth > pageSize_ || paddedHeight > pageSize_) {
+		stats_.Failures++;
+		return nullptr;
+	}
+
+	int32 x = 0;
+	int32 y = 0;
+	int32 pageIndex = INDEX_NONE;
+
+	// 1. Try to fit into an existing page as-is.
+	for (int32 i = 0; i < pages_.Num() && pageIndex == INDEX_NONE; i++) {
+		if (Insert(pages_[i], paddedWidth, paddedHeight, x, y)) {
+			pageIndex = i;
+		}
+	}
+
+	// 2. Grow.
+	if (pageIndex == INDEX_NONE && pages_.Num() < maxPages_) {
+		int32 newPage = AddPage();
+		if (Insert(pages_[newPage], paddedWidth, paddedHeight, x, y)) {
+			pageIndex = newPage;
+		}
+	}
+
+	// 3. Evict & re-pack pages, most reclaimable space first, until something fits.
+	if (pageIndex == INDEX_NONE) {
+		int64 needed = (int64)paddedWidth * (int64)paddedHeight;
+		TArray<int32> candidates;
+		for (int32 i = 0; i < pages_.Num(); i++) {
+			if (pages_[i].ReclaimableTexels >= needed) {
+				candidates.Add(i);
+			}
+		}
+		candidates.Sort([this](int32 a, int32 b) {
+			return pages_[a].ReclaimableTexels > pages_[b].ReclaimableTexels;
+		});
+		for (int32 candidate : candidates) {
+			Repack(candidate);
+			if (Insert(pages_[candidate], paddedWidth, paddedHeight, x, y)) {
+				pageIndex = candidate;
+				break;
+			}
+		}
+	}
+
+	if (pageIndex == INDEX_NONE) {
+		stats_.Failures++;
+		UpdateStats();
+		return nullptr;
+	}
+
+	HotHudAtlasEntry entry;
+	entry.Page = pageIndex;
+	entry.Rect = HotHudAtlasRect(x + padding_, y + padding_, width, height);
+	entry.RefCount = 1;
+	entry.LastUsedFrame = frame;
+	pages_[pageIndex].UsedTexels += (int64)paddedWidth * (int64)paddedHeight;
+	stats_.NumReferencedEntries++;
+	isNew = true;
+
+	HotHudAtlasEntry& added = entries_.Add(key, entry);
+	UpdateStats();
+	return &added;
+}
+
+void HotHudAtlasPacker::Release(uint64 key) {
+	HotHudAtlasEntry* entry = entries_.Find(key);
+	if (entry == nullptr || entry->RefCount == 0) {
+		return;
+	}
+	if (--entry->RefCount == 0) {
+		pages_[entry->Page].ReclaimableTexels += PaddedArea(*entry);
+		stats_.NumReferencedEntries--;
+	}
+	UpdateStats();
+}
+
+void HotHudAtlasPacker::Repack(int32 pageIndex) {
+	Page& page = pages_[pageIndex];
+
+	// Evict everything unreferenced and gather the survivors, tallest first (packs best on a skyline).
+	TArray<uint64> survivors;
+	for (auto it = entries_.CreateIterator(); it; ++it) {
+		if (it.Value().Page != pageIndex) {
+			continue;
+		}
+		if (it.Value().RefCount == 0) {
+			it.RemoveCurrent();
+			stats_.Evictions++;
+			continue;
+		}
+		survivors.Add(it.Key());
+	}
+	survivors.Sort([this](uint64 a, uint64 b) {
+		const HotHudAtlasEntry& entryA = entries_[a];
+		const HotHudAtlasEntry& entryB = entries_[b];
+		if (entryA.Rect.Height != entryB.Rect.Height) {
+			return entryA.Rect.Height > entryB.Rect.Height;
+		}
+		return entryA.Rect.Width > entryB.Rect.Width;
+	});
+
+	// Re-insert. Keep the old layout around in case the new ordering somehow packs worse.
+	TArray<SkylineNode> oldSkyline = page.Skyline;
+	TArray<HotHudAtlasRect> oldRects;
+	oldRects.Reserve(survivors.Num());
+	for (uint64 key : survivors) {
+		oldRects.Add(entries_[key].Rect);
+	}
+
+	ResetSkyline(page);
+	page.UsedTexels = 0;
+	page.ReclaimableTexels = 0;
+	bool ok = true;
+	for (uint64 key : survivors) {
+		HotHudAtlasEntry& entry = entries_[key];
+		int32 x, y;
+		if (!Insert(page, entry.Rect.Width + padding_ * 2, entry.Rect.Height + padding_ * 2, x, y)) {
+			ok = false;
+			break;
+		}
+		entry.Rect.X = x + padding_;
+		entry.Rect.Y = y + padding_;
+		page.UsedTexels += PaddedArea(entry);
+	}
+
+	if (!ok) {
+		// Put everything back where it was. The evicted space still isn't re-usable, but nothing is lost.
+		page.Skyline = oldSkyline;
+		page.UsedTexels = 0;
+		for (int32 i = 0; i < survivors.Num(); i++) {
+			HotHudAtlasEntry& entry = entries_[survivors[i]];
+			entry.Rect = oldRects[i];
+			page.UsedTexels += PaddedArea(entry);
+		}
+	}
+
+	page.Revision++;
+	stats_.Repacks++;
+	UpdateStats();
+}
+
+int32 HotHudAtlasPacker::EvictUnreferenced() {
+	int32 evicted = 0;
+	for (int32 i = 0; i < pages_.Num(); i++) {
+		if (pages_[i].ReclaimableTexels > 0) {
+			int32 before = entries_.Num();
+			Repack(i);
+			evicted += before - entries_.Num();
+		}
+	}
+	return evicted;
+}
+
+void HotHudAtlasPacker::Reset() {
+	pages_.Empty();
+	entries_.Empty();
+	stats_.NumReferencedEntries = 0;
+	UpdateStats();
+}
+
+void HotHudAtlasPacker::UpdateStats() {
+	stats_.NumPages = pages_.Num();
+	stats_.NumEntries = entries_.Num();
+	stats_.TotalTexels = (int64)pages_.Num() * (int64)pageSize_ * (int64)pageSize_;
+	stats_.UsedTexels = 0;
+	for (const Page& page : pages_) {
+		stats_.UsedTexels += page.UsedTexels;
+	}
+}
@@ -0,0 +1,161 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Skyline rectangle packer behind the tile icon atlas (see HotHudAtlas.h).
+ *
+ * HotHudAtlasPacker only deals in rectangles and keys - it never touches a texture or the
+ * renderer, so it only needs Core and is exercised headlessly by HotHudAtlasPackerTest.cpp.
+ */
+#pragma once
+
+// A rectangle within an atlas page, in texels.
+struct HotHudAtlasRect {
+	int32 X;
+	int32 Y;
+	int32 Width;
+	int32 Height;
+
+	HotHudAtlasRect() : X(0), Y(0), Width(0), Height(0) {}
+	HotHudAtlasRect(int32 x, int32 y, int32 width, int32 height) : X(x), Y(y), Width(width), Height(height) {}
+};
+
+// A packed entry.
+struct HotHudAtlasEntry {
+	// Page the entry lives on.
+	int32 Page;
+	// Location of the entry (excluding padding) on its page.
+	HotHudAtlasRect Rect;
+	// Number of outstanding Acquire() calls. Unreferenced entries stay resident until the space is needed.
+	int32 RefCount;
+	// Caller supplied frame number of the last Acquire().
+	uint32 LastUsedFrame;
+};
+
+// Packer counters.
+struct HotHudAtlasStats {
+	// Number of pages in use.
+	int32 NumPages;
+	// Number of resident entries (referenced or not).
+	int32 NumEntries;
+	// Number of resident entries with a non-zero reference count.
+	int32 NumReferencedEntries;
+	// Texels covered by resident entries, padding included.
+	int64 UsedTexels;
+	// Total number of texels across all pages.
+	int64 TotalTexels;
+	// Number of unreferenced entries evicted to make room.
+	int32 Evictions;
+	// Number of page re-packs.
+	int32 Repacks;
+	// Number of Acquire() calls which could not be satisfied.
+	int32 Failures;
+
+	HotHudAtlasStats()
+		: NumPages(0), NumEntries(0), NumReferencedEntries(0), UsedTexels(0), TotalTexels(0),
+		Evictions(0), Repacks(0), Failures(0) {}
+
+	float Occupancy() const { return TotalTexels > 0 ? (float)((double)UsedTexels / (double)TotalTexels) : 0.0f; }
+};
+
+// Multi-page skyline (bottom-left) rectangle packer with reference counted, evictable entries.
+//
+// Skyline packing can't reclaim individual holes, so released entries are kept resident (and
+// re-usable) until an Acquire() doesn't fit. At that point the page with the most reclaimable
+// space has its unreferenced entries evicted and its referenced entries re-packed. Every re-pack
+// bumps the page's revision so the owner knows its contents moved.
+class HotHudAtlasPacker {
+public:
+	// PageSize is the width & height of each page in texels.
+	// MaxPages is the maximum number of pages that will be created.
+	// Padding is the number of texels of gutter placed around each entry.
+	HotHudAtlasPacker(int32 pageSize, int32 maxPages, int32 padding);
+
+	// Finds the entry for Key or makes room for a new Width x Height one. Increments its reference
+	// count. Returns nullptr if there is no room even after eviction & re-packing. The returned
+	// pointer is only valid until the next call which modifies the packer.
+	// IsNew is set if the entry was just placed and its contents need to be written.
+	const HotHudAtlasEntry* Acquire(uint64 key, int32 width, int32 height, uint32 frame, bool& isNew);
+
+	// Drops a reference to Key. The entry stays resident until its space is needed.
+	void Release(uint64 key);
+
+	// Returns the entry for Key or nullptr if it isn't resident.
+	const HotHudAtlasEntry* Find(uint64 key) const { return entries_.Find(key); }
+
+	// Revision of Page. Changes whenever entries on the page are moved by a re-pack.
+	int32 PageRevision(int32 page) const { return pages_[page].Revision; }
+	int32 NumPages() const { return pages_.Num(); }
+	int32 PageSize() const { return pageSize_; }
+	int32 Padding() const { return padding_; }
+
+	// Calls Visitor(key, entry) for every entry resident on Page.
+	template <typename VisitorType>
+	void ForEachEntryOnPage(int32 page, VisitorType visitor) const {
+		for (auto it = entries_.CreateConstIterator(); it; ++it) {
+			if (it.Value().Page == page) {
+				visitor(it.Key(), it.Value());
+			}
+		}
+	}
+
+	// Evicts every unreferenced entry. Returns the number evicted.
+	int32 EvictUnreferenced();
+
+	// Drops every entry and page. Counters are kept.
+	void Reset();
+
+	const HotHudAtlasStats& Stats() const { return stats_; }
+
+private:
+	struct SkylineNode {
+		int32 X;
+		int32 Y;
+		int32 Width;
+	};
+
+	struct Page {
+		TArray<SkylineNode> Skyline;
+		// Texels (padding included) covered by resident entries.
+		int64 UsedTexels;
+		// Texels which would be freed by evicting unreferenced entries.
+		int64 ReclaimableTexels;
+		int32 Revision;
+	};
+
+	// Adds a fresh, empty page. Returns its index.
+	int32 AddPage();
+	void ResetSkyline(Page& page);
+
+	// Tries to place a PaddedWidth x PaddedHeight rectangle on Page. Returns true on success.
+	bool Insert(Page& page, int32 paddedWidth, int32 paddedHeight, int32& outX, int32& outY);
+	// Returns the Y at which the rectangle fits on top of the skyline starting at NodeIndex, or -1.
+	int32 Fit(const Page& page, int32 nodeIndex, int32 paddedWidth, int32 paddedHeight) const;
+	void AddSkylineLevel(Page& page, int32 nodeIndex, int32 x, int32 y, int32 paddedWidth, int32 paddedHeight);
+
+	// Evicts the unreferenced entries on PageIndex and re-packs the rest.
+	void Repack(int32 pageIndex);
+
+	int64 PaddedArea(const HotHudAtlasEntry& entry) const;
+	void UpdateStats();
+
+	int32 pageSize_;
+	int32 maxPages_;
+	int32 padding_;
+	TArray<Page> pages_;
+	TMap<uint64, HotHudAtlasEntry> entries_;
+	HotHudAtlasStats stats_;
+};
@@ -0,0 +1,115 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudAtlasPacker.h"
+
+// Headless checks of the atlas packer. Run with e.g.
+//   UE4Editor-Cmd <project> -nullrhi -ExecCmds="Automation RunTests HotHud.AtlasPacker; Quit"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHotHudAtlasPackerTest, "HotHud.AtlasPacker", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+// Page geometry used throughout: 62x62 entries plus a texel of padding each side fill a 256 page 4 x 4.
+static const int32 kTestPageSize = 256;
+static const int32 kTestEntrySize = 62;
+static const int32 kTestPaddedSize = 64;
+static const int32 kTestEntriesPerPage = 16;
+
+// True if no two resident entries (padding included) overlap and all of them lie within their page.
+static bool EntriesAreDisjoint(const HotHudAtlasPacker& packer) {
+	for (int32 page = 0; page < packer.NumPages(); page++) {
+		TArray<HotHudAtlasRect> rects;
+		packer.ForEachEntryOnPage(page, [&rects, &packer](uint64 key, const HotHudAtlasEntry& entry) {
+			int32 padding = packer.Padding();
+			rects.Add(HotHudAtlasRect(entry.Rect.X - padding, entry.Rect.Y - padding, entry.Rect.Width + padding * 2, entry.Rect.Height + padding * 2));
+		});
+		for (int32 i = 0; i < rects.Num(); i++) {
+			const HotHudAtlasRect& a = rects[i];
+			if (a.X < 0 || a.Y < 0 || a.X + a.Width > packer.PageSize() || a.Y + a.Height > packer.PageSize()) {
+				return false;
+			}
+			for (int32 j = i + 1; j < rects.Num(); j++) {
+				const HotHudAtlasRect& b = rects[j];
+				if (a.X < b.X + b.Width && b.X < a.X + a.Width && a.Y < b.Y + b.Height && b.Y < a.Y + a.Height) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool FHotHudAtlasPackerTest::RunTest(const FString& parameters) {
+	HotHudAtlasPacker packer(kTestPageSize, 1, 1);
+	bool isNew = false;
+
+	// Pack: a full page, then one more which doesn't fit.
+	for (int32 key = 1; key <= kTestEntriesPerPage; key++) {
+		const HotHudAtlasEntry* entry = packer.Acquire(key, kTestEntrySize, kTestEntrySize, 0, isNew);
+		TestTrue(FString::Printf(TEXT("Entry %d packed"), key), entry != nullptr && isNew);
+	}
+	TestTrue(TEXT("Packed entries are disjoint"), EntriesAreDisjoint(packer));
+	TestEqual(TEXT("Pages after packing"), packer.Stats().NumPages, 1);
+	TestEqual(TEXT("Entries after packing"), packer.Stats().NumEntries, kTestEntriesPerPage);
+	TestTrue(TEXT("Full page is fully occupied"), packer.Stats().UsedTexels == packer.Stats().TotalTexels);
+	TestTrue(TEXT("Overflow is refused"), packer.Acquire(100, kTestEntrySize, kTestEntrySize, 0, isNew) == nullptr);
+	TestEqual(TEXT("Failures after overflow"), packer.Stats().Failures, 1);
+	TestTrue(TEXT("Oversized entry is refused"), packer.Acquire(101, kTestPageSize, 1, 0, isNew) == nullptr);
+	TestEqual(TEXT("Failures after oversized entry"), packer.Stats().Failures, 2);
+
+	// Re-acquiring a resident entry doesn't place it again.
+	const HotHudAtlasEntry* again = packer.Acquire(1, kTestEntrySize, kTestEntrySize, 1, isNew);
+	TestTrue(TEXT("Resident entry is found"), again != nullptr && !isNew && again->RefCount == 2);
+	packer.Release(1);
+
+	// Evict: released entries stay resident until their space is needed.
+	for (int32 key = 1; key <= kTestEntriesPerPage; key += 2) {
+		packer.Release(key);
+	}
+	TestEqual(TEXT("Entries after release"), packer.Stats().NumEntries, kTestEntriesPerPage);
+	TestEqual(TEXT("Referenced entries after release"), packer.Stats().NumReferencedEntries, kTestEntriesPerPage / 2);
+	TestEqual(TEXT("Evictions before repack"), packer.Stats().Evictions, 0);
+
+	// Repack: the next entry evicts the released ones and moves the rest together.
+	int32 revision = packer.PageRevision(0);
+	const HotHudAtlasEntry* repacked = packer.Acquire(200, kTestEntrySize, kTestEntrySize, 2, isNew);
+	TestTrue(TEXT("Entry packed after eviction"), repacked != nullptr && isNew);
+	TestEqual(TEXT("Evictions after repack"), packer.Stats().Evictions, kTestEntriesPerPage / 2);
+	TestEqual(TEXT("Repacks"), packer.Stats().Repacks, 1);
+	TestTrue(TEXT("Page revision changes on repack"), packer.PageRevision(0) != revision);
+	TestEqual(TEXT("Entries after repack"), packer.Stats().NumEntries, kTestEntriesPerPage / 2 + 1);
+	TestTrue(TEXT("Used texels after repack"), packer.Stats().UsedTexels == (int64)(kTestEntriesPerPage / 2 + 1) * kTestPaddedSize * kTestPaddedSize);
+	TestTrue(TEXT("Repacked entries are disjoint"), EntriesAreDisjoint(packer));
+	for (int32 key = 2; key <= kTestEntriesPerPage; key += 2) {
+		TestTrue(FString::Printf(TEXT("Referenced entry %d survives"), key), packer.Find(key) != nullptr);
+	}
+
+	// Explicit eviction only drops what's unreferenced.
+	packer.Release(200);
+	TestEqual(TEXT("Evicted explicitly"), packer.EvictUnreferenced(), 1);
+	TestEqual(TEXT("Entries after explicit eviction"), packer.Stats().NumEntries, kTestEntriesPerPage / 2);
+	TestTrue(TEXT("Occupancy after explicit eviction"), FMath::IsNearlyEqual(packer.Stats().Occupancy(), 0.5f));
+
+	packer.Reset();
+	TestEqual(TEXT("Pages after reset"), packer.Stats().NumPages, 0);
+	TestEqual(TEXT("Evictions are kept across reset"), packer.Stats().Evictions, kTestEntriesPerPage / 2 + 1);
+	return true;
+}
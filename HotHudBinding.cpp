@@ -0,0 +1,128 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudBinding.h"
+
+/*****************************************************************************/
+
+bool HotHudPropertyPath::Resolve(UClass* rootClass, const FString& path, FString& error) {
+	hopOffsets_.Reset();
+	hopProperties_.Reset();
+	leafOffset_ = 0;
+	leaf_ = nullptr;
+
+	TArray<FString> segments;
+	path.ParseIntoArray(&segments, TEXT("."), true);
+	if (segments.Num() == 0) {
+		error = TEXT("Empty property path");
+		return false;
+	}
+
+	UStruct* container = rootClass;
+	int32 offset = 0;
+	for (int32 i = 0; i < segments.Num(); i++) {
+		UProperty* property = FindField<UProperty>(container, FName(*segments[i]));
+		if (property == nullptr) {
+			error = FString::Printf(TEXT("No property '%s' in '%s'"), *segments[i], *container->GetName());
+			return false;
+		}
+		offset += property->GetOffset_ForInternal();
+
+		if (i == segments.Num() - 1) {
+			if (!property->IsA(UNumericProperty::StaticClass()) && !property->IsA(UBoolProperty::StaticClass()) &&
+				!property->IsA(UStrProperty::StaticClass()) && !property->IsA(UNameProperty::StaticClass()) &&
+				!property->IsA(UTextProperty::StaticClass())) {
+				error = FString::Printf(TEXT("'%s' is not a number, bool or string"), *segments[i]);
+				return false;
+			}
+			leaf_ = property;
+			leafOffset_ = offset;
+		}
+		else if (UStructProperty* structProperty = Cast<UStructProperty>(property)) {
+			// Struct members live inline, so their offset simply accumulates.
+			container = structProperty->Struct;
+		}
+		else if (UObjectPropertyBase* objectProperty = Cast<UObjectPropertyBase>(property)) {
+			hopOffsets_.Add(offset);
+			hopProperties_.Add(objectProperty);
+			offset = 0;
+			container = objectProperty->PropertyClass;
+		}
+		else {
+			error = FString::Printf(TEXT("'%s' is not a struct or object"), *segments[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool HotHudPropertyPath::IsNumeric() const {
+	return leaf_ != nullptr && (leaf_->IsA(UNumericProperty::StaticClass()) || leaf_->IsA(UBoolProperty::StaticClass()));
+}
+
+const uint8* HotHudPropertyPath::ResolveValue(UObject* root) const {
+	const uint8* container = reinterpret_cast<const uint8*>(root);
+	for (int32 i = 0; i < hopOffsets_.Num(); i++) {
+		if (container == nullptr) {
+			return nullptr;
+		}
+		container = reinterpret_cast<const uint8*>(hopProperties_[i]->GetObjectPropertyValue(container + hopOffsets_[i]));
+	}
+	return (container != nullptr) ? container + leafOffset_ : nullptr;
+}
+
+bool HotHudPropertyPath::ReadNumber(UObject* root, double& out) const {
+	const uint8* value = ResolveValue(root);
+	if (value == nullptr) {
+		return false;
+	}
+	if (UNumericProperty* numeric = Cast<UNumericProperty>(leaf_)) {
+		out = numeric->IsFloatingPoint() ? numeric->GetFloatingPointPropertyValue(value) : (double)numeric->GetSignedIntPropertyValue(value);
+	}
+	else {
+		out = static_cast<UBoolProperty*>(leaf_)->GetPropertyValue(value) ? 1.0 : 0.0;
+	}
+	return true;
+}
+
+bool HotHudPropertyPath::ReadText(UObject* root, FString& out) const {
+	const uint8* value = ResolveValue(root);
+	if (value == nullptr) {
+		return false;
+	}
+	if (UStrProperty* str = Cast<UStrProperty>(leaf_)) {
+		out = str->GetPropertyValue(value);
+	}
+	else if (UNameProperty* name = Cast<UNameProperty>(leaf_)) {
+		out = name->GetPropertyValue(value).ToString();
+	}
+	else if (UTextProperty* text = Cast<UTextProperty>(leaf_)) {
+		out = text->GetPropertyValue(value).ToString();
+	}
+	else if (UNumericProperty* numeric = Cast<UNumericProperty>(leaf_)) {
+		out = numeric->GetNumericPropertyValueToString(value);
+	}
+	else {
+		out = static_cast<UBoolProperty*>(leaf_)->GetPropertyValue(value) ? TEXT("true") : TEXT("false");
+	}
+	return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Reflection based property paths used to bind controls to gameplay values.
+ */
+#pragma once
+
+// A dotted path (e.g. "Inventory.Gold") from an object to a numeric, bool or string property, resolved
+// once against a class to a list of offsets. Reading the value then only costs pointer arithmetic
+// plus one dereference per object hop.
+class HotHudPropertyPath {
+public:
+	HotHudPropertyPath() : leafOffset_(0), leaf_(nullptr) {}
+
+	// Resolves Path against Class. Struct members are folded into a single offset; object references are
+	// followed at read time. Returns false (with the reason in Error) if a segment can't be found, an
+	// intermediate segment isn't a struct or object, or the last one isn't a supported type.
+	bool Resolve(UClass* rootClass, const FString& path, FString& error);
+
+	// True if the leaf is a number or bool (readable by ReadNumber()).
+	bool IsNumeric() const;
+	// Reads the value from Root. Returns false if an object along the path is null.
+	bool ReadNumber(UObject* root, double& out) const;
+	// Reads the value as text into Out (numbers are formatted). Returns false if an object along the path is null.
+	bool ReadText(UObject* root, FString& out) const;
+	int32 GetAllocatedSize() const { return hopOffsets_.GetAllocatedSize() + hopProperties_.GetAllocatedSize(); }
+
+private:
+	// Returns a pointer to the leaf value, or nullptr if an object along the path is null.
+	const uint8* ResolveValue(UObject* root) const;
+
+	// Offsets (from the current container) of each object reference to follow, in order, and the
+	// properties they belong to. Weak, lazy & asset references aren't plain pointers, so each hop is
+	// read through its property.
+	TArray<int32> hopOffsets_;
+	TArray<UObjectPropertyBase*> hopProperties_;
+	// Offset of the leaf from the last container.
+	int32 leafOffset_;
+	UProperty* leaf_;
+};
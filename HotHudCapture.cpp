@@ -0,0 +1,119 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHud.h"
+#include "HotHudCapture.h"
+
+/*****************************************************************************/
+
+HotHudDrawCapture::HotHudDrawCapture(const FString& path, int32 numFrames)
+	: path_(path),
+	framesLeft_(numFrames) {
+}
+
+void HotHudDrawCapture::BeginFrame(uint64 frameNumber) {
+	HotHudCaptureFrame& frame = frames_[frames_.AddUninitialized()];
+	frame.FrameNumber = frameNumber;
+	frame.FirstCommand = commands_.Num();
+	frame.NumCommands = 0;
+}
+
+bool HotHudDrawCapture::EndFrame() {
+	HotHudCaptureFrame& frame = frames_.Last();
+	frame.NumCommands = commands_.Num() - frame.FirstCommand;
+	return --framesLeft_ <= 0;
+}
+
+void HotHudDrawCapture::Record(
+	HotHudCaptureCommandType type, const HotHudControl* control,
+	float x, float y, float width, float height, const FLinearColor& color,
+	const UObject* texture, uint32 textHash) {
+	HotHudCaptureCommand& command = commands_[commands_.AddZeroed()];
+	command.Type = (uint8)type;
+	command.Color = color.ToFColor(true).DWColor();
+	command.X = x;
+	command.Y = y;
+	command.Width = width;
+	command.Height = height;
+	command.TextureId = TextureId(texture);
+	command.TextHash = textHash;
+	command.ControlId = ControlId(control);
+}
+
+uint32 HotHudDrawCapture::ControlId(const HotHudControl* control) {
+	if (control == nullptr) {
+		return kHotHudCaptureNoControl;
+	}
+	// Keyed by name rather than pointer so that a control re-created mid capture keeps its id.
+	const uint32* id = controlIds_.Find(control->Name());
+	if (id != nullptr) {
+		return *id;
+	}
+	uint32 newId = controlNames_.Add(control->Name().ToString());
+	controlIds_.Add(control->Name(), newId);
+	return newId;
+}
+
+uint32 HotHudDrawCapture::TextureId(const UObject* texture) {
+	if (texture == nullptr) {
+		return 0;
+	}
+	const uint32* id = textureIds_.Find(texture);
+	if (id != nullptr) {
+		return *id;
+	}
+	uint32 newId = FCrc::StrCrc32(*texture->GetPathName());
+	textureIds_.Add(texture, newId);
+	return newId;
+}
+
+bool HotHudDrawCapture::Write() const {
+	// Name section: the offset table, then the strings.
+	TArray<uint8> names;
+	names.AddZeroed(controlNames_.Num() * sizeof(uint32));
+	for (int32 i = 0; i < controlNames_.Num(); i++) {
+		FTCHARToUTF8 utf8(*controlNames_[i]);
+		((uint32*)names.GetData())[i] = names.Num();
+		names.Append((const uint8*)utf8.Get(), utf8.Length());
+		names.Add(0);
+	}
+
+	HotHudCaptureHeader header;
+	FMemory::Memzero(header);
+	header.Magic = kHotHudCaptureMagic;
+	header.Version = kHotHudCaptureVersion;
+	header.NumFrames = frames_.Num();
+	header.NumCommands = commands_.Num();
+	header.NumControls = controlNames_.Num();
+	header.FramesOffset = sizeof(HotHudCaptureHeader);
+	header.CommandsOffset = header.FramesOffset + frames_.Num() * sizeof(HotHudCaptureFrame);
+	header.NamesOffset = header.CommandsOffset + commands_.Num() * sizeof(HotHudCaptureCommand);
+	header.NamesSize = names.Num();
+
+	TArray<uint8> data;
+	data.Reserve(header.NamesOffset + header.NamesSize);
+	data.Append((const uint8*)&header, sizeof(header));
+	data.Append((const uint8*)frames_.GetData(), frames_.Num() * sizeof(HotHudCaptureFrame));
+	data.Append((const uint8*)commands_.GetData(), commands_.Num() * sizeof(HotHudCaptureCommand));
+	data.Append(names);
+	return FFileHelper::SaveArrayToFile(data, *path_);
+}
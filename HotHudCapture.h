@@ -0,0 +1,60 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Records the draw commands of one or more frames into a capture file (see HotHudCaptureFormat.h).
+ */
+#pragma once
+
+#include "HotHudCaptureFormat.h"
+
+class HotHudControl;
+
+class HotHudDrawCapture {
+public:
+	// Captures the next NumFrames frames into the file at Path.
+	HotHudDrawCapture(const FString& path, int32 numFrames);
+
+	void BeginFrame(uint64 frameNumber);
+	// Returns true once every requested frame has been captured.
+	bool EndFrame();
+
+	// Appends a command issued by Control (nullptr for the HUD itself).
+	void Record(
+		HotHudCaptureCommandType type, const HotHudControl* control,
+		float x, float y, float width, float height, const FLinearColor& color,
+		const UObject* texture = nullptr, uint32 textHash = 0);
+
+	// Writes everything captured so far. Returns false if the file couldn't be written.
+	bool Write() const;
+
+	const FString& Path() const { return path_; }
+	int32 NumCommands() const { return commands_.Num(); }
+
+private:
+	uint32 ControlId(const HotHudControl* control);
+	uint32 TextureId(const UObject* texture);
+
+	FString path_;
+	int32 framesLeft_;
+	TArray<HotHudCaptureFrame> frames_;
+	TArray<HotHudCaptureCommand> commands_;
+	// Name table, and the index of each name in it.
+	TArray<FString> controlNames_;
+	TMap<FName, uint32> controlIds_;
+	// Path name hashes, so each texture's path is only built once.
+	TMap<const UObject*, uint32> textureIds_;
+};
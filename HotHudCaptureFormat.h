@@ -0,0 +1,95 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * On-disk layout of draw captures (see AHotHud::StartDrawCapture).
+ *
+ * Plain C++ with no engine types so that the standalone tool in Tools/ can share it. A capture is
+ * written in one go and every section is an array of fixed size records at a known offset, so the
+ * file can be memory-mapped and read in place. All values are little-endian.
+ *
+ *   HotHudCaptureHeader
+ *   HotHudCaptureFrame[NumFrames]
+ *   HotHudCaptureCommand[NumCommands]     (frame by frame, in submission order)
+ *   uint32_t NameOffsets[NumControls]     (offsets into the string data which follows them)
+ *   NUL terminated UTF-8 control names
+ */
+#pragma once
+
+#include <stdint.h>
+
+// 'HHCP'. Bump the version whenever a record changes.
+static const uint32_t kHotHudCaptureMagic = 0x50434848;
+static const uint32_t kHotHudCaptureVersion = 1;
+
+// ControlId of commands which weren't issued by a control.
+static const uint32_t kHotHudCaptureNoControl = 0xFFFFFFFF;
+
+enum HotHudCaptureCommandType {
+	// Flat colored chrome rect, after clipping.
+	HotHudCapture_Rect = 0,
+	// A glyph run (or DrawText fallback). TextureId is the font, TextHash the string.
+	HotHudCapture_Text = 1,
+	// A tile image or drag cursor. TextureId is the texture (atlased or not).
+	HotHudCapture_Image = 2,
+	HotHudCapture_NumTypes = 3,
+};
+
+struct HotHudCaptureHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t NumFrames;
+	uint32_t NumCommands;
+	uint32_t NumControls;
+	// Byte offsets of each section from the start of the file.
+	uint32_t FramesOffset;
+	uint32_t CommandsOffset;
+	uint32_t NamesOffset;
+	// Size of the name section, offsets included.
+	uint32_t NamesSize;
+	uint32_t Reserved;
+};
+
+struct HotHudCaptureFrame {
+	// GFrameCounter of the frame.
+	uint64_t FrameNumber;
+	// Range of the frame's commands in the command array.
+	uint32_t FirstCommand;
+	uint32_t NumCommands;
+};
+
+struct HotHudCaptureCommand {
+	// HotHudCaptureCommandType.
+	uint8_t Type;
+	uint8_t Padding[3];
+	// Final color (opacity applied) as sRGB BGRA, i.e. FColor's packed DWORD.
+	uint32_t Color;
+	// Screen rect in control tree space. Text is sized by its glyph run (0x0 for the DrawText fallback).
+	float X;
+	float Y;
+	float Width;
+	float Height;
+	// CRC32 of the texture's / font's path name. 0 for chrome.
+	uint32_t TextureId;
+	// CRC32 of the drawn string. 0 for anything but text.
+	uint32_t TextHash;
+	// Index into the name table, or kHotHudCaptureNoControl.
+	uint32_t ControlId;
+};
+
+static_assert(sizeof(HotHudCaptureHeader) == 40, "Capture header layout changed");
+static_assert(sizeof(HotHudCaptureFrame) == 16, "Capture frame layout changed");
+static_assert(sizeof(HotHudCaptureCommand) == 36, "Capture command layout changed");
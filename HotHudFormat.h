@@ -0,0 +1,175 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Allocation free number formatting for labels bound to live values.
+ */
+#pragma once
+
+// Capacity (in characters) of the buffer a bound value is formatted into.
+static const int32 kHotHudFormatCapacity = 32;
+
+// 10^N at compile time.
+template <int32 N>
+struct THotHudPow10 {
+	static const int64 Value = 10 * THotHudPow10<N - 1>::Value;
+};
+template <>
+struct THotHudPow10<0> {
+	static const int64 Value = 1;
+};
+
+// Writes Value right to left ending just before End, zero padded to at least MinDigits. Returns the
+// first character written.
+inline TCHAR* HotHudWriteDigitsBackward(uint64 value, TCHAR* end, int32 minDigits) {
+	TCHAR* out = end;
+	do {
+		*--out = TEXT('0') + (TCHAR)(value % 10);
+		value /= 10;
+		minDigits--;
+	} while (value != 0 || minDigits > 0);
+	return out;
+}
+
+// Copies [Start, End) to Out. Returns the number of characters copied.
+inline int32 HotHudCopyDigits(const TCHAR* start, const TCHAR* end, TCHAR* out) {
+	int32 len = end - start;
+	FMemory::Memcpy(out, start, len * sizeof(TCHAR));
+	return len;
+}
+
+// Format specs. Key() maps a value to an integer which changes exactly when the displayed text does,
+// so callers only re-format (and re-layout) when the text would actually differ. Format() writes the
+// text for a key into Out (at least kHotHudFormatCapacity characters) and returns its length.
+
+// Whole numbers, e.g. "1250".
+struct HotHudIntegerFormat {
+	static int64 Key(double value) { return (int64)FMath::FloorToDouble(value + 0.5); }
+	static int32 Format(int64 key, TCHAR* out) {
+		TCHAR digits[kHotHudFormatCapacity];
+		TCHAR* end = digits + kHotHudFormatCapacity;
+		TCHAR* start = HotHudWriteDigitsBackward((key < 0) ? -key : key, end, 1);
+		if (key < 0) {
+			*--start = TEXT('-');
+		}
+		return HotHudCopyDigits(start, end, out);
+	}
+};
+
+// Fixed point with Decimals digits after the point, e.g. "59.94" for Decimals = 2.
+template <int32 Decimals>
+struct THotHudFixedFormat {
+	static int64 Key(double value) { return (int64)FMath::FloorToDouble(value * THotHudPow10<Decimals>::Value + 0.5); }
+	static int32 Format(int64 key, TCHAR* out) {
+		uint64 magnitude = (key < 0) ? -key : key;
+		TCHAR digits[kHotHudFormatCapacity];
+		TCHAR* end = digits + kHotHudFormatCapacity;
+		TCHAR* start = end;
+		if (Decimals > 0) {
+			start = HotHudWriteDigitsBackward(magnitude % THotHudPow10<Decimals>::Value, end, Decimals);
+			*--start = TEXT('.');
+		}
+		start = HotHudWriteDigitsBackward(magnitude / THotHudPow10<Decimals>::Value, start, 1);
+		if (key < 0) {
+			*--start = TEXT('-');
+		}
+		return HotHudCopyDigits(start, end, out);
+	}
+};
+
+// A duration in seconds as "m:ss", or "h:mm:ss" from an hour up. Negative durations show as 0:00.
+struct HotHudClockFormat {
+	static int64 Key(double value) { return (value > 0) ? (int64)value : 0; }
+	static int32 Format(int64 key, TCHAR* out) {
+		TCHAR digits[kHotHudFormatCapacity];
+		TCHAR* end = digits + kHotHudFormatCapacity;
+		TCHAR* start = HotHudWriteDigitsBackward(key % 60, end, 2);
+		*--start = TEXT(':');
+		if (key >= 3600) {
+			start = HotHudWriteDigitsBackward((key / 60) % 60, start, 2);
+			*--start = TEXT(':');
+			start = HotHudWriteDigitsBackward(key / 3600, start, 1);
+		}
+		else {
+			start = HotHudWriteDigitsBackward(key / 60, start, 1);
+		}
+		return HotHudCopyDigits(start, end, out);
+	}
+};
+
+// A numeric source bound to a label. Implemented by THotHudLabelBinding.
+class HotHudLabelBinding {
+public:
+	virtual ~HotHudLabelBinding() {}
+
+	// Samples the source. Returns true, with the formatted value in Out and its length in Len, if the
+	// displayed value changed since the last call (or on the first call).
+	virtual bool Update(TCHAR* out, int32& len) = 0;
+};
+
+// Binds a reader (anything callable with no arguments which returns a number) to a format spec. Both
+// are template arguments so sampling and formatting are resolved at compile time.
+template <typename FormatType, typename ReaderType>
+class THotHudLabelBinding : public HotHudLabelBinding {
+public:
+	explicit THotHudLabelBinding(const ReaderType& reader) : reader_(reader), hasKey_(false), key_(0) {}
+
+	virtual bool Update(TCHAR* out, int32& len) override {
+		int64 key = FormatType::Key((double)reader_());
+		if (hasKey_ && key == key_) {
+			return false;
+		}
+		hasKey_ = true;
+		key_ = key;
+		len = FormatType::Format(key, out);
+		return true;
+	}
+
+private:
+	ReaderType reader_;
+	bool hasKey_;
+	int64 key_;
+};
+
+template <typename FormatType, typename ReaderType>
+HotHudLabelBinding* MakeHotHudLabelBinding(const ReaderType& reader) {
+	return new THotHudLabelBinding<FormatType, ReaderType>(reader);
+}
+
+// Reads a value through a pointer. The value must outlive the binding.
+template <typename ValueType>
+struct THotHudPointerReader {
+	const ValueType* Value;
+
+	explicit THotHudPointerReader(const ValueType* value) : Value(value) {}
+	ValueType operator()() const { return *Value; }
+};
+
+// Reads a numeric UPROPERTY of an object. Reads 0 once the object is gone.
+struct HotHudPropertyReader {
+	TWeakObjectPtr<UObject> Object;
+	UNumericProperty* Property;
+
+	HotHudPropertyReader(UObject* object, UNumericProperty* property) : Object(object), Property(property) {}
+	double operator()() const {
+		UObject* object = Object.Get();
+		if (object == nullptr) {
+			return 0;
+		}
+		const void* value = Property->ContainerPtrToValuePtr<void>(object);
+		return Property->IsFloatingPoint() ? Property->GetFloatingPointPropertyValue(value) : (double)Property->GetSignedIntPropertyValue(value);
+	}
+};
@@ -0,0 +1,57 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHud.h"
+
+// Soaks a HUD without drawing it, or even spawning it into a world. Run with e.g.
+//   UE4Editor-Cmd <project> -nullrhi -ExecCmds="Automation RunTests HotHud.Soak; Quit"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHotHudSoakTest, "HotHud.Soak", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+static const int32 kTestOperations = 5000;
+
+bool FHotHudSoakTest::RunTest(const FString& Parameters) {
+	AHotHud* hud = NewObject<AHotHud>();
+	bool error;
+
+	FHotHudSoakReport report;
+	hud->RunSoak(1234, kTestOperations, 25, report, error);
+	TestFalse(TEXT("Soak started"), error);
+	TestEqual(TEXT("Invariant violations"), report.InvariantViolations, 0);
+	TestEqual(TEXT("Operations run"), report.OperationsRun, kTestOperations);
+	TestEqual(TEXT("Steps run"), report.FramesRun, kTestOperations / 25);
+	TestTrue(TEXT("Controls were created"), report.PeakControls > 0);
+
+	// The same seed replays the same run. It only starts if the first run deleted its controls.
+	FHotHudSoakReport replay;
+	hud->RunSoak(1234, kTestOperations, 25, replay, error);
+	TestFalse(TEXT("Replay started"), error);
+	TestEqual(TEXT("Replay peak controls"), replay.PeakControls, report.PeakControls);
+
+	// A run which can't start leaves an empty report.
+	hud->RunSoak(1234, 0, 25, replay, error);
+	TestTrue(TEXT("Empty soak is rejected"), error);
+	TestEqual(TEXT("Rejected soak report"), replay.OperationsRun, 0);
+
+	hud->MarkPendingKill();
+	return true;
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Shared, interned control styles.
+ */
+#pragma once
+
+// A set of build options shared by every control using it. Define() edits a style in place and bumps
+// Revision, so each user refreshes whatever it derived from the options on its next draw.
+template <typename OptionsType>
+struct THotHudStyle {
+	// Name the style was defined under. NAME_None for anonymous (interned) styles.
+	FName Name;
+	OptionsType Options;
+	int32 Revision;
+
+	THotHudStyle(const FName& name, const OptionsType& options) : Name(name), Options(options), Revision(0) {}
+};
+
+// The named and anonymous styles of one control type.
+//
+// Anonymous styles are interned by value so that controls created with identical build options share
+// a single copy. OptionsType needs GetStyleHash(const OptionsType&) and
+// StylesEqual(const OptionsType&, const OptionsType&) overloads.
+template <typename OptionsType>
+class THotHudStyleRegistry {
+public:
+	typedef THotHudStyle<OptionsType> StyleType;
+
+	// Creates the style Name, or replaces the options of an existing one so that all of its users
+	// are restyled at once.
+	TSharedRef<StyleType> Define(const FName& name, const OptionsType& options) {
+		TSharedRef<StyleType>* found = named_.Find(name);
+		if (found != nullptr) {
+			(*found)->Options = options;
+			(*found)->Revision++;
+			return *found;
+		}
+		TSharedRef<StyleType> style = MakeShareable(new StyleType(name, options));
+		named_.Add(name, style);
+		return style;
+	}
+
+	// Returns the style Name, or an invalid pointer if it hasn't been defined.
+	TSharedPtr<StyleType> Find(const FName& name) const {
+		const TSharedRef<StyleType>* found = named_.Find(name);
+		return (found != nullptr) ? TSharedPtr<StyleType>(*found) : TSharedPtr<StyleType>();
+	}
+
+	// Returns the anonymous style with Options, creating it if needed.
+	TSharedRef<StyleType> Intern(const OptionsType& options) {
+		uint32 hash = GetStyleHash(options);
+		for (auto it = anonymous_.CreateKeyIterator(hash); it; ++it) {
+			if (StylesEqual(it.Value()->Options, options)) {
+				return it.Value();
+			}
+		}
+		TSharedRef<StyleType> style = MakeShareable(new StyleType(NAME_None, options));
+		anonymous_.Add(hash, style);
+		return style;
+	}
+
+	// Drops anonymous styles which no control uses any more. Named styles are kept.
+	void Trim() {
+		for (auto it = anonymous_.CreateIterator(); it; ++it) {
+			if (it.Value().IsUnique()) {
+				it.RemoveCurrent();
+			}
+		}
+	}
+
+	// Calls Visitor(style) for every named style.
+	template <typename VisitorType>
+	void ForEachNamed(VisitorType visitor) const {
+		for (auto it = named_.CreateConstIterator(); it; ++it) {
+			visitor(*it.Value());
+		}
+	}
+
+	int32 NumNamed() const { return named_.Num(); }
+	int32 NumAnonymous() const { return anonymous_.Num(); }
+	// Bytes held by the registry and its styles (not counting strings inside the options).
+	int32 GetAllocatedSize() const {
+		return named_.GetAllocatedSize() + anonymous_.GetAllocatedSize() + (named_.Num() + anonymous_.Num()) * sizeof(StyleType);
+	}
+
+private:
+	TMap<FName, TSharedRef<StyleType>> named_;
+	TMultiMap<uint32, TSharedRef<StyleType>> anonymous_;
+};
@@ -0,0 +1,713 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudText.h"
+#include "ParallelFor.h"
+
+/*****************************************************************************/
+
+void HotHudFindLineStarts(const TCHAR* text, int32 length, TArray<int32>& lineStarts) {
+	lineStarts.Add(0);
+	if (length < kHotHudParallelTextMinChars) {
+		for (int32 i = 0; i < length; i++) {
+			if (text[i] == TEXT('\n')) {
+				lineStarts.Add(i + 1);
+			}
+		}
+		return;
+	}
+
+	// Each chunk collects its own line starts; they're concatenated in chunk order afterwards.
+	int32 numChunks = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 2, 32);
+	int32 chunkSize = (length + numChunks - 1) / numChunks;
+	TArray<TArray<int32>> chunkStarts;
+	chunkStarts.AddDefaulted(numChunks);
+	ParallelFor(numChunks, [text, length, chunkSize, &chunkStarts](int32 chunk) {
+		int32 end = FMath::Min(length, (chunk + 1) * chunkSize);
+		TArray<int32>& starts = chunkStarts[chunk];
+		for (int32 i = chunk * chunkSize; i < end; i++) {
+			if (text[i] == TEXT('\n')) {
+				starts.Add(i + 1);
+			}
+		}
+	});
+	int32 numLines = lineStarts.Num();
+	for (const TArray<int32>& starts : chunkStarts) {
+		numLines += starts.Num();
+	}
+	lineStarts.Reserve(numLines);
+	for (const TArray<int32>& starts : chunkStarts) {
+		lineStarts.Append(starts);
+	}
+}
+
+/*****************************************************************************/
+
+void HotHudTextBatch::Add(const HotHudGlyphRun& run, const FVector2D& location, float opacity) {
+	for (const HotHudGlyphRun::Batch& runBatch : run.Batches) {
+		// Few controls use more than a page or two, so a linear search beats a map here.
+		int32 index = INDEX_NONE;
+		for (int32 i = 0; i < numUsed_; i++) {
+			if (textures_[i] == runBatch.Texture) {
+				index = i;
+				break;
+			}
+		}
+		if (index == INDEX_NONE) {
+			index = numUsed_++;
+			if (index == textures_.Num()) {
+				textures_.Add(runBatch.Texture);
+				triangles_.AddDefaulted();
+			}
+			textures_[index] = runBatch.Texture;
+			triangles_[index].Reset();
+		}
+
+		TArray<FCanvasUVTri>& triangles = triangles_[index];
+		int32 first = triangles.AddUninitialized(runBatch.Triangles.Num());
+		for (int32 i = 0; i < runBatch.Triangles.Num(); i++) {
+			FCanvasUVTri& triangle = triangles[first + i];
+			triangle = runBatch.Triangles[i];
+			triangle.V0_Pos += location;
+			triangle.V1_Pos += location;
+			triangle.V2_Pos += location;
+		}
+		if (opacity < 1.0f) {
+			for (int32 i = 0; i < runBatch.Triangles.Num(); i++) {
+				FCanvasUVTri& triangle = triangles[first + i];
+				triangle.V0_Color.A *= opacity;
+				triangle.V1_Color.A *= opacity;
+				triangle.V2_Color.A *= opacity;
+			}
+		}
+	}
+}
+
+void HotHudTextBatch::Submit(UCanvas* canvas) {
+	for (int32 i = 0; i < numUsed_; i++) {
+		if (triangles_[i].Num() > 0) {
+			FCanvasTriangleItem item(triangles_[i], textures_[i]->Resource);
+			item.BlendMode = SE_BLEND_Translucent;
+			canvas->DrawItem(item);
+		}
+		triangles_[i].Reset();
+	}
+	numUsed_ = 0;
+}
+
+int32 HotHudTextBatch::GetAllocatedSize() const {
+	int32 bytes = textures_.GetAllocatedSize() + triangles_.GetAllocatedSize();
+	for (const TArray<FCanvasUVTri>& triangles : triangles_) {
+		bytes += triangles.GetAllocatedSize();
+	}
+	return bytes;
+}
+
+/*****************************************************************************/
+
+HotHudGlyphRunCache::HotHudGlyphRunCache()
+	: hits_(0),
+	misses_(0) {
+}
+
+TSharedPtr<HotHudGlyphRun> HotHudGlyphRunCache::Acquire(const FString& text, UFont* font, float scale, const FLinearColor& color) {
+	if (font == nullptr) {
+		font = GEngine->GetMediumFont();
+	}
+
+	Key key;
+	key.TextHash = FCrc::StrCrc32(*text);
+	key.Font = font;
+	key.Scale = scale;
+	key.Color = color;
+
+	TSharedPtr<HotHudGlyphRun>* found = runs_.Find(key);
+	if (found != nullptr && (*found)->Text == text) {
+		hits_++;
+		return *found;
+	}
+
+	misses_++;
+	TSharedPtr<HotHudGlyphRun> run = MakeShareable(new HotHudGlyphRun());
+	run->Text = text;
+	run->Font = font;
+	run->Scale = scale;
+	run->Color = color;
+	run->LastUsedFrame = GFrameCounter;
+	if (!BuildRun(*run)) {
+		return TSharedPtr<HotHudGlyphRun>();
+	}
+	// On a (very unlikely) hash collision the newer string wins; holders of the old run keep it alive.
+	runs_.Add(key, run);
+	return run;
+}
+
+bool HotHudGlyphRunCache::BuildRun(HotHudGlyphRun& run) {
+	UFont* font = run.Font;
+	if (font == nullptr || font->Textures.Num() == 0 || font->ImportOptions.bUseDistanceFieldAlpha) {
+		return false;
+	}
+
+	// Mirrors the legacy font path of FCanvasTextItem so cached text lines up with DrawText.
+	const float scale = run.Scale;
+	const float charIncrement = font->Kerning * scale;
+	const float lineHeight = font->GetMaxCharHeight() * scale;
+	float x = 0;
+	float y = 0;
+	float maxX = 0;
+	const FString& text = run.Text;
+
+	for (int32 i = 0; i < text.Len(); i++) {
+		TCHAR c = text[i];
+		if (c == TEXT('\n')) {
+			x = 0;
+			y += lineHeight;
+			continue;
+		}
+		int32 charIndex = font->RemapChar(c);
+		if (!font->Characters.IsValidIndex(charIndex)) {
+			continue;
+		}
+		const FFontCharacter& fontChar = font->Characters[charIndex];
+		if (!font->Textures.IsValidIndex(fontChar.TextureIndex) || font->Textures[fontChar.TextureIndex] == nullptr) {
+			continue;
+		}
+		UTexture2D* texture = font->Textures[fontChar.TextureIndex];
+		const float sizeX = fontChar.USize * scale;
+		const float sizeY = fontChar.VSize * scale;
+
+		if (sizeX > 0 && sizeY > 0) {
+			HotHudGlyphRun::Batch* batch = nullptr;
+			for (HotHudGlyphRun::Batch& candidate : run.Batches) {
+				if (candidate.Texture == texture) {
+					batch = &candidate;
+					break;
+				}
+			}
+			if (batch == nullptr) {
+				batch = &run.Batches[run.Batches.AddDefaulted()];
+				batch->Texture = texture;
+			}
+
+			const float invWidth = 1.0f / texture->GetSurfaceWidth();
+			const float invHeight = 1.0f / texture->GetSurfaceHeight();
+			const float u0 = fontChar.StartU * invWidth;
+			const float v0 = fontChar.StartV * invHeight;
+			const float u1 = (fontChar.StartU + fontChar.USize) * invWidth;
+			const float v1 = (fontChar.StartV + fontChar.VSize) * invHeight;
+			const float top = y + fontChar.VerticalOffset * scale;
+
+			FCanvasUVTri& first = batch->Triangles[batch->Triangles.AddUninitialized()];
+			first.V0_Pos = FVector2D(x, top);
+			first.V0_UV = FVector2D(u0, v0);
+			first.V0_Color = run.Color;
+			first.V1_Pos = FVector2D(x + sizeX, top);
+			first.V1_UV = FVector2D(u1, v0);
+			first.V1_Color = run.Color;
+			first.V2_Pos = FVector2D(x + sizeX, top + sizeY);
+			first.V2_UV = FVector2D(u1, v1);
+			first.V2_Color = run.Color;
+
+			FCanvasUVTri& second = batch->Triangles[batch->Triangles.AddUninitialized()];
+			second.V0_Pos = FVector2D(x, top);
+			second.V0_UV = FVector2D(u0, v0);
+			second.V0_Color = run.Color;
+			second.V1_Pos = FVector2D(x + sizeX, top + sizeY);
+			second.V1_UV = FVector2D(u1, v1);
+			second.V1_Color = run.Color;
+			second.V2_Pos = FVector2D(x, top + sizeY);
+			second.V2_UV = FVector2D(u0, v1);
+			second.V2_Color = run.Color;
+		}
+
+		x += sizeX + charIncrement;
+		maxX = FMath::Max(maxX, x);
+	}
+
+	run.Size = FVector2D(maxX, y + lineHeight);
+	return true;
+}
+
+void HotHudGlyphRunCache::Trim(uint64 maxIdleFrames) {
+	for (auto it = runs_.CreateIterator(); it; ++it) {
+		const TSharedPtr<HotHudGlyphRun>& run = it.Value();
+		if (run.IsUnique() && GFrameCounter - run->LastUsedFrame > maxIdleFrames) {
+			it.RemoveCurrent();
+		}
+	}
+}
+
+void HotHudGlyphRunCache::Empty() {
+	for (auto it = runs_.CreateIterator(); it; ++it) {
+		if (it.Value().IsUnique()) {
+			it.RemoveCurrent();
+		}
+	}
+}
+
+int32 HotHudGlyphRunCache::GetAllocatedSize() const {
+	int32 bytes = runs_.GetAllocatedSize();
+	for (auto it = runs_.CreateConstIterator(); it; ++it) {
+		const HotHudGlyphRun& run = *it.Value();
+		bytes += sizeof(HotHudGlyphRun) + run.Text.GetCharArray().GetAllocatedSize() + run.Batches.GetAllocatedSize();
+		for (const HotHudGlyphRun::Batch& batch : run.Batches) {
+			bytes += batch.Triangles.GetAllocatedSize();
+		}
+	}
+	return bytes;
+}
+
+/*****************************************************************************/
+
+void HotHudGapBuffer::MoveGap(int32 position) {
+	int32 gapSize = gapEnd_ - gapStart_;
+	if (position < gapStart_) {
+		int32 count = gapStart_ - position;
+		FMemory::Memmove(&buffer_[gapEnd_ - count], &buffer_[position], count * sizeof(TCHAR));
+		gapStart_ = position;
+		gapEnd_ = position + gapSize;
+	}
+	else if (position > gapStart_) {
+		int32 count = position - gapStart_;
+		FMemory::Memmove(&buffer_[gapStart_], &buffer_[gapEnd_], count * sizeof(TCHAR));
+		gapStart_ = position;
+		gapEnd_ = position + gapSize;
+	}
+}
+
+void HotHudGapBuffer::GrowGap(int32 minimum) {
+	// Grow geometrically so a long run of inserts stays amortized O(1).
+	int32 growBy = FMath::Max(minimum, FMath::Max(64, buffer_.Num() / 2));
+	buffer_.InsertUninitialized(gapEnd_, growBy);
+	gapEnd_ += growBy;
+}
+
+void HotHudGapBuffer::Insert(int32 position, const TCHAR* text, int32 count) {
+	if (count <= 0) {
+		return;
+	}
+	MoveGap(position);
+	if (gapEnd_ - gapStart_ < count) {
+		GrowGap(count);
+	}
+	FMemory::Memcpy(&buffer_[gapStart_], text, count * sizeof(TCHAR));
+	gapStart_ += count;
+}
+
+void HotHudGapBuffer::Remove(int32 position, int32 count) {
+	if (count <= 0) {
+		return;
+	}
+	MoveGap(position);
+	gapEnd_ += count;
+}
+
+void HotHudGapBuffer::AppendRangeTo(int32 position, int32 count, FString& out) const {
+	int32 end = position + count;
+	if (position < gapStart_) {
+		int32 beforeGap = FMath::Min(end, gapStart_) - position;
+		out.AppendChars(&buffer_[position], beforeGap);
+		position += beforeGap;
+	}
+	if (position < end) {
+		out.AppendChars(&buffer_[position + (gapEnd_ - gapStart_)], end - position);
+	}
+}
+
+void HotHudGapBuffer::Empty() {
+	buffer_.Reset();
+	gapStart_ = 0;
+	gapEnd_ = 0;
+}
+
+/*****************************************************************************/
+
+HotHudTextDocument::HotHudTextDocument()
+	: cursorParagraph_(0),
+	cursorColumn_(0),
+	cursorParagraphStart_(0),
+	cursorAtRowEnd_(false),
+	preferredColumn_(INDEX_NONE),
+	wrapColumns_(0),
+	revision_(0),
+	memoParagraph_(INDEX_NONE),
+	memoParagraphStart_(0) {
+	paragraphLengths_.Add(0);
+	layouts_.AddDefaulted();
+}
+
+void HotHudTextDocument::SetText(const FString& text) {
+	chars_.Empty();
+	paragraphLengths_.Reset();
+	layouts_.Reset();
+	paragraphLengths_.Add(0);
+	layouts_.AddDefaulted();
+	cursorParagraph_ = 0;
+	cursorColumn_ = 0;
+	cursorParagraphStart_ = 0;
+	preferredColumn_ = INDEX_NONE;
+	AppendParagraph(text);
+	SetCursor(0, 0);
+}
+
+FString HotHudTextDocument::GetText() const {
+	FString text;
+	text.Empty(chars_.Len());
+	chars_.AppendRangeTo(0, chars_.Len(), text);
+	return text;
+}
+
+void HotHudTextDocument::AppendParagraph(const FString& text) {
+	TArray<int32> lineStarts;
+	HotHudFindLineStarts(*text, text.Len(), lineStarts);
+
+	// An empty document's only paragraph is replaced by the first line rather than followed by it.
+	bool isEmpty = (paragraphLengths_.Num() == 1 && paragraphLengths_[0] == 0);
+	int32 start = chars_.Len();
+	if (isEmpty) {
+		paragraphLengths_.Reset();
+		layouts_.Reset();
+	}
+	else {
+		TCHAR newline = TEXT('\n');
+		chars_.Insert(start++, &newline, 1);
+	}
+	chars_.Insert(start, *text, text.Len());
+
+	int32 firstParagraph = paragraphLengths_.Num();
+	int32 numLines = lineStarts.Num();
+	paragraphLengths_.Reserve(firstParagraph + numLines);
+	for (int32 i = 0; i < numLines; i++) {
+		int32 lineEnd = (i + 1 < numLines) ? lineStarts[i + 1] - 1 : text.Len();
+		paragraphLengths_.Add(lineEnd - lineStarts[i]);
+	}
+	layouts_.AddDefaulted(numLines);
+
+	// The cursor is before the new text, so it (and its paragraph start) are still valid.
+	OnEdited();
+
+	// Small appends are wrapped lazily as they scroll into view, like any edit.
+	if (wrapColumns_ <= 0 || text.Len() < kHotHudParallelTextMinChars) {
+		return;
+	}
+	ParallelFor(numLines, [this, start, firstParagraph, &lineStarts](int32 line) {
+		int32 paragraph = firstParagraph + line;
+		WrapParagraph(start + lineStarts[line], paragraphLengths_[paragraph], layouts_[paragraph]);
+	});
+}
+
+void HotHudTextDocument::Insert(const TCHAR* text, int32 count) {
+	int32 i = 0;
+	while (i < count) {
+		// Insert everything up to the next newline in one go.
+		int32 runEnd = i;
+		while (runEnd < count && text[runEnd] != TEXT('\n')) {
+			runEnd++;
+		}
+		int32 runLength = runEnd - i;
+		if (runLength > 0) {
+			chars_.Insert(cursorParagraphStart_ + cursorColumn_, text + i, runLength);
+			paragraphLengths_[cursorParagraph_] += runLength;
+			cursorColumn_ += runLength;
+			InvalidateParagraph(cursorParagraph_);
+		}
+		if (runEnd < count) {
+			// Split the paragraph at the cursor.
+			chars_.Insert(cursorParagraphStart_ + cursorColumn_, text + runEnd, 1);
+			int32 tailLength = paragraphLengths_[cursorParagraph_] - cursorColumn_;
+			paragraphLengths_[cursorParagraph_] = cursorColumn_;
+			InvalidateParagraph(cursorParagraph_);
+			paragraphLengths_.Insert(tailLength, cursorParagraph_ + 1);
+			layouts_.InsertDefaulted(cursorParagraph_ + 1);
+			cursorParagraphStart_ += cursorColumn_ + 1;
+			cursorParagraph_++;
+			cursorColumn_ = 0;
+		}
+		i = runEnd + 1;
+	}
+	cursorAtRowEnd_ = false;
+	preferredColumn_ = INDEX_NONE;
+	OnEdited();
+}
+
+void HotHudTextDocument::DeleteBackward() {
+	if (cursorColumn_ > 0) {
+		chars_.Remove(cursorParagraphStart_ + cursorColumn_ - 1, 1);
+		paragraphLengths_[cursorParagraph_]--;
+		cursorColumn_--;
+		InvalidateParagraph(cursorParagraph_);
+	}
+	else if (cursorParagraph_ > 0) {
+		// Join with the previous paragraph by removing its newline.
+		chars_.Remove(cursorParagraphStart_ - 1, 1);
+		int32 previousLength = paragraphLengths_[cursorParagraph_ - 1];
+		paragraphLengths_[cursorParagraph_ - 1] += paragraphLengths_[cursorParagraph_];
+		paragraphLengths_.RemoveAt(cursorParagraph_);
+		layouts_.RemoveAt(cursorParagraph_);
+		cursorParagraph_--;
+		cursorColumn_ = previousLength;
+		cursorParagraphStart_ -= previousLength + 1;
+		InvalidateParagraph(cursorParagraph_);
+	}
+	else {
+		return;
+	}
+	cursorAtRowEnd_ = false;
+	preferredColumn_ = INDEX_NONE;
+	OnEdited();
+}
+
+void HotHudTextDocument::DeleteForward() {
+	if (cursorColumn_ < paragraphLengths_[cursorParagraph_]) {
+		chars_.Remove(cursorParagraphStart_ + cursorColumn_, 1);
+		paragraphLengths_[cursorParagraph_]--;
+		InvalidateParagraph(cursorParagraph_);
+	}
+	else if (cursorParagraph_ < paragraphLengths_.Num() - 1) {
+		chars_.Remove(cursorParagraphStart_ + cursorColumn_, 1);
+		paragraphLengths_[cursorParagraph_] += paragraphLengths_[cursorParagraph_ + 1];
+		paragraphLengths_.RemoveAt(cursorParagraph_ + 1);
+		layouts_.RemoveAt(cursorParagraph_ + 1);
+		InvalidateParagraph(cursorParagraph_);
+	}
+	else {
+		return;
+	}
+	cursorAtRowEnd_ = false;
+	preferredColumn_ = INDEX_NONE;
+	OnEdited();
+}
+
+void HotHudTextDocument::MoveLeft() {
+	if (cursorColumn_ > 0) {
+		SetCursor(cursorParagraph_, cursorColumn_ - 1);
+	}
+	else if (cursorParagraph_ > 0) {
+		SetCursor(cursorParagraph_ - 1, paragraphLengths_[cursorParagraph_ - 1]);
+	}
+	preferredColumn_ = INDEX_NONE;
+}
+
+void HotHudTextDocument::MoveRight() {
+	if (cursorColumn_ < paragraphLengths_[cursorParagraph_]) {
+		SetCursor(cursorParagraph_, cursorColumn_ + 1);
+	}
+	else if (cursorParagraph_ < paragraphLengths_.Num() - 1) {
+		SetCursor(cursorParagraph_ + 1, 0);
+	}
+	preferredColumn_ = INDEX_NONE;
+}
+
+void HotHudTextDocument::MoveUp() {
+	int32 row, column;
+	GetCursorRow(row, column);
+	if (preferredColumn_ == INDEX_NONE) {
+		preferredColumn_ = column;
+	}
+	if (row > 0) {
+		SetCursorToRow(cursorParagraph_, row - 1);
+	}
+	else if (cursorParagraph_ > 0) {
+		SetCursorToRow(cursorParagraph_ - 1, NumRows(cursorParagraph_ - 1) - 1);
+	}
+}
+
+void HotHudTextDocument::MoveDown() {
+	int32 row, column;
+	GetCursorRow(row, column);
+	if (preferredColumn_ == INDEX_NONE) {
+		preferredColumn_ = column;
+	}
+	if (row < NumRows(cursorParagraph_) - 1) {
+		SetCursorToRow(cursorParagraph_, row + 1);
+	}
+	else if (cursorParagraph_ < paragraphLengths_.Num() - 1) {
+		SetCursorToRow(cursorParagraph_ + 1, 0);
+	}
+}
+
+void HotHudTextDocument::MoveHome() {
+	int32 row, column;
+	GetCursorRow(row, column);
+	SetCursor(cursorParagraph_, cursorColumn_ - column);
+	preferredColumn_ = INDEX_NONE;
+}
+
+void HotHudTextDocument::MoveEnd() {
+	int32 row, column;
+	GetCursorRow(row, column);
+	int32 end = RowEndColumn(cursorParagraph_, row);
+	SetCursor(cursorParagraph_, end, IsRowStart(cursorParagraph_, row + 1, end));
+	preferredColumn_ = INDEX_NONE;
+}
+
+void HotHudTextDocument::SetCursorToRow(int32 paragraph, int32 row) {
+	EnsureWrapped(paragraph);
+	int32 column = FMath::Min(layouts_[paragraph].RowStarts[row] + preferredColumn_, RowEndColumn(paragraph, row));
+	SetCursor(paragraph, column, IsRowStart(paragraph, row + 1, column));
+}
+
+int32 HotHudTextDocument::RowEndColumn(int32 paragraph, int32 row) const {
+	const TArray<int32>& rowStarts = layouts_[paragraph].RowStarts;
+	if (row + 1 >= rowStarts.Num()) {
+		return paragraphLengths_[paragraph];
+	}
+	// Stop before the space a row was broken at rather than jumping onto the next row. A row broken
+	// inside a word has no such space, so its end is past its last character.
+	int32 nextRowStart = rowStarts[row + 1];
+	return chars_.CharAt(ParagraphStart(paragraph) + nextRowStart - 1) == TEXT(' ') ? nextRowStart - 1 : nextRowStart;
+}
+
+bool HotHudTextDocument::IsRowStart(int32 paragraph, int32 row, int32 column) const {
+	const TArray<int32>& rowStarts = layouts_[paragraph].RowStarts;
+	return row > 0 && row < rowStarts.Num() && rowStarts[row] == column;
+}
+
+void HotHudTextDocument::SetCursor(int32 paragraph, int32 column, bool atRowEnd) {
+	if (paragraph != cursorParagraph_) {
+		cursorParagraphStart_ = ParagraphStart(paragraph);
+		cursorParagraph_ = paragraph;
+	}
+	cursorColumn_ = column;
+	cursorAtRowEnd_ = atRowEnd;
+	revision_++;
+}
+
+void HotHudTextDocument::GetCursorRow(int32& row, int32& column) {
+	EnsureWrapped(cursorParagraph_);
+	const TArray<int32>& rowStarts = layouts_[cursorParagraph_].RowStarts;
+	row = rowStarts.Num() - 1;
+	while (row > 0 && rowStarts[row] > cursorColumn_) {
+		row--;
+	}
+	// The end of a row broken inside a word is also the start of the next one.
+	if (cursorAtRowEnd_ && row > 0 && rowStarts[row] == cursorColumn_) {
+		row--;
+	}
+	column = cursorColumn_ - rowStarts[row];
+}
+
+int32 HotHudTextDocument::ParagraphStart(int32 paragraph) const {
+	// Walk from whichever known paragraph start is closest.
+	int32 from = cursorParagraph_;
+	int32 start = cursorParagraphStart_;
+	if (memoParagraph_ != INDEX_NONE && FMath::Abs(memoParagraph_ - paragraph) < FMath::Abs(cursorParagraph_ - paragraph)) {
+		from = memoParagraph_;
+		start = memoParagraphStart_;
+	}
+	while (from < paragraph) {
+		start += paragraphLengths_[from] + 1;
+		from++;
+	}
+	while (from > paragraph) {
+		from--;
+		start -= paragraphLengths_[from] + 1;
+	}
+	memoParagraph_ = paragraph;
+	memoParagraphStart_ = start;
+	return start;
+}
+
+void HotHudTextDocument::SetWrapColumns(int32 columns) {
+	if (columns == wrapColumns_) {
+		return;
+	}
+	wrapColumns_ = columns;
+	// The cursor's row end may not be one any more.
+	cursorAtRowEnd_ = false;
+	InvalidateLayout();
+}
+
+void HotHudTextDocument::InvalidateLayout() {
+	for (ParagraphLayout& layout : layouts_) {
+		layout.IsValid = false;
+	}
+	revision_++;
+}
+
+int32 HotHudTextDocument::GetAllocatedSize() const {
+	int32 bytes = chars_.GetAllocatedSize() + paragraphLengths_.GetAllocatedSize() + layouts_.GetAllocatedSize();
+	for (const ParagraphLayout& layout : layouts_) {
+		bytes += layout.RowStarts.GetAllocatedSize() + layout.RowRuns.GetAllocatedSize();
+	}
+	return bytes;
+}
+
+void HotHudTextDocument::InvalidateParagraph(int32 paragraph) {
+	layouts_[paragraph].IsValid = false;
+}
+
+void HotHudTextDocument::OnEdited() {
+	memoParagraph_ = INDEX_NONE;
+	revision_++;
+}
+
+void HotHudTextDocument::EnsureWrapped(int32 paragraph) {
+	ParagraphLayout& layout = layouts_[paragraph];
+	if (layout.IsValid) {
+		return;
+	}
+	WrapParagraph(ParagraphStart(paragraph), paragraphLengths_[paragraph], layout);
+}
+
+void HotHudTextDocument::WrapParagraph(int32 start, int32 length, ParagraphLayout& layout) const {
+	layout.RowStarts.Reset();
+	layout.RowStarts.Add(0);
+
+	if (wrapColumns_ > 0) {
+		int32 rowStart = 0;
+		while (length - rowStart > wrapColumns_) {
+			// Break after the last space that fits, or hard-break a word longer than the row.
+			int32 rowEnd = rowStart + wrapColumns_;
+			int32 breakAt = rowEnd;
+			for (int32 i = rowEnd; i > rowStart; i--) {
+				if (chars_.CharAt(start + i - 1) == TEXT(' ')) {
+					breakAt = i;
+					break;
+				}
+			}
+			rowStart = breakAt;
+			layout.RowStarts.Add(rowStart);
+		}
+	}
+	layout.RowRuns.Reset();
+	layout.RowRuns.AddDefaulted(layout.RowStarts.Num());
+	layout.IsValid = true;
+}
+
+int32 HotHudTextDocument::NumRows(int32 paragraph) {
+	EnsureWrapped(paragraph);
+	return layouts_[paragraph].RowStarts.Num();
+}
+
+void HotHudTextDocument::GetRowText(int32 paragraph, int32 row, FString& out) {
+	EnsureWrapped(paragraph);
+	const TArray<int32>& rowStarts = layouts_[paragraph].RowStarts;
+	int32 rowStart = rowStarts[row];
+	int32 rowEnd = (row + 1 < rowStarts.Num()) ? rowStarts[row + 1] : paragraphLengths_[paragraph];
+	chars_.AppendRangeTo(ParagraphStart(paragraph) + rowStart, rowEnd - rowStart, out);
+}
+
+TSharedPtr<HotHudGlyphRun>& HotHudTextDocument::RowRun(int32 paragraph, int32 row) {
+	EnsureWrapped(paragraph);
+	return layouts_[paragraph].RowRuns[row];
+}
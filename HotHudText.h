@@ -0,0 +1,254 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Text helpers used by HotHud controls.
+ */
+#pragma once
+
+// Texts of at least this many characters are split into lines (and wrapped) on the worker threads.
+static const int32 kHotHudParallelTextMinChars = 64 * 1024;
+
+// Appends the offset of the first character of every line of Text (Length characters, lines separated
+// by '\n') to LineStarts. There is always at least one line. Long texts are scanned in chunks on the
+// worker threads.
+void HotHudFindLineStarts(const TCHAR* text, int32 length, TArray<int32>& lineStarts);
+
+// A string laid out into positioned glyph quads, relative to its top-left corner.
+// Built once by HotHudGlyphRunCache and replayed as plain triangles from then on.
+struct HotHudGlyphRun {
+	// Glyph quads for one font texture page.
+	struct Batch {
+		UTexture2D* Texture;
+		TArray<FCanvasUVTri> Triangles;
+	};
+
+	// The string the run was built for (used to rule out hash collisions).
+	FString Text;
+	UFont* Font;
+	float Scale;
+	FLinearColor Color;
+	// One batch per font page used by the string.
+	TArray<Batch> Batches;
+	// Extent of the laid out text in pixels.
+	FVector2D Size;
+	// GFrameCounter when the run was last drawn.
+	uint64 LastUsedFrame;
+};
+
+// Accumulates glyph runs (and their font pages) so that a control's text can be submitted as one
+// FCanvasTriangleItem per font page. Allocations are kept between uses.
+class HotHudTextBatch {
+public:
+	HotHudTextBatch() : numUsed_(0) {}
+
+	// Appends Run positioned at Location, with its alpha scaled by Opacity.
+	void Add(const HotHudGlyphRun& run, const FVector2D& location, float opacity = 1.0f);
+	// Draws everything added since the last Submit and empties the batch.
+	void Submit(UCanvas* canvas);
+	bool IsEmpty() const { return numUsed_ == 0; }
+	int32 GetAllocatedSize() const;
+
+private:
+	TArray<UTexture2D*> textures_;
+	TArray<TArray<FCanvasUVTri>> triangles_;
+	// Number of entries of textures_ / triangles_ in use.
+	int32 numUsed_;
+};
+
+// Cache of laid out strings keyed by (string hash, font, scale, color).
+//
+// Controls hold a shared reference to each run they draw and drop it when their text changes; the
+// cache itself only keeps a run alive while it is referenced or has been drawn recently, so strings
+// which haven't changed in minutes are never re-laid out.
+class HotHudGlyphRunCache {
+public:
+	HotHudGlyphRunCache();
+
+	// Returns a run for Text, building it on a miss. Returns an invalid pointer if Font can't be laid
+	// out natively (e.g. distance field fonts), in which case the caller should fall back to DrawText.
+	// A nullptr Font means the engine's medium font, like AHUD::DrawText.
+	TSharedPtr<HotHudGlyphRun> Acquire(const FString& text, UFont* font, float scale, const FLinearColor& color);
+
+	// Drops unreferenced runs which haven't been drawn for MaxIdleFrames.
+	void Trim(uint64 maxIdleFrames);
+	// Drops every unreferenced run.
+	void Empty();
+
+	// Counters.
+	int32 Hits() const { return hits_; }
+	int32 Misses() const { return misses_; }
+	int32 NumEntries() const { return runs_.Num(); }
+	// Bytes held by the cache and every run in it.
+	int32 GetAllocatedSize() const;
+
+private:
+	struct Key {
+		uint32 TextHash;
+		UFont* Font;
+		float Scale;
+		FLinearColor Color;
+
+		bool operator==(const Key& other) const {
+			return TextHash == other.TextHash && Font == other.Font && Scale == other.Scale && Color == other.Color;
+		}
+		friend uint32 GetTypeHash(const Key& key) {
+			return HashCombine(HashCombine(key.TextHash, PointerHash(key.Font)), HashCombine(GetTypeHash(key.Scale), GetTypeHash(key.Color)));
+		}
+	};
+
+	// Lays Text out with Font. Returns false if the font can't be handled natively.
+	static bool BuildRun(HotHudGlyphRun& run);
+
+	TMap<Key, TSharedPtr<HotHudGlyphRun>> runs_;
+	int32 hits_;
+	int32 misses_;
+};
+
+// A gap buffer of characters. Edits at (or near) the previous edit point are O(1) amortized since
+// only the characters between the old and new edit point move.
+class HotHudGapBuffer {
+public:
+	HotHudGapBuffer() : gapStart_(0), gapEnd_(0) {}
+
+	// Number of characters in the buffer.
+	int32 Len() const { return buffer_.Num() - (gapEnd_ - gapStart_); }
+	TCHAR CharAt(int32 index) const {
+		return index < gapStart_ ? buffer_[index] : buffer_[index + (gapEnd_ - gapStart_)];
+	}
+
+	// Inserts Count characters of Text before Position.
+	void Insert(int32 position, const TCHAR* text, int32 count);
+	// Removes Count characters starting at Position.
+	void Remove(int32 position, int32 count);
+	// Appends the Count characters starting at Position to Out.
+	void AppendRangeTo(int32 position, int32 count, FString& out) const;
+	void Empty();
+	int32 GetAllocatedSize() const { return buffer_.GetAllocatedSize(); }
+
+private:
+	void MoveGap(int32 position);
+	void GrowGap(int32 minimum);
+
+	TArray<TCHAR> buffer_;
+	int32 gapStart_;
+	int32 gapEnd_;
+};
+
+// An editable, word-wrapped multi-line document.
+//
+// Characters live in a gap buffer. Paragraph (hard line) lengths are kept alongside so that typing
+// only touches the cursor's paragraph; the absolute offset of a paragraph is derived by walking
+// from the cursor (or the last looked-up paragraph), which is cheap for the paragraphs on screen.
+// Each paragraph's wrapped rows (and their cached glyph runs) are only rebuilt when that paragraph
+// is edited or the wrap width changes.
+class HotHudTextDocument {
+public:
+	HotHudTextDocument();
+
+	// Replaces the whole document and puts the cursor at the start.
+	void SetText(const FString& text);
+	FString GetText() const;
+	// Appends Text as new paragraph(s) after the last one. The cursor doesn't move. The text is spliced
+	// in with a single gap move, and if the wrap width is known the paragraphs of long texts are wrapped
+	// on the worker threads.
+	void AppendParagraph(const FString& text);
+
+	// Inserts Count characters at the cursor and moves the cursor past them. '\n' splits paragraphs.
+	void Insert(const TCHAR* text, int32 count);
+	// Deletes the character before / after the cursor, joining paragraphs when at an edge.
+	void DeleteBackward();
+	void DeleteForward();
+
+	// Cursor movement. Up & down move by wrapped row and try to keep the column.
+	void MoveLeft();
+	void MoveRight();
+	void MoveUp();
+	void MoveDown();
+	void MoveHome();
+	void MoveEnd();
+
+	int32 Len() const { return chars_.Len(); }
+	int32 NumParagraphs() const { return paragraphLengths_.Num(); }
+	int32 CursorParagraph() const { return cursorParagraph_; }
+	int32 CursorColumn() const { return cursorColumn_; }
+	// Wrapped row of the cursor within its paragraph, and the column within that row.
+	void GetCursorRow(int32& row, int32& column);
+
+	// Sets the number of columns rows are wrapped at. 0 disables wrapping.
+	void SetWrapColumns(int32 columns);
+	// Forces every paragraph to be re-wrapped and re-laid out (e.g. after a font change).
+	void InvalidateLayout();
+	// Number of wrapped rows in Paragraph. Always at least one.
+	int32 NumRows(int32 paragraph);
+	// Appends the text of a wrapped row to Out.
+	void GetRowText(int32 paragraph, int32 row, FString& out);
+	// Cached glyph run handle for a wrapped row. Reset whenever the paragraph changes.
+	TSharedPtr<HotHudGlyphRun>& RowRun(int32 paragraph, int32 row);
+
+	// Incremented on every edit or cursor movement.
+	int32 Revision() const { return revision_; }
+
+	// Bytes held by the document's characters and wrap tables (glyph runs are owned by the cache).
+	int32 GetAllocatedSize() const;
+
+private:
+	struct ParagraphLayout {
+		// Offset (from the paragraph start) of each wrapped row.
+		TArray<int32> RowStarts;
+		TArray<TSharedPtr<HotHudGlyphRun>> RowRuns;
+		bool IsValid;
+
+		ParagraphLayout() : IsValid(false) {}
+	};
+
+	// Absolute offset of the first character of Paragraph.
+	int32 ParagraphStart(int32 paragraph) const;
+	void EnsureWrapped(int32 paragraph);
+	// Wraps the paragraph of Length characters at offset Start into Layout. Only reads chars_, so
+	// distinct paragraphs can be wrapped concurrently.
+	void WrapParagraph(int32 start, int32 length, ParagraphLayout& layout) const;
+	void InvalidateParagraph(int32 paragraph);
+	// Moves the cursor, keeping cursorParagraphStart_ up to date. AtRowEnd is set if Column is the end
+	// of a row broken inside a word, which is also the start of the next row.
+	void SetCursor(int32 paragraph, int32 column, bool atRowEnd = false);
+	// Moves the cursor to Row of Paragraph, as close to preferredColumn_ as possible.
+	void SetCursorToRow(int32 paragraph, int32 row);
+	// Last column the cursor can be on in (wrapped) Row of Paragraph. Paragraph must be wrapped.
+	int32 RowEndColumn(int32 paragraph, int32 row) const;
+	// Whether Column is where (wrapped) Row of Paragraph starts. False for the first row and past the last.
+	bool IsRowStart(int32 paragraph, int32 row, int32 column) const;
+	void OnEdited();
+
+	HotHudGapBuffer chars_;
+	// Length of every paragraph, not counting its '\n'.
+	TArray<int32> paragraphLengths_;
+	TArray<ParagraphLayout> layouts_;
+	int32 cursorParagraph_;
+	int32 cursorColumn_;
+	// Absolute offset of the start of cursorParagraph_.
+	int32 cursorParagraphStart_;
+	// Set while the cursor is at the end of a row broken inside a word rather than at the start of the
+	// next row; both are the same column.
+	bool cursorAtRowEnd_;
+	// Column within the row which up / down movement tries to return to. INDEX_NONE if unset.
+	int32 preferredColumn_;
+	int32 wrapColumns_;
+	int32 revision_;
+	// Last paragraph looked up by ParagraphStart() and its start, to make sequential lookups O(1).
+	mutable int32 memoParagraph_;
+	mutable int32 memoParagraphStart_;
+};
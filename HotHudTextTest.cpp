@@ -0,0 +1,83 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudText.h"
+
+// Headless checks of text document cursor movement over wrapped rows. Run with e.g.
+//   UE4Editor-Cmd <project> -nullrhi -ExecCmds="Automation RunTests HotHud.TextDocument; Quit"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHotHudTextDocumentTest, "HotHud.TextDocument", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+// Checks the cursor's column in its paragraph and its wrapped row & column.
+static void TestCursor(FAutomationTestBase& test, HotHudTextDocument& document, const TCHAR* what, int32 column, int32 row, int32 rowColumn) {
+	int32 cursorRow, cursorRowColumn;
+	document.GetCursorRow(cursorRow, cursorRowColumn);
+	test.TestEqual(FString::Printf(TEXT("%s: column"), what), document.CursorColumn(), column);
+	test.TestEqual(FString::Printf(TEXT("%s: row"), what), cursorRow, row);
+	test.TestEqual(FString::Printf(TEXT("%s: row column"), what), cursorRowColumn, rowColumn);
+}
+
+bool FHotHudTextDocumentTest::RunTest(const FString& Parameters) {
+	HotHudTextDocument document;
+	document.SetWrapColumns(5);
+
+	// A word longer than a row is hard-broken: 'abcde' / 'fghij'. Its rows end past their last character.
+	document.SetText(TEXT("abcdefghij"));
+	TestEqual(TEXT("Hard-wrapped rows"), document.NumRows(0), 2);
+	document.MoveEnd();
+	TestCursor(*this, document, TEXT("End of a hard-wrapped row"), 5, 0, 5);
+	document.MoveEnd();
+	TestCursor(*this, document, TEXT("End again stays put"), 5, 0, 5);
+	document.MoveHome();
+	TestCursor(*this, document, TEXT("Home from a hard-wrapped row's end"), 0, 0, 0);
+	document.MoveEnd();
+	document.MoveRight();
+	TestCursor(*this, document, TEXT("Right from a hard-wrapped row's end"), 6, 1, 1);
+	document.MoveLeft();
+	TestCursor(*this, document, TEXT("Left onto the next row's start"), 5, 1, 0);
+	document.MoveUp();
+	document.MoveDown();
+	document.MoveEnd();
+	TestCursor(*this, document, TEXT("End of the last row"), 10, 1, 5);
+	document.MoveUp();
+	TestCursor(*this, document, TEXT("Up onto a hard-wrapped row's end"), 5, 0, 5);
+
+	// Typing at a row's end carries on from the character before it.
+	document.Insert(TEXT("X"), 1);
+	TestTrue(TEXT("Typed at a row's end"), document.GetText() == TEXT("abcdeXfghij"));
+	TestEqual(TEXT("Column after typing"), document.CursorColumn(), 6);
+
+	// A row broken at a space ends before the space: 'abc ' / 'defgh'.
+	document.SetText(TEXT("abc defgh"));
+	TestEqual(TEXT("Soft-wrapped rows"), document.NumRows(0), 2);
+	document.MoveEnd();
+	TestCursor(*this, document, TEXT("End of a soft-wrapped row"), 3, 0, 3);
+	document.MoveDown();
+	TestCursor(*this, document, TEXT("Down from a soft-wrapped row's end"), 7, 1, 3);
+
+	// Without wrapping, End goes to the end of the paragraph.
+	document.SetWrapColumns(0);
+	document.SetText(TEXT("abcdefghij"));
+	document.MoveEnd();
+	TestCursor(*this, document, TEXT("End of an unwrapped paragraph"), 10, 0, 10);
+	return true;
+}
@@ -0,0 +1,130 @@
+/*
+* This file is part of HotHud. HotHud is free software : you can
+* redistribute it and / or modify it under the terms of the GNU General Public
+* License as published by the Free Software Foundation, version 2.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program; if not, write to the Free Software Foundation, Inc., 51
+* Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+*
+* Copyright 2014, San Mehat <san.mehat@gmail.com>
+* =================================================================================
+*
+* SEE HOTHUD.H FOR DOCUMENTATION & RELEASE NOTES.
+*
+*/
+
+#include "Shiver.h"
+#include "HotHudTrace.h"
+
+static_assert((kHotHudTraceCapacity & (kHotHudTraceCapacity - 1)) == 0, "kHotHudTraceCapacity must be a power of two");
+
+static const TCHAR* kCategoryNames[HotHudTrace_NumCategories] = {
+	TEXT("Hover"), TEXT("Interaction"), TEXT("Layout"), TEXT("Lifecycle"),
+};
+
+static const TCHAR* kEventNames[HotHudTraceEvent_NumTypes] = {
+	TEXT("HoverBegin"), TEXT("HoverEnd"), TEXT("MoveBegin"), TEXT("MoveEnd"), TEXT("DragBegin"), TEXT("DragEnd"),
+	TEXT("Drop"), TEXT("DropTargetValidated"), TEXT("TextBoxMeasured"), TEXT("TileGridMeasured"), TEXT("ControlCreated"), TEXT("ControlDeleted"),
+};
+
+volatile int32 HotHudTrace::categories_ = 0;
+bool HotHudTrace::crashHookAdded_ = false;
+
+/*****************************************************************************/
+
+#if HOTHUD_TRACE
+
+volatile int32 HotHudTrace::next_ = 0;
+HotHudTraceRecord HotHudTrace::ring_[kHotHudTraceCapacity];
+
+void HotHudTrace::SetEnabled(HotHudTraceCategory category, bool enabled) {
+	// Categories are only changed from the game thread; recorders just read the mask.
+	if (enabled) {
+		categories_ |= (1 << category);
+		if (!crashHookAdded_) {
+			// The ring is most useful for working out what led up to a crash.
+			crashHookAdded_ = true;
+			FCoreDelegates::OnHandleSystemError.AddStatic(&HotHudTrace::OnSystemError);
+		}
+	}
+	else {
+		categories_ &= ~(1 << category);
+	}
+}
+
+void HotHudTrace::Record(HotHudTraceCategory category, HotHudTraceEventType type, const FName& control, int32 payload0, int32 payload1) {
+	// Claiming a slot is the only synchronization; the sequence number tells readers when it's complete.
+	uint32 index = (uint32)FPlatformAtomics::InterlockedIncrement(&next_) - 1;
+	HotHudTraceRecord& record = ring_[index & (kHotHudTraceCapacity - 1)];
+	record.Sequence = 0;
+	FPlatformMisc::MemoryBarrier();
+	record.Cycles = FPlatformTime::Cycles();
+	record.Type = (uint16)type;
+	record.Category = (uint16)category;
+	record.Control = control;
+	record.Payload[0] = payload0;
+	record.Payload[1] = payload1;
+	FPlatformMisc::MemoryBarrier();
+	record.Sequence = index + 1;
+}
+
+void HotHudTrace::Dump(FOutputDevice& out) {
+	uint32 end = (uint32)next_;
+	uint32 begin = (end > kHotHudTraceCapacity) ? end - kHotHudTraceCapacity : 0;
+	out.Logf(TEXT("HotHud trace: %u events recorded, showing the last %u."), end, end - begin);
+
+	bool haveFirst = false;
+	uint32 firstCycles = 0;
+	for (uint32 index = begin; index != end; index++) {
+		const HotHudTraceRecord& slot = ring_[index & (kHotHudTraceCapacity - 1)];
+		if (slot.Sequence != index + 1) {
+			continue;
+		}
+		HotHudTraceRecord record;
+		FMemory::Memcpy(&record, &slot, sizeof(record));
+		FPlatformMisc::MemoryBarrier();
+		// Overwritten (or still being written) while it was copied.
+		if (slot.Sequence != index + 1 || record.Sequence != index + 1) {
+			continue;
+		}
+		if (!haveFirst) {
+			haveFirst = true;
+			firstCycles = record.Cycles;
+		}
+		double ms = (record.Cycles - firstCycles) * FPlatformTime::GetSecondsPerCycle() * 1000.0;
+		out.Logf(TEXT("  %10.3f ms  %-12s %-17s %-24s %d %d"), ms,
+			record.Category < HotHudTrace_NumCategories ? kCategoryNames[record.Category] : TEXT("?"),
+			record.Type < HotHudTraceEvent_NumTypes ? kEventNames[record.Type] : TEXT("?"),
+			*record.Control.ToString(), record.Payload[0], record.Payload[1]);
+	}
+}
+
+void HotHudTrace::OnSystemError() {
+	if (GLog != nullptr) {
+		Dump(*GLog);
+		GLog->Flush();
+	}
+}
+
+#else
+
+void HotHudTrace::SetEnabled(HotHudTraceCategory category, bool enabled) {
+}
+
+void HotHudTrace::Record(HotHudTraceCategory category, HotHudTraceEventType type, const FName& control, int32 payload0, int32 payload1) {
+}
+
+void HotHudTrace::Dump(FOutputDevice& out) {
+	out.Logf(TEXT("HotHud trace is compiled out (HOTHUD_TRACE is 0)."));
+}
+
+void HotHudTrace::OnSystemError() {
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Event trace for the hot paths (hover, move & drag, layout) which are too frequent to log.
+ *
+ * Events are small fixed-size records written into a global lock-free ring, so the most recent
+ * kHotHudTraceCapacity events are always at hand. Recording is off until a category is enabled at
+ * runtime, and the ring is written out on demand (AHotHud::DumpTrace) and on a crash. Define
+ * HOTHUD_TRACE to 0 to compile every HOTHUD_TRACE_EVENT out.
+ */
+#pragma once
+
+#ifndef HOTHUD_TRACE
+#define HOTHUD_TRACE !UE_BUILD_SHIPPING
+#endif
+
+// Number of events kept. Must be a power of two.
+static const uint32 kHotHudTraceCapacity = 8192;
+
+// Categories are enabled independently (see AHotHud::SetTraceCategoryEnabled).
+enum HotHudTraceCategory {
+	// The control under the mouse changing.
+	HotHudTrace_Hover = 0,
+	// Window moves, tile drags & drops.
+	HotHudTrace_Interaction = 1,
+	// Controls measuring themselves.
+	HotHudTrace_Layout = 2,
+	// Controls being created & deleted.
+	HotHudTrace_Lifecycle = 3,
+	HotHudTrace_NumCategories = 4,
+};
+
+enum HotHudTraceEventType {
+	HotHudTraceEvent_HoverBegin,
+	HotHudTraceEvent_HoverEnd,
+	HotHudTraceEvent_MoveBegin,
+	HotHudTraceEvent_MoveEnd,
+	HotHudTraceEvent_DragBegin,
+	HotHudTraceEvent_DragEnd,
+	// Payload: target accepted the drop (0/1).
+	HotHudTraceEvent_Drop,
+	// A drop target was asked about the dragged control. Payload: target accepts it (0/1).
+	HotHudTraceEvent_DropTargetValidated,
+	// Payload: columns, rows.
+	HotHudTraceEvent_TextBoxMeasured,
+	HotHudTraceEvent_TileGridMeasured,
+	HotHudTraceEvent_ControlCreated,
+	HotHudTraceEvent_ControlDeleted,
+	HotHudTraceEvent_NumTypes,
+};
+
+// One traced event. Plain data so that it can be copied in and out of the ring without locking.
+struct HotHudTraceRecord {
+	// Index of the event + 1, written last. A slot whose sequence doesn't match is being written
+	// or has been overwritten.
+	volatile uint32 Sequence;
+	// FPlatformTime::Cycles() when recorded.
+	uint32 Cycles;
+	uint16 Type;
+	uint16 Category;
+	// Control the event is about (names are never freed, so this stays printable).
+	FName Control;
+	int32 Payload[2];
+};
+
+class HotHudTrace {
+public:
+	static bool IsEnabled(HotHudTraceCategory category) {
+		return (categories_ & (1 << category)) != 0;
+	}
+	static void SetEnabled(HotHudTraceCategory category, bool enabled);
+
+	// Appends an event to the ring, overwriting the oldest. Safe to call from any thread.
+	static void Record(HotHudTraceCategory category, HotHudTraceEventType type, const FName& control, int32 payload0 = 0, int32 payload1 = 0);
+
+	// Writes the events in the ring, oldest first, one per line.
+	static void Dump(FOutputDevice& out);
+
+private:
+	static void OnSystemError();
+
+	static volatile int32 categories_;
+	// Number of events ever recorded. The next event goes into slot next_ % kHotHudTraceCapacity.
+	static volatile int32 next_;
+	static HotHudTraceRecord ring_[kHotHudTraceCapacity];
+	static bool crashHookAdded_;
+};
+
+#if HOTHUD_TRACE
+#define HOTHUD_TRACE_EVENT(category, type, control, ...) \
+	do { \
+		if (HotHudTrace::IsEnabled(category)) { \
+			HotHudTrace::Record(category, type, control, ##__VA_ARGS__); \
+		} \
+	} while (0)
+#else
+#define HOTHUD_TRACE_EVENT(category, type, control, ...) do {} while (0)
+#endif
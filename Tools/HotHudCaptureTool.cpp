@@ -0,0 +1,288 @@
+/*
+ * This file is part of HotHud. HotHud is free software : you can
+ * redistribute it and / or modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation, version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA 02110 - 1301 USA.
+ *
+ * Copyright 2014, San Mehat <san.mehat@gmail.com>
+ * =================================================================================
+ *
+ * Standalone tool for draw captures made with AHotHud::StartDrawCapture. No engine dependencies:
+ *
+ *   c++ -std=c++11 -O2 -o HotHudCaptureTool Tools/HotHudCaptureTool.cpp
+ *
+ *   HotHudCaptureTool stat <capture>
+ *       Commands per frame, and rect / text / image counts per control.
+ *   HotHudCaptureTool diff [-t <pixels>] <golden> <capture>
+ *       Compares the captures frame by frame (by position, not frame number) and control by control.
+ *       Rects may differ by up to <pixels> (default 0). Exits with 1 if the captures differ.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../HotHudCaptureFormat.h"
+
+static const char* kTypeNames[HotHudCapture_NumTypes] = { "rect", "text", "image" };
+
+// Differences reported per control & frame before the rest are only counted.
+static const int kMaxReportedPerControl = 3;
+
+// A capture file read into memory. The sections are used in place, as they would be if mapped.
+class Capture {
+public:
+	bool Load(const char* path) {
+		FILE* file = fopen(path, "rb");
+		if (file == nullptr) {
+			fprintf(stderr, "%s: Can't open.\n", path);
+			return false;
+		}
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		data_.resize(size > 0 ? size : 0);
+		bool read = data_.empty() || fread(&data_[0], 1, data_.size(), file) == data_.size();
+		fclose(file);
+		if (!read || data_.size() < sizeof(HotHudCaptureHeader)) {
+			fprintf(stderr, "%s: Truncated.\n", path);
+			return false;
+		}
+
+		header_ = (const HotHudCaptureHeader*)&data_[0];
+		if (header_->Magic != kHotHudCaptureMagic || header_->Version != kHotHudCaptureVersion) {
+			fprintf(stderr, "%s: Not a capture, or from an incompatible version (%u).\n", path, header_->Version);
+			return false;
+		}
+		if (!InBounds(header_->FramesOffset, (uint64_t)header_->NumFrames * sizeof(HotHudCaptureFrame)) ||
+			!InBounds(header_->CommandsOffset, (uint64_t)header_->NumCommands * sizeof(HotHudCaptureCommand)) ||
+			!InBounds(header_->NamesOffset, header_->NamesSize) ||
+			(uint64_t)header_->NumControls * sizeof(uint32_t) > header_->NamesSize) {
+			fprintf(stderr, "%s: Corrupt section table.\n", path);
+			return false;
+		}
+		frames_ = (const HotHudCaptureFrame*)&data_[header_->FramesOffset];
+		commands_ = (const HotHudCaptureCommand*)&data_[header_->CommandsOffset];
+		names_ = (const char*)&data_[header_->NamesOffset];
+		for (uint32_t i = 0; i < header_->NumFrames; i++) {
+			if ((uint64_t)frames_[i].FirstCommand + frames_[i].NumCommands > header_->NumCommands) {
+				fprintf(stderr, "%s: Frame %u is out of range.\n", path, i);
+				return false;
+			}
+		}
+		for (uint32_t i = 0; i < header_->NumControls; i++) {
+			uint32_t offset = ((const uint32_t*)names_)[i];
+			if (offset >= header_->NamesSize || memchr(names_ + offset, 0, header_->NamesSize - offset) == nullptr) {
+				fprintf(stderr, "%s: Name %u is out of range.\n", path, i);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	uint32_t NumFrames() const { return header_->NumFrames; }
+	uint32_t NumCommands() const { return header_->NumCommands; }
+	const HotHudCaptureFrame& Frame(uint32_t index) const { return frames_[index]; }
+	const HotHudCaptureCommand& Command(uint32_t index) const { return commands_[index]; }
+
+	const char* ControlName(uint32_t id) const {
+		if (id == kHotHudCaptureNoControl || id >= header_->NumControls) {
+			return "<hud>";
+		}
+		return names_ + ((const uint32_t*)names_)[id];
+	}
+
+	// The commands of Frame grouped by control name, each in submission order.
+	void GroupFrame(uint32_t frame, std::map<std::string, std::vector<const HotHudCaptureCommand*>>& groups) const {
+		groups.clear();
+		const HotHudCaptureFrame& f = frames_[frame];
+		for (uint32_t i = f.FirstCommand; i < f.FirstCommand + f.NumCommands; i++) {
+			groups[ControlName(commands_[i].ControlId)].push_back(&commands_[i]);
+		}
+	}
+
+private:
+	bool InBounds(uint64_t offset, uint64_t size) const {
+		return offset + size <= data_.size();
+	}
+
+	std::vector<uint8_t> data_;
+	const HotHudCaptureHeader* header_;
+	const HotHudCaptureFrame* frames_;
+	const HotHudCaptureCommand* commands_;
+	const char* names_;
+};
+
+static const char* TypeName(uint8_t type) {
+	return type < HotHudCapture_NumTypes ? kTypeNames[type] : "?";
+}
+
+static void PrintCommand(const char* prefix, const HotHudCaptureCommand& command) {
+	printf("      %s %-5s (%.1f, %.1f %.1fx%.1f) color %08x texture %08x text %08x\n",
+		prefix, TypeName(command.Type), command.X, command.Y, command.Width, command.Height,
+		command.Color, command.TextureId, command.TextHash);
+}
+
+static bool SameCommand(const HotHudCaptureCommand& a, const HotHudCaptureCommand& b, float tolerance) {
+	return a.Type == b.Type && a.Color == b.Color && a.TextureId == b.TextureId && a.TextHash == b.TextHash &&
+		fabsf(a.X - b.X) <= tolerance && fabsf(a.Y - b.Y) <= tolerance &&
+		fabsf(a.Width - b.Width) <= tolerance && fabsf(a.Height - b.Height) <= tolerance;
+}
+
+/*****************************************************************************/
+
+static int Stat(const Capture& capture) {
+	struct Counts {
+		uint64_t ByType[HotHudCapture_NumTypes];
+		Counts() { memset(ByType, 0, sizeof(ByType)); }
+	};
+	std::map<std::string, Counts> perControl;
+	Counts total;
+
+	printf("%u frames, %u commands\n\n", capture.NumFrames(), capture.NumCommands());
+	for (uint32_t f = 0; f < capture.NumFrames(); f++) {
+		const HotHudCaptureFrame& frame = capture.Frame(f);
+		Counts frameCounts;
+		for (uint32_t i = frame.FirstCommand; i < frame.FirstCommand + frame.NumCommands; i++) {
+			const HotHudCaptureCommand& command = capture.Command(i);
+			if (command.Type < HotHudCapture_NumTypes) {
+				frameCounts.ByType[command.Type]++;
+				total.ByType[command.Type]++;
+				perControl[capture.ControlName(command.ControlId)].ByType[command.Type]++;
+			}
+		}
+		printf("frame %llu: %u commands (%llu rects, %llu texts, %llu images)\n",
+			(unsigned long long)frame.FrameNumber, frame.NumCommands,
+			(unsigned long long)frameCounts.ByType[HotHudCapture_Rect],
+			(unsigned long long)frameCounts.ByType[HotHudCapture_Text],
+			(unsigned long long)frameCounts.ByType[HotHudCapture_Image]);
+	}
+
+	printf("\n%-32s %10s %10s %10s\n", "control", "rects", "texts", "images");
+	for (const auto& entry : perControl) {
+		printf("%-32s %10llu %10llu %10llu\n", entry.first.c_str(),
+			(unsigned long long)entry.second.ByType[HotHudCapture_Rect],
+			(unsigned long long)entry.second.ByType[HotHudCapture_Text],
+			(unsigned long long)entry.second.ByType[HotHudCapture_Image]);
+	}
+	printf("%-32s %10llu %10llu %10llu\n", "TOTAL",
+		(unsigned long long)total.ByType[HotHudCapture_Rect],
+		(unsigned long long)total.ByType[HotHudCapture_Text],
+		(unsigned long long)total.ByType[HotHudCapture_Image]);
+	return 0;
+}
+
+static int Diff(const Capture& golden, const Capture& capture, float tolerance) {
+	uint64_t differences = 0;
+	if (golden.NumFrames() != capture.NumFrames()) {
+		printf("frame count differs: %u vs %u (comparing the first %u)\n",
+			golden.NumFrames(), capture.NumFrames(), golden.NumFrames() < capture.NumFrames() ? golden.NumFrames() : capture.NumFrames());
+		differences++;
+	}
+
+	std::map<std::string, std::vector<const HotHudCaptureCommand*>> goldenGroups;
+	std::map<std::string, std::vector<const HotHudCaptureCommand*>> captureGroups;
+	uint32_t numFrames = golden.NumFrames() < capture.NumFrames() ? golden.NumFrames() : capture.NumFrames();
+	for (uint32_t f = 0; f < numFrames; f++) {
+		golden.GroupFrame(f, goldenGroups);
+		capture.GroupFrame(f, captureGroups);
+		// Every control in either capture, in name order.
+		std::map<std::string, bool> controls;
+		for (const auto& entry : goldenGroups) {
+			controls[entry.first] = true;
+		}
+		for (const auto& entry : captureGroups) {
+			controls[entry.first] = true;
+		}
+
+		bool frameHeaderPrinted = false;
+		for (const auto& control : controls) {
+			const std::vector<const HotHudCaptureCommand*>& a = goldenGroups[control.first];
+			const std::vector<const HotHudCaptureCommand*>& b = captureGroups[control.first];
+			size_t common = a.size() < b.size() ? a.size() : b.size();
+			uint64_t controlDifferences = (a.size() > b.size()) ? a.size() - b.size() : b.size() - a.size();
+			int reported = 0;
+			for (size_t i = 0; i < common; i++) {
+				if (SameCommand(*a[i], *b[i], tolerance)) {
+					continue;
+				}
+				controlDifferences++;
+				if (reported++ < kMaxReportedPerControl) {
+					if (!frameHeaderPrinted) {
+						printf("frame #%u (%llu vs %llu):\n", f, (unsigned long long)golden.Frame(f).FrameNumber, (unsigned long long)capture.Frame(f).FrameNumber);
+						frameHeaderPrinted = true;
+					}
+					printf("  %s: command %zu\n", control.first.c_str(), i);
+					PrintCommand("-", *a[i]);
+					PrintCommand("+", *b[i]);
+				}
+			}
+			if (controlDifferences == 0) {
+				continue;
+			}
+			if (!frameHeaderPrinted) {
+				printf("frame #%u (%llu vs %llu):\n", f, (unsigned long long)golden.Frame(f).FrameNumber, (unsigned long long)capture.Frame(f).FrameNumber);
+				frameHeaderPrinted = true;
+			}
+			printf("  %s: %llu differences, %zu vs %zu commands\n", control.first.c_str(), (unsigned long long)controlDifferences, a.size(), b.size());
+			differences += controlDifferences;
+		}
+	}
+
+	if (differences == 0) {
+		printf("identical (%u frames, %u commands)\n", numFrames, capture.NumCommands());
+		return 0;
+	}
+	printf("%llu differences\n", (unsigned long long)differences);
+	return 1;
+}
+
+static int Usage() {
+	fprintf(stderr,
+		"usage: HotHudCaptureTool stat <capture>\n"
+		"       HotHudCaptureTool diff [-t <pixels>] <golden> <capture>\n");
+	return 2;
+}
+
+int main(int argc, char** argv) {
+	if (argc == 3 && strcmp(argv[1], "stat") == 0) {
+		Capture capture;
+		if (!capture.Load(argv[2])) {
+			return 2;
+		}
+		return Stat(capture);
+	}
+
+	if (argc >= 4 && strcmp(argv[1], "diff") == 0) {
+		float tolerance = 0.0f;
+		int arg = 2;
+		if (strcmp(argv[arg], "-t") == 0) {
+			if (argc != 6) {
+				return Usage();
+			}
+			tolerance = (float)atof(argv[arg + 1]);
+			arg += 2;
+		}
+		else if (argc != 4) {
+			return Usage();
+		}
+		Capture golden;
+		Capture capture;
+		if (!golden.Load(argv[arg]) || !capture.Load(argv[arg + 1])) {
+			return 2;
+		}
+		return Diff(golden, capture, tolerance);
+	}
+	return Usage();
+}